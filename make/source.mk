@@ -67,6 +67,7 @@ COMMON_SRC = \
             msp/msp.c \
             msp/msp_box.c \
             msp/msp_serial.c \
+            msp/msp_settings.c \
             scheduler/scheduler.c \
             sensors/adcinternal.c \
             sensors/battery.c \
@@ -84,7 +85,9 @@ COMMON_SRC = \
             drivers/rx/rx_pwm.c \
             drivers/serial_softserial.c \
             fc/core.c \
+            fc/latency_trace.c \
             fc/rc.c \
+            fc/rc_prediction.c \
             fc/rc_adjustments.c \
             fc/rc_controls.c \
             fc/rc_modes.c \
@@ -249,6 +252,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             fc/core.c \
             fc/tasks.c \
             fc/rc.c \
+            fc/rc_prediction.c \
             fc/rc_controls.c \
             fc/runtime_config.c \
             flight/gyroanalyse.c \
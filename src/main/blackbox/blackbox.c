@@ -55,6 +55,7 @@
 #include "config/config.h"
 #include "fc/board_info.h"
 #include "fc/controlrate_profile.h"
+#include "fc/latency_trace.h"
 #include "fc/rc.h"
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
@@ -87,13 +88,16 @@
 #define DEFAULT_BLACKBOX_DEVICE     BLACKBOX_DEVICE_SERIAL
 #endif
 
-PG_REGISTER_WITH_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 1);
+PG_REGISTER_WITH_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 4);
 
 PG_RESET_TEMPLATE(blackboxConfig_t, blackboxConfig,
     .p_ratio = 32,
     .device = DEFAULT_BLACKBOX_DEVICE,
     .record_acc = 1,
-    .mode = BLACKBOX_MODE_NORMAL
+    .mode = BLACKBOX_MODE_NORMAL,
+    .predictor = BLACKBOX_PREDICTOR_STANDARD,
+    .encoding = BLACKBOX_ENCODING_STANDARD,
+    .gyro_raw = 0
 );
 
 #define BLACKBOX_SHUTDOWN_TIMEOUT_MILLIS 200
@@ -162,84 +166,143 @@ typedef struct blackboxDeltaFieldDefinition_s {
     uint8_t Ppredict;
     uint8_t Pencode;
     uint8_t condition; // Decide whether this field should appear in the log
+
+    // Where the value is kept in blackboxMainState_t
+    uint8_t offset;
+    uint8_t size;
+
+    // Smooth at the loop rate, so blackbox_predictor may replace Ppredict
+    uint8_t smooth;
 } blackboxDeltaFieldDefinition_t;
 
+typedef struct blackboxMainState_s {
+    uint32_t loopIteration;
+    uint32_t time;
+
+    int32_t axisPID_P[XYZ_AXIS_COUNT];
+    int32_t axisPID_I[XYZ_AXIS_COUNT];
+    int32_t axisPID_D[XYZ_AXIS_COUNT];
+    int32_t axisPID_F[XYZ_AXIS_COUNT];
+
+    int16_t rcCommand[4];
+    int16_t setpoint[4];
+    int16_t gyroADC[XYZ_AXIS_COUNT];
+    int16_t accADC[XYZ_AXIS_COUNT];
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    int16_t motor[MAX_SUPPORTED_MOTORS];
+    int16_t servo[MAX_SUPPORTED_SERVOS];
+
+    uint16_t vbatLatest;
+    int32_t amperageLatest;
+
+#ifdef USE_BARO
+    int32_t BaroAlt;
+#endif
+#ifdef USE_MAG
+    int16_t magADC[XYZ_AXIS_COUNT];
+#endif
+#ifdef USE_RANGEFINDER
+    int32_t surfaceRaw;
+#endif
+    uint16_t rssi;
+#ifdef USE_LATENCY_TRACE
+    uint16_t rcLatency[2];
+#endif
+} blackboxMainState_t;
+
+STATIC_ASSERT(sizeof(blackboxMainState_t) <= UINT8_MAX, blackbox_main_state_too_large_for_field_offsets);
+
+#define MAIN_STATE(member) .offset = offsetof(blackboxMainState_t, member), .size = sizeof(((blackboxMainState_t *)0)->member)
+
 /**
  * Description of the blackbox fields we are writing in our main intra (I) and inter (P) frames. This description is
- * written into the flight log header so the log can be properly interpreted (but these definitions don't actually cause
- * the encoding to happen, we have to encode the flight log ourselves in write{Inter|Intra}frame() in a way that matches
- * the encoding we've promised here).
+ * written into the flight log header so the log can be properly interpreted, and the same description drives the
+ * encoding of the frames in write{Inter|Intra}frame(), so the log always matches the header.
+ *
+ * Adding a field takes a member in blackboxMainState_t, a line in loadMainState() and an entry here.
+ *
+ * Consecutive fields with the TAG8_8SVB P-frame encoding are written as a group of up to 8, the TAG2_3S32 and
+ * TAG8_4S16 encodings always group 3 and 4 fields, so those fields must be logged together.
+ *
+ * Fields marked smooth use the P-frame predictor selected by blackbox_predictor instead of Ppredict, unless it is
+ * BLACKBOX_PREDICTOR_STANDARD. With blackbox_encoding RICE every field written in P-frames uses the RICE encoding
+ * instead of Pencode.
  */
 static const blackboxDeltaFieldDefinition_t blackboxMainFields[] = {
     /* loopIteration doesn't appear in P frames since it always increments */
-    {"loopIteration",-1, UNSIGNED, .Ipredict = PREDICT(0),     .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(INC),           .Pencode = FLIGHT_LOG_FIELD_ENCODING_NULL, CONDITION(ALWAYS)},
+    {"loopIteration",-1, UNSIGNED, .Ipredict = PREDICT(0),     .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(INC),           .Pencode = FLIGHT_LOG_FIELD_ENCODING_NULL, CONDITION(ALWAYS), MAIN_STATE(loopIteration)},
     /* Time advances pretty steadily so the P-frame prediction is a straight line */
-    {"time",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisP",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisP",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisP",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
+    {"time",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(STRAIGHT_LINE), .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(time)},
+    {"axisP",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(axisPID_P[0])},
+    {"axisP",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(axisPID_P[1])},
+    {"axisP",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(axisPID_P[2])},
     /* I terms get special packed encoding in P frames: */
-    {"axisI",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS)},
-    {"axisI",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS)},
-    {"axisI",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS)},
-    {"axisD",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_0)},
-    {"axisD",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_1)},
-    {"axisD",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_2)},
-    {"axisF",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisF",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"axisF",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
+    {"axisI",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS), MAIN_STATE(axisPID_I[0])},
+    {"axisI",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS), MAIN_STATE(axisPID_I[1])},
+    {"axisI",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG2_3S32), CONDITION(ALWAYS), MAIN_STATE(axisPID_I[2])},
+    {"axisD",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_0), MAIN_STATE(axisPID_D[0])},
+    {"axisD",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_1), MAIN_STATE(axisPID_D[1])},
+    {"axisD",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(NONZERO_PID_D_2), MAIN_STATE(axisPID_D[2])},
+    {"axisF",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(axisPID_F[0])},
+    {"axisF",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(axisPID_F[1])},
+    {"axisF",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(axisPID_F[2])},
     /* rcCommands are encoded together as a group in P-frames: */
-    {"rcCommand",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"rcCommand",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"rcCommand",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"rcCommand",   3, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
+    {"rcCommand",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(rcCommand[0])},
+    {"rcCommand",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(rcCommand[1])},
+    {"rcCommand",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(rcCommand[2])},
+    {"rcCommand",   3, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(rcCommand[3])},
 
     // setpoint - define 4 fields like rcCommand to use the same encoding. setpoint[4] contains the mixer throttle
-    {"setpoint",    0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"setpoint",    1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"setpoint",    2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
-    {"setpoint",    3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS)},
+    {"setpoint",    0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(setpoint[0]), .smooth = true},
+    {"setpoint",    1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(setpoint[1]), .smooth = true},
+    {"setpoint",    2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(setpoint[2]), .smooth = true},
+    {"setpoint",    3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), CONDITION(ALWAYS), MAIN_STATE(setpoint[3]), .smooth = true},
 
-    {"vbatLatest",    -1, UNSIGNED, .Ipredict = PREDICT(VBATREF),  .Iencode = ENCODING(NEG_14BIT),   .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_VBAT},
-    {"amperageLatest",-1, SIGNED,   .Ipredict = PREDICT(0),        .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC},
+    {"vbatLatest",    -1, UNSIGNED, .Ipredict = PREDICT(VBATREF),  .Iencode = ENCODING(NEG_14BIT),   .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_VBAT, MAIN_STATE(vbatLatest)},
+    {"amperageLatest",-1, SIGNED,   .Ipredict = PREDICT(0),        .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC, MAIN_STATE(amperageLatest)},
 
 #ifdef USE_MAG
-    {"magADC",      0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG},
-    {"magADC",      1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG},
-    {"magADC",      2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG},
+    {"magADC",      0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG, MAIN_STATE(magADC[0])},
+    {"magADC",      1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG, MAIN_STATE(magADC[1])},
+    {"magADC",      2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_MAG, MAIN_STATE(magADC[2])},
 #endif
 #ifdef USE_BARO
-    {"BaroAlt",    -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_BARO},
+    {"BaroAlt",    -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_BARO, MAIN_STATE(BaroAlt)},
 #endif
 #ifdef USE_RANGEFINDER
-    {"surfaceRaw",   -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_RANGEFINDER},
+    {"surfaceRaw",   -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_RANGEFINDER, MAIN_STATE(surfaceRaw)},
+#endif
+    {"rssi",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_RSSI, MAIN_STATE(rssi)},
+#ifdef USE_LATENCY_TRACE
+    /* Latency of the last RX frame traced to the motors, from its arrival to rcCommand [0] and to the motor outputs [1] */
+    {"rcLatency",   0, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), CONDITION(ALWAYS), MAIN_STATE(rcLatency[0])},
+    {"rcLatency",   1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), CONDITION(ALWAYS), MAIN_STATE(rcLatency[1])},
 #endif
-    {"rssi",       -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_RSSI},
 
     /* Gyros and accelerometers base their P-predictions on the average of the previous 2 frames to reduce noise impact */
-    {"gyroADC",     0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"gyroADC",     1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"gyroADC",     2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS)},
-    {"accSmooth",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC},
-    {"accSmooth",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC},
-    {"accSmooth",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC},
-    {"debug",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
-    {"debug",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
-    {"debug",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
-    {"debug",       3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG},
+    {"gyroADC",     0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(gyroADC[0]), .smooth = true},
+    {"gyroADC",     1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(gyroADC[1]), .smooth = true},
+    {"gyroADC",     2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(ALWAYS), MAIN_STATE(gyroADC[2]), .smooth = true},
+    {"accSmooth",   0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC, MAIN_STATE(accADC[0])},
+    {"accSmooth",   1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC, MAIN_STATE(accADC[1])},
+    {"accSmooth",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_ACC, MAIN_STATE(accADC[2])},
+    {"debug",       0, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG, MAIN_STATE(debug[0])},
+    {"debug",       1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG, MAIN_STATE(debug[1])},
+    {"debug",       2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG, MAIN_STATE(debug[2])},
+    {"debug",       3, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_DEBUG, MAIN_STATE(debug[3])},
     /* Motors only rarely drops under minthrottle (when stick falls below mincommand), so predict minthrottle for it and use *unsigned* encoding (which is large for negative numbers but more compact for positive ones): */
-    {"motor",       0, UNSIGNED, .Ipredict = PREDICT(MINMOTOR), .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(AVERAGE_2), .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_1)},
+    {"motor",       0, UNSIGNED, .Ipredict = PREDICT(MINMOTOR), .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(AVERAGE_2), .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_1), MAIN_STATE(motor[0]), .smooth = true},
     /* Subsequent motors base their I-frame values on the first one, P-frame values on the average of last two frames: */
-    {"motor",       1, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_2)},
-    {"motor",       2, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_3)},
-    {"motor",       3, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_4)},
-    {"motor",       4, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_5)},
-    {"motor",       5, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_6)},
-    {"motor",       6, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_7)},
-    {"motor",       7, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_8)},
+    {"motor",       1, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_2), MAIN_STATE(motor[1]), .smooth = true},
+    {"motor",       2, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_3), MAIN_STATE(motor[2]), .smooth = true},
+    {"motor",       3, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_4), MAIN_STATE(motor[3]), .smooth = true},
+    {"motor",       4, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_5), MAIN_STATE(motor[4]), .smooth = true},
+    {"motor",       5, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_6), MAIN_STATE(motor[5]), .smooth = true},
+    {"motor",       6, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_7), MAIN_STATE(motor[6]), .smooth = true},
+    {"motor",       7, UNSIGNED, .Ipredict = PREDICT(MOTOR_0), .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(AVERAGE_2),     .Pencode = ENCODING(SIGNED_VB), CONDITION(AT_LEAST_MOTORS_8), MAIN_STATE(motor[7]), .smooth = true},
 
     /* Tricopter tail servo */
-    {"servo",       5, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(TRICOPTER)}
+    {"servo",       5, UNSIGNED, .Ipredict = PREDICT(1500),    .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), CONDITION(TRICOPTER), MAIN_STATE(servo[5])}
 };
 
 #ifdef USE_GPS
@@ -271,6 +334,14 @@ static const blackboxSimpleFieldDefinition_t blackboxSlowFields[] = {
     {"rxFlightChannelsValid", -1, UNSIGNED, PREDICT(0),      ENCODING(TAG2_3S32)}
 };
 
+// Raw gyro samples at the gyro rate, predicted from the previous R frame since the last I-frame
+static const blackboxSimpleFieldDefinition_t blackboxGyroRawFields[] = {
+    {"time",       -1, UNSIGNED, PREDICT(PREVIOUS), ENCODING(UNSIGNED_VB)},
+    {"gyroRaw",     0, SIGNED,   PREDICT(PREVIOUS), ENCODING(SIGNED_VB)},
+    {"gyroRaw",     1, SIGNED,   PREDICT(PREVIOUS), ENCODING(SIGNED_VB)},
+    {"gyroRaw",     2, SIGNED,   PREDICT(PREVIOUS), ENCODING(SIGNED_VB)}
+};
+
 typedef enum BlackboxState {
     BLACKBOX_STATE_DISABLED = 0,
     BLACKBOX_STATE_STOPPED,
@@ -280,6 +351,7 @@ typedef enum BlackboxState {
     BLACKBOX_STATE_SEND_GPS_H_HEADER,
     BLACKBOX_STATE_SEND_GPS_G_HEADER,
     BLACKBOX_STATE_SEND_SLOW_HEADER,
+    BLACKBOX_STATE_SEND_GYRO_RAW_HEADER,
     BLACKBOX_STATE_SEND_SYSINFO,
     BLACKBOX_STATE_PAUSED,
     BLACKBOX_STATE_RUNNING,
@@ -290,37 +362,6 @@ typedef enum BlackboxState {
 } BlackboxState;
 
 
-typedef struct blackboxMainState_s {
-    uint32_t time;
-
-    int32_t axisPID_P[XYZ_AXIS_COUNT];
-    int32_t axisPID_I[XYZ_AXIS_COUNT];
-    int32_t axisPID_D[XYZ_AXIS_COUNT];
-    int32_t axisPID_F[XYZ_AXIS_COUNT];
-
-    int16_t rcCommand[4];
-    int16_t setpoint[4];
-    int16_t gyroADC[XYZ_AXIS_COUNT];
-    int16_t accADC[XYZ_AXIS_COUNT];
-    int16_t debug[DEBUG16_VALUE_COUNT];
-    int16_t motor[MAX_SUPPORTED_MOTORS];
-    int16_t servo[MAX_SUPPORTED_SERVOS];
-
-    uint16_t vbatLatest;
-    int32_t amperageLatest;
-
-#ifdef USE_BARO
-    int32_t BaroAlt;
-#endif
-#ifdef USE_MAG
-    int16_t magADC[XYZ_AXIS_COUNT];
-#endif
-#ifdef USE_RANGEFINDER
-    int32_t surfaceRaw;
-#endif
-    uint16_t rssi;
-} blackboxMainState_t;
-
 typedef struct blackboxGpsState_s {
     int32_t GPS_home[2];
     int32_t GPS_coord[2];
@@ -384,14 +425,64 @@ static uint16_t vbatReference;
 static blackboxGpsState_t gpsHistory;
 static blackboxSlowState_t slowHistory;
 
-// Keep a history of length 2, plus a buffer for MW to store the new values into
-static blackboxMainState_t blackboxHistoryRing[3];
+typedef struct blackboxGyroRawSample_s {
+    uint32_t time;
+    int16_t gyroADCRaw[XYZ_AXIS_COUNT];
+} blackboxGyroRawSample_t;
+
+// Holds 4ms of samples at 8kHz, the blackbox writes them out every PID loop
+#define BLACKBOX_GYRO_RAW_RING_SIZE 32
+
+// Raw gyro samples captured by the gyro task, waiting to be written as R frames
+static blackboxGyroRawSample_t blackboxGyroRawRing[BLACKBOX_GYRO_RAW_RING_SIZE];
+static volatile uint8_t blackboxGyroRawHead; // only written by the gyro task
+static volatile uint8_t blackboxGyroRawTail; // only written by the blackbox
+static bool blackboxGyroRawCapturing;
+static blackboxGyroRawSample_t gyroRawHistory;
+
+// Main frames are captured by the PID loop and encoded later by the blackbox task, 2ms of frames at 8kHz
+#define BLACKBOX_CAPTURE_RING_SIZE 16
 
-// These point into blackboxHistoryRing, use them to know where to store history of a given age (0, 1 or 2 generations old)
-static blackboxMainState_t* blackboxHistory[3];
+typedef struct blackboxCapturedFrame_s {
+    blackboxMainState_t state;
+    bool intraframe;
+} blackboxCapturedFrame_t;
+
+// Main frames captured by the PID loop, waiting to be encoded
+static blackboxCapturedFrame_t blackboxCaptureRing[BLACKBOX_CAPTURE_RING_SIZE];
+static volatile uint8_t blackboxCaptureHead; // only written by the PID loop
+static volatile uint8_t blackboxCaptureTail; // only written by the encoder
+
+#define BLACKBOX_HISTORY_LENGTH 4
+
+// Keep a history of length 3, plus a buffer for MW to store the new values into
+static blackboxMainState_t blackboxHistoryRing[BLACKBOX_HISTORY_LENGTH];
+
+// These point into blackboxHistoryRing, use them to know where to store history of a given age (0 to 3 generations old)
+static blackboxMainState_t* blackboxHistory[BLACKBOX_HISTORY_LENGTH];
 
 static bool blackboxModeActivationConditionPresent = false;
 
+// A main field that is logged, with the P-frame encoding groups worked out
+typedef struct blackboxMainField_s {
+    uint8_t offset;
+    uint8_t size;
+    uint8_t isSigned;
+    uint8_t Ipredict;
+    uint8_t Iencode;
+    uint8_t Ppredict;
+    uint8_t Pencode;
+    uint8_t groupCount; // number of fields written together with this one in P-frames
+} blackboxMainField_t;
+
+// The fields whose conditions were met when logging started, so that writing a frame is a loop without tests
+static blackboxMainField_t blackboxActiveMainFields[ARRAYLEN(blackboxMainFields)];
+static uint8_t blackboxActiveMainFieldCount;
+
+// Weights of the ADAPTIVE predictor and state of the RICE encoding for each active field, reset by every I-frame
+static int16_t blackboxAdaptiveWeights[ARRAYLEN(blackboxMainFields)][2];
+static uint32_t blackboxRiceSums[ARRAYLEN(blackboxMainFields)];
+
 /**
  * Return true if it is safe to edit the Blackbox configuration.
  */
@@ -491,8 +582,84 @@ static bool testBlackboxCondition(FlightLogFieldCondition condition)
     return (blackboxConditionCache & (1 << condition)) != 0;
 }
 
+static int blackboxEncodingGroupSize(uint8_t encoding)
+{
+    switch (encoding) {
+    case FLIGHT_LOG_FIELD_ENCODING_TAG2_3S32:
+        return 3;
+    case FLIGHT_LOG_FIELD_ENCODING_TAG8_4S16:
+        return 4;
+    case FLIGHT_LOG_FIELD_ENCODING_TAG8_8SVB:
+        return 8;
+    default:
+        return 1;
+    }
+}
+
+// P-frame predictor of a main field, smooth fields use the configured higher order predictor
+static uint8_t blackboxMainFieldPPredictor(const blackboxDeltaFieldDefinition_t *def)
+{
+    if (def->smooth) {
+        switch (blackboxConfig()->predictor) {
+        case BLACKBOX_PREDICTOR_QUADRATIC:
+            return FLIGHT_LOG_FIELD_PREDICTOR_QUADRATIC;
+        case BLACKBOX_PREDICTOR_ADAPTIVE:
+            return FLIGHT_LOG_FIELD_PREDICTOR_ADAPTIVE;
+        default:
+            break;
+        }
+    }
+    return def->Ppredict;
+}
+
+// P-frame encoding of a main field, the Rice encoding replaces every encoding that writes data
+static uint8_t blackboxMainFieldPEncoding(const blackboxDeltaFieldDefinition_t *def)
+{
+    if (blackboxConfig()->encoding == BLACKBOX_ENCODING_RICE && def->Pencode != FLIGHT_LOG_FIELD_ENCODING_NULL) {
+        return FLIGHT_LOG_FIELD_ENCODING_RICE;
+    }
+    return def->Pencode;
+}
+
+/*
+ * Select the main fields to log from the condition cache, and group the fields that share a P-frame encoding in the
+ * same way as the log decoder does.
+ */
+static void blackboxBuildActiveMainFields(void)
+{
+    blackboxActiveMainFieldCount = 0;
+    for (unsigned i = 0; i < ARRAYLEN(blackboxMainFields); i++) {
+        const blackboxDeltaFieldDefinition_t *def = &blackboxMainFields[i];
+
+        if (testBlackboxCondition(def->condition)) {
+            blackboxMainField_t *field = &blackboxActiveMainFields[blackboxActiveMainFieldCount++];
+            field->offset = def->offset;
+            field->size = def->size;
+            field->isSigned = def->isSigned;
+            field->Ipredict = def->Ipredict;
+            field->Iencode = def->Iencode;
+            field->Ppredict = blackboxMainFieldPPredictor(def);
+            field->Pencode = blackboxMainFieldPEncoding(def);
+            field->groupCount = 1;
+        }
+    }
+
+    for (int i = 0; i < blackboxActiveMainFieldCount; ) {
+        blackboxMainField_t *field = &blackboxActiveMainFields[i];
+        const int groupSize = blackboxEncodingGroupSize(field->Pencode);
+
+        while (field->groupCount < groupSize && i + field->groupCount < blackboxActiveMainFieldCount
+            && blackboxActiveMainFields[i + field->groupCount].Pencode == field->Pencode) {
+            field->groupCount++;
+        }
+        i += field->groupCount;
+    }
+}
+
 static void blackboxSetState(BlackboxState newState)
 {
+    blackboxGyroRawCapturing = false;
+
     //Perform initial setup required for the new state
     switch (newState) {
     case BLACKBOX_STATE_PREPARE_LOG_FILE:
@@ -507,6 +674,7 @@ static void blackboxSetState(BlackboxState newState)
     case BLACKBOX_STATE_SEND_GPS_G_HEADER:
     case BLACKBOX_STATE_SEND_GPS_H_HEADER:
     case BLACKBOX_STATE_SEND_SLOW_HEADER:
+    case BLACKBOX_STATE_SEND_GYRO_RAW_HEADER:
         xmitState.headerIndex = 0;
         xmitState.u.fieldIndex = -1;
         break;
@@ -515,6 +683,10 @@ static void blackboxSetState(BlackboxState newState)
         break;
     case BLACKBOX_STATE_RUNNING:
         blackboxSlowFrameIterationTimer = blackboxSInterval; //Force a slow frame to be written on the first iteration
+        // Start with empty rings, the first R frames follow the first I-frame
+        blackboxCaptureTail = blackboxCaptureHead;
+        blackboxGyroRawTail = blackboxGyroRawHead;
+        blackboxGyroRawCapturing = blackboxConfig()->gyro_raw;
         break;
     case BLACKBOX_STATE_SHUTTING_DOWN:
         xmitState.u.startTime = millis();
@@ -525,235 +697,245 @@ static void blackboxSetState(BlackboxState newState)
     blackboxState = newState;
 }
 
-static void writeIntraframe(void)
+static int32_t blackboxMainFieldValue(const blackboxMainState_t *state, const blackboxMainField_t *field)
 {
-    blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
+    const void *value = (const uint8_t *)state + field->offset;
 
-    blackboxWrite('I');
-
-    blackboxWriteUnsignedVB(blackboxIteration);
-    blackboxWriteUnsignedVB(blackboxCurrent->time);
-
-    blackboxWriteSignedVBArray(blackboxCurrent->axisPID_P, XYZ_AXIS_COUNT);
-    blackboxWriteSignedVBArray(blackboxCurrent->axisPID_I, XYZ_AXIS_COUNT);
-
-    // Don't bother writing the current D term if the corresponding PID setting is zero
-    for (int x = 0; x < XYZ_AXIS_COUNT; x++) {
-        if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_0 + x)) {
-            blackboxWriteSignedVB(blackboxCurrent->axisPID_D[x]);
-        }
+    if (field->size == sizeof(int32_t)) {
+        return *(const int32_t *)value;
     }
+    return field->isSigned ? *(const int16_t *)value : *(const uint16_t *)value;
+}
 
-    blackboxWriteSignedVBArray(blackboxCurrent->axisPID_F, XYZ_AXIS_COUNT);
-
-    // Write roll, pitch and yaw first:
-    blackboxWriteSigned16VBArray(blackboxCurrent->rcCommand, 3);
-
-    /*
-     * Write the throttle separately from the rest of the RC data as it's unsigned.
-     * Throttle lies in range [PWM_RANGE_MIN..PWM_RANGE_MAX]:
-     */
-    blackboxWriteUnsignedVB(blackboxCurrent->rcCommand[THROTTLE]);
-
-    // Write setpoint roll, pitch, yaw, and throttle
-    blackboxWriteSigned16VBArray(blackboxCurrent->setpoint, 4);
-
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_VBAT)) {
-        /*
-         * Our voltage is expected to decrease over the course of the flight, so store our difference from
-         * the reference:
-         *
-         * Write 14 bits even if the number is negative (which would otherwise result in 32 bits)
-         */
-        blackboxWriteUnsignedVB((vbatReference - blackboxCurrent->vbatLatest) & 0x3FFF);
+static int32_t blackboxIntraPrediction(const blackboxMainState_t *current, const blackboxMainField_t *field)
+{
+    switch (field->Ipredict) {
+    case FLIGHT_LOG_FIELD_PREDICTOR_VBATREF:
+        // Our voltage is expected to decrease over the course of the flight, so store our difference from the reference
+        return vbatReference;
+    case FLIGHT_LOG_FIELD_PREDICTOR_MINMOTOR:
+        // Motors can be below minimum output when disarmed, but that doesn't happen much
+        return lrintf(motorOutputLow);
+    case FLIGHT_LOG_FIELD_PREDICTOR_MOTOR_0:
+        // Motors tend to be similar to each other so use the first motor's value as a predictor of the others
+        return current->motor[0];
+    case FLIGHT_LOG_FIELD_PREDICTOR_1500:
+        // Assume the tail spends most of its time around the center
+        return 1500;
+    default:
+        return 0;
     }
+}
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC)) {
-        // 12bit value directly from ADC
-        blackboxWriteSignedVB(blackboxCurrent->amperageLatest);
-    }
+static int blackboxSign(int32_t value)
+{
+    return (value > 0) - (value < 0);
+}
 
-#ifdef USE_MAG
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_MAG)) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->magADC, XYZ_AXIS_COUNT);
-    }
-#endif
+/*
+ * Residual of the ADAPTIVE predictor, which then adapts its weights to it the same way the decoder will.
+ */
+static int32_t blackboxAdaptiveResidual(const blackboxMainField_t *field, int32_t value)
+{
+    int16_t *weights = blackboxAdaptiveWeights[field - blackboxActiveMainFields];
+    const int32_t previous = blackboxMainFieldValue(blackboxHistory[1], field);
+    const int32_t previous2 = blackboxMainFieldValue(blackboxHistory[2], field);
+    const int32_t delta1 = previous - previous2;
+    const int32_t delta2 = previous2 - blackboxMainFieldValue(blackboxHistory[3], field);
 
-#ifdef USE_BARO
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_BARO)) {
-        blackboxWriteSignedVB(blackboxCurrent->BaroAlt);
-    }
-#endif
+    const int32_t residual = value - (previous + ((weights[0] * delta1 + weights[1] * delta2) >> FLIGHT_LOG_ADAPTIVE_WEIGHT_SHIFT));
 
-#ifdef USE_RANGEFINDER
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RANGEFINDER)) {
-        blackboxWriteSignedVB(blackboxCurrent->surfaceRaw);
-    }
-#endif
+    const int sign = blackboxSign(residual);
+    weights[0] = constrain(weights[0] + sign * blackboxSign(delta1) * FLIGHT_LOG_ADAPTIVE_STEP, -FLIGHT_LOG_ADAPTIVE_WEIGHT_LIMIT, FLIGHT_LOG_ADAPTIVE_WEIGHT_LIMIT);
+    weights[1] = constrain(weights[1] + sign * blackboxSign(delta2) * FLIGHT_LOG_ADAPTIVE_STEP, -FLIGHT_LOG_ADAPTIVE_WEIGHT_LIMIT, FLIGHT_LOG_ADAPTIVE_WEIGHT_LIMIT);
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RSSI)) {
-        blackboxWriteUnsignedVB(blackboxCurrent->rssi);
-    }
+    return residual;
+}
 
-    blackboxWriteSigned16VBArray(blackboxCurrent->gyroADC, XYZ_AXIS_COUNT);
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_ACC)) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->accADC, XYZ_AXIS_COUNT);
+static int32_t blackboxInterResidual(const blackboxMainField_t *field)
+{
+    const int32_t value = blackboxMainFieldValue(blackboxHistory[0], field);
+
+    switch (field->Ppredict) {
+    case FLIGHT_LOG_FIELD_PREDICTOR_PREVIOUS:
+        return value - blackboxMainFieldValue(blackboxHistory[1], field);
+    case FLIGHT_LOG_FIELD_PREDICTOR_STRAIGHT_LINE:
+        // Unsigned so that a timestamp wrapping around gives the right difference
+        return (int32_t)((uint32_t)value - 2 * (uint32_t)blackboxMainFieldValue(blackboxHistory[1], field) + (uint32_t)blackboxMainFieldValue(blackboxHistory[2], field));
+    case FLIGHT_LOG_FIELD_PREDICTOR_AVERAGE_2:
+        return value - (blackboxMainFieldValue(blackboxHistory[1], field) + blackboxMainFieldValue(blackboxHistory[2], field)) / 2;
+    case FLIGHT_LOG_FIELD_PREDICTOR_QUADRATIC:
+        return value - (3 * (blackboxMainFieldValue(blackboxHistory[1], field) - blackboxMainFieldValue(blackboxHistory[2], field)) + blackboxMainFieldValue(blackboxHistory[3], field));
+    case FLIGHT_LOG_FIELD_PREDICTOR_ADAPTIVE:
+        return blackboxAdaptiveResidual(field, value);
+    default:
+        return value;
     }
+}
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_DEBUG)) {
-        blackboxWriteSigned16VBArray(blackboxCurrent->debug, DEBUG16_VALUE_COUNT);
-    }
+static void writeIntraframe(void)
+{
+    blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
 
-    //Motors can be below minimum output when disarmed, but that doesn't happen much
-    blackboxWriteUnsignedVB(blackboxCurrent->motor[0] - motorOutputLow);
+    blackboxWrite('I');
 
-    //Motors tend to be similar to each other so use the first motor's value as a predictor of the others
-    const int motorCount = getMotorCount();
-    for (int x = 1; x < motorCount; x++) {
-        blackboxWriteSignedVB(blackboxCurrent->motor[x] - blackboxCurrent->motor[0]);
-    }
+    for (const blackboxMainField_t *field = blackboxActiveMainFields; field < blackboxActiveMainFields + blackboxActiveMainFieldCount; field++) {
+        const int32_t value = blackboxMainFieldValue(blackboxCurrent, field) - blackboxIntraPrediction(blackboxCurrent, field);
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_TRICOPTER)) {
-        //Assume the tail spends most of its time around the center
-        blackboxWriteSignedVB(blackboxCurrent->servo[5] - 1500);
+        switch (field->Iencode) {
+        case FLIGHT_LOG_FIELD_ENCODING_SIGNED_VB:
+            blackboxWriteSignedVB(value);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_UNSIGNED_VB:
+            blackboxWriteUnsignedVB(value);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_NEG_14BIT:
+            // Write 14 bits even if the number is negative (which would otherwise result in 32 bits)
+            blackboxWriteUnsignedVB(-value & 0x3FFF);
+            break;
+        default:
+            break;
+        }
     }
 
     //Rotate our history buffers:
 
     //The current state becomes the new "before" state
     blackboxHistory[1] = blackboxHistory[0];
-    //And since we have no other history, we also use it for the "before, before" state
+    //And since we have no other history, we also use it for the older states
     blackboxHistory[2] = blackboxHistory[0];
+    blackboxHistory[3] = blackboxHistory[0];
     //And advance the current state over to a blank space ready to be filled
-    blackboxHistory[0] = ((blackboxHistory[0] - blackboxHistoryRing + 1) % 3) + blackboxHistoryRing;
+    blackboxHistory[0] = ((blackboxHistory[0] - blackboxHistoryRing + 1) % BLACKBOX_HISTORY_LENGTH) + blackboxHistoryRing;
 
-    blackboxLoggedAnyFrames = true;
-}
-
-static void blackboxWriteMainStateArrayUsingAveragePredictor(int arrOffsetInHistory, int count)
-{
-    int16_t *curr  = (int16_t*) ((char*) (blackboxHistory[0]) + arrOffsetInHistory);
-    int16_t *prev1 = (int16_t*) ((char*) (blackboxHistory[1]) + arrOffsetInHistory);
-    int16_t *prev2 = (int16_t*) ((char*) (blackboxHistory[2]) + arrOffsetInHistory);
-
-    for (int i = 0; i < count; i++) {
-        // Predictor is the average of the previous two history states
-        int32_t predictor = (prev1[i] + prev2[i]) / 2;
+    memset(blackboxAdaptiveWeights, 0, sizeof(blackboxAdaptiveWeights));
+    memset(blackboxRiceSums, 0, sizeof(blackboxRiceSums));
+    memset(&gyroRawHistory, 0, sizeof(gyroRawHistory));
 
-        blackboxWriteSignedVB(curr[i] - predictor);
-    }
+    blackboxLoggedAnyFrames = true;
 }
 
 static void writeInterframe(void)
 {
-    blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
-    blackboxMainState_t *blackboxLast = blackboxHistory[1];
+    int32_t values[8];
 
     blackboxWrite('P');
 
-    //No need to store iteration count since its delta is always 1
+    for (const blackboxMainField_t *field = blackboxActiveMainFields; field < blackboxActiveMainFields + blackboxActiveMainFieldCount; field += field->groupCount) {
+        for (int i = 0; i < field->groupCount; i++) {
+            values[i] = blackboxInterResidual(field + i);
+        }
 
-    /*
-     * Since the difference between the difference between successive times will be nearly zero (due to consistent
-     * looptime spacing), use second-order differences.
-     */
-    blackboxWriteSignedVB((int32_t) (blackboxHistory[0]->time - 2 * blackboxHistory[1]->time + blackboxHistory[2]->time));
+        if (field->Pencode != FLIGHT_LOG_FIELD_ENCODING_RICE && field->Pencode != FLIGHT_LOG_FIELD_ENCODING_NULL) {
+            // Byte aligned encodings start on a byte boundary
+            blackboxFlushBits();
+        }
 
-    int32_t deltas[8];
-    int32_t setpointDeltas[4];
+        switch (field->Pencode) {
+        case FLIGHT_LOG_FIELD_ENCODING_SIGNED_VB:
+            blackboxWriteSignedVB(values[0]);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG2_3S32:
+            // The PID I field changes very slowly, most of the time +-2, so all three fields usually fit in one byte
+            blackboxWriteTag2_3S32(values);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG8_4S16:
+            // RC tends to stay the same or fairly small for many frames at a time, so pack multiple values per byte
+            blackboxWriteTag8_4S16(values);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG8_8SVB:
+            // Sensors that are updated periodically, so deltas are normally zero
+            blackboxWriteTag8_8SVB(values, field->groupCount);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_RICE:
+            // Small residuals of smooth signals take a few bits rather than a byte
+            blackboxWriteRice(values[0], &blackboxRiceSums[field - blackboxActiveMainFields]);
+            break;
+        default:
+            // The loop iteration always increments, so isn't written
+            break;
+        }
+    }
+    blackboxFlushBits();
 
-    arraySubInt32(deltas, blackboxCurrent->axisPID_P, blackboxLast->axisPID_P, XYZ_AXIS_COUNT);
-    blackboxWriteSignedVBArray(deltas, XYZ_AXIS_COUNT);
+    //Rotate our history buffers
+    blackboxHistory[3] = blackboxHistory[2];
+    blackboxHistory[2] = blackboxHistory[1];
+    blackboxHistory[1] = blackboxHistory[0];
+    blackboxHistory[0] = ((blackboxHistory[0] - blackboxHistoryRing + 1) % BLACKBOX_HISTORY_LENGTH) + blackboxHistoryRing;
 
-    /*
-     * The PID I field changes very slowly, most of the time +-2, so use an encoding
-     * that can pack all three fields into one byte in that situation.
-     */
-    arraySubInt32(deltas, blackboxCurrent->axisPID_I, blackboxLast->axisPID_I, XYZ_AXIS_COUNT);
-    blackboxWriteTag2_3S32(deltas);
+    blackboxLoggedAnyFrames = true;
+}
 
-    /*
-     * The PID D term is frequently set to zero for yaw, which makes the result from the calculation
-     * always zero. So don't bother recording D results when PID D terms are zero.
-     */
-    for (int x = 0; x < XYZ_AXIS_COUNT; x++) {
-        if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_NONZERO_PID_D_0 + x)) {
-            blackboxWriteSignedVB(blackboxCurrent->axisPID_D[x] - blackboxLast->axisPID_D[x]);
-        }
+/**
+ * Called by the gyro task for every gyro sample. Queues the sample for an R frame if they are being logged, when the
+ * ring is full the sample is dropped, which shows as a gap in the R frame times.
+ */
+FAST_CODE void blackboxCaptureGyroRaw(timeUs_t currentTimeUs, const int16_t *gyroADCRaw)
+{
+    if (!blackboxGyroRawCapturing) {
+        return;
     }
 
-    arraySubInt32(deltas, blackboxCurrent->axisPID_F, blackboxLast->axisPID_F, XYZ_AXIS_COUNT);
-    blackboxWriteSignedVBArray(deltas, XYZ_AXIS_COUNT);
-
-    /*
-     * RC tends to stay the same or fairly small for many frames at a time, so use an encoding that
-     * can pack multiple values per byte:
-     */
-    for (int x = 0; x < 4; x++) {
-        deltas[x] = blackboxCurrent->rcCommand[x] - blackboxLast->rcCommand[x];
-        setpointDeltas[x] = blackboxCurrent->setpoint[x] - blackboxLast->setpoint[x];
+    const uint8_t head = blackboxGyroRawHead;
+    const uint8_t nextHead = (head + 1) % BLACKBOX_GYRO_RAW_RING_SIZE;
+    if (nextHead == blackboxGyroRawTail) {
+        return;
     }
 
-    blackboxWriteTag8_4S16(deltas);
-    blackboxWriteTag8_4S16(setpointDeltas);
+    blackboxGyroRawSample_t *sample = &blackboxGyroRawRing[head];
+    sample->time = currentTimeUs;
+    memcpy(sample->gyroADCRaw, gyroADCRaw, sizeof(sample->gyroADCRaw));
 
-    //Check for sensors that are updated periodically (so deltas are normally zero)
-    int optionalFieldCount = 0;
+    // Publish the sample only once it is complete
+    blackboxGyroRawHead = nextHead;
+}
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_VBAT)) {
-        deltas[optionalFieldCount++] = (int32_t) blackboxCurrent->vbatLatest - blackboxLast->vbatLatest;
-    }
+/* Write the gyro samples captured since the last call as "R" frames, each a delta from the previous one. */
+static void writeGyroRawFrames(void)
+{
+    uint8_t tail = blackboxGyroRawTail;
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_AMPERAGE_ADC)) {
-        deltas[optionalFieldCount++] = blackboxCurrent->amperageLatest - blackboxLast->amperageLatest;
-    }
+    while (tail != blackboxGyroRawHead) {
+        const blackboxGyroRawSample_t *sample = &blackboxGyroRawRing[tail];
 
-#ifdef USE_MAG
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_MAG)) {
-        for (int x = 0; x < XYZ_AXIS_COUNT; x++) {
-            deltas[optionalFieldCount++] = blackboxCurrent->magADC[x] - blackboxLast->magADC[x];
+        blackboxWrite('R');
+        blackboxWriteUnsignedVB(sample->time - gyroRawHistory.time);
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            blackboxWriteSignedVB(sample->gyroADCRaw[axis] - gyroRawHistory.gyroADCRaw[axis]);
         }
-    }
-#endif
+        gyroRawHistory = *sample;
 
-#ifdef USE_BARO
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_BARO)) {
-        deltas[optionalFieldCount++] = blackboxCurrent->BaroAlt - blackboxLast->BaroAlt;
+        tail = (tail + 1) % BLACKBOX_GYRO_RAW_RING_SIZE;
+        blackboxGyroRawTail = tail;
     }
-#endif
+}
 
-#ifdef USE_RANGEFINDER
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RANGEFINDER)) {
-        deltas[optionalFieldCount++] = blackboxCurrent->surfaceRaw - blackboxLast->surfaceRaw;
-    }
-#endif
+/*
+ * Encode the main frames captured since the last call, in the order they were captured, followed by the pending gyro
+ * samples. Anything else written to the log while logging must call this first, so that the log stays in time order.
+ */
+static void writeCapturedFrames(void)
+{
+    uint8_t tail = blackboxCaptureTail;
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_RSSI)) {
-        deltas[optionalFieldCount++] = (int32_t) blackboxCurrent->rssi - blackboxLast->rssi;
-    }
+    while (tail != blackboxCaptureHead) {
+        const blackboxCapturedFrame_t *frame = &blackboxCaptureRing[tail];
 
-    blackboxWriteTag8_8SVB(deltas, optionalFieldCount);
+        *blackboxHistory[0] = frame->state;
+        if (frame->intraframe) {
+            writeIntraframe();
+        } else {
+            writeInterframe();
+        }
 
-    //Since gyros, accs and motors are noisy, base their predictions on the average of the history:
-    blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, gyroADC),   XYZ_AXIS_COUNT);
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_ACC)) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, accADC), XYZ_AXIS_COUNT);
-    }
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_DEBUG)) {
-        blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, debug), DEBUG16_VALUE_COUNT);
+        tail = (tail + 1) % BLACKBOX_CAPTURE_RING_SIZE;
+        blackboxCaptureTail = tail;
     }
-    blackboxWriteMainStateArrayUsingAveragePredictor(offsetof(blackboxMainState_t, motor),     getMotorCount());
 
-    if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_TRICOPTER)) {
-        blackboxWriteSignedVB(blackboxCurrent->servo[5] - blackboxLast->servo[5]);
+    if (blackboxGyroRawCapturing) {
+        writeGyroRawFrames();
     }
-
-    //Rotate our history buffers
-    blackboxHistory[2] = blackboxHistory[1];
-    blackboxHistory[1] = blackboxHistory[0];
-    blackboxHistory[0] = ((blackboxHistory[0] - blackboxHistoryRing + 1) % 3) + blackboxHistoryRing;
-
-    blackboxLoggedAnyFrames = true;
 }
 
 /* Write the contents of the global "slowHistory" to the log as an "S" frame. Because this data is logged so
@@ -762,6 +944,8 @@ static void writeSlowFrame(void)
 {
     int32_t values[3];
 
+    writeCapturedFrames();
+
     blackboxWrite('S');
 
     blackboxWriteUnsignedVB(slowHistory.flightModeFlags);
@@ -867,6 +1051,7 @@ static void blackboxStart(void)
     blackboxHistory[0] = &blackboxHistoryRing[0];
     blackboxHistory[1] = &blackboxHistoryRing[1];
     blackboxHistory[2] = &blackboxHistoryRing[2];
+    blackboxHistory[3] = &blackboxHistoryRing[3];
 
     vbatReference = getBatteryVoltageLatest();
 
@@ -878,6 +1063,7 @@ static void blackboxStart(void)
      * cache those now.
      */
     blackboxBuildConditionCache();
+    blackboxBuildActiveMainFields();
 
     blackboxModeActivationConditionPresent = isModeActivationConditionPresent(BOXBLACKBOX);
 
@@ -1004,13 +1190,11 @@ static void writeGPSFrame(timeUs_t currentTimeUs)
 #endif
 
 /**
- * Fill the current state of the blackbox using values read from the flight controller
+ * Fill the given state using values read from the flight controller
  */
-static void loadMainState(timeUs_t currentTimeUs)
+static void loadMainState(blackboxMainState_t *blackboxCurrent, timeUs_t currentTimeUs)
 {
-#ifndef UNIT_TEST
-    blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
-
+    blackboxCurrent->loopIteration = blackboxIteration;
     blackboxCurrent->time = currentTimeUs;
 
     for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
@@ -1060,14 +1244,15 @@ static void loadMainState(timeUs_t currentTimeUs)
 #endif
 
     blackboxCurrent->rssi = getRssi();
+#ifdef USE_LATENCY_TRACE
+    blackboxCurrent->rcLatency[0] = latencyTraceLastUs(LATENCY_STAGE_RC_COMMAND);
+    blackboxCurrent->rcLatency[1] = latencyTraceLastUs(LATENCY_STAGE_MOTOR);
+#endif
 
 #ifdef USE_SERVOS
     //Tail servo for tricopters
     blackboxCurrent->servo[5] = servo[5];
 #endif
-#else
-    UNUSED(currentTimeUs);
-#endif // UNIT_TEST
 }
 
 /**
@@ -1168,6 +1353,12 @@ static bool sendFieldDefinition(char mainFrameChar, char deltaFrameChar, const v
                 if (def->fieldNameIndex != -1) {
                     blackboxPrintf("[%d]", def->fieldNameIndex);
                 }
+            } else if (deltaFrameChar && xmitState.headerIndex == BLACKBOX_SIMPLE_FIELD_HEADER_COUNT) {
+                // The P-frame predictor of smooth fields depends on the configuration
+                blackboxPrintf("%d", blackboxMainFieldPPredictor((const blackboxDeltaFieldDefinition_t *)def));
+            } else if (deltaFrameChar && xmitState.headerIndex == BLACKBOX_SIMPLE_FIELD_HEADER_COUNT + 1) {
+                // So does the P-frame encoding
+                blackboxPrintf("%d", blackboxMainFieldPEncoding((const blackboxDeltaFieldDefinition_t *)def));
             } else {
                 //The other headers are integers
                 blackboxPrintf("%d", def->arr[xmitState.headerIndex - 1]);
@@ -1434,8 +1625,10 @@ static bool blackboxWriteSysinfo(void)
     }
 
     xmitState.headerIndex++;
-#endif // UNIT_TEST
     return false;
+#else
+    return true;
+#endif // UNIT_TEST
 }
 
 /**
@@ -1448,6 +1641,8 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data)
         return;
     }
 
+    writeCapturedFrames();
+
     //Shared header for event frames
     blackboxWrite('E');
     blackboxWrite(event);
@@ -1554,6 +1749,26 @@ STATIC_UNIT_TESTED void blackboxAdvanceIterationTimers(void)
     }
 }
 
+/*
+ * Take a snapshot of the flight controller state for a main frame, which is all the PID loop does for main frames.
+ * If the blackbox task has fallen so far behind that the ring is full the frames are encoded right away, so none are lost.
+ */
+static void captureMainFrame(timeUs_t currentTimeUs, bool intraframe)
+{
+    const uint8_t head = blackboxCaptureHead;
+    const uint8_t nextHead = (head + 1) % BLACKBOX_CAPTURE_RING_SIZE;
+    if (nextHead == blackboxCaptureTail) {
+        writeCapturedFrames();
+    }
+
+    blackboxCapturedFrame_t *frame = &blackboxCaptureRing[head];
+    loadMainState(&frame->state, currentTimeUs);
+    frame->intraframe = intraframe;
+
+    // Publish the frame only once it is complete
+    blackboxCaptureHead = nextHead;
+}
+
 // Called once every FC loop in order to log the current state
 STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs)
 {
@@ -1567,8 +1782,7 @@ STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs)
             writeSlowFrameIfNeeded();
         }
 
-        loadMainState(currentTimeUs);
-        writeIntraframe();
+        captureMainFrame(currentTimeUs, true);
     } else {
         blackboxCheckAndLogArmingBeep();
         blackboxCheckAndLogFlightMode(); // Check for FlightMode status change event
@@ -1580,25 +1794,39 @@ STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs)
              */
             writeSlowFrameIfNeeded();
 
-            loadMainState(currentTimeUs);
-            writeInterframe();
+            captureMainFrame(currentTimeUs, false);
         }
 #ifdef USE_GPS
         if (featureIsEnabled(FEATURE_GPS)) {
             if (blackboxShouldLogGpsHomeFrame()) {
+                writeCapturedFrames();
                 writeGPSHomeFrame();
                 writeGPSFrame(currentTimeUs);
             } else if (gpsSol.numSat != gpsHistory.GPS_numSat
                     || gpsSol.llh.lat != gpsHistory.GPS_coord[LAT]
                     || gpsSol.llh.lon != gpsHistory.GPS_coord[LON]) {
                 //We could check for velocity changes as well but I doubt it changes independent of position
+                writeCapturedFrames();
                 writeGPSFrame(currentTimeUs);
             }
         }
 #endif
     }
+}
+
+/**
+ * Run by the blackbox task to encode and write out the frames captured by the PID loop and the gyro task.
+ */
+void blackboxEncode(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    if (blackboxState != BLACKBOX_STATE_RUNNING && blackboxState != BLACKBOX_STATE_PAUSED) {
+        return;
+    }
+
+    writeCapturedFrames();
 
-    //Flush every iteration so that our runtime variance is minimized
     blackboxDeviceFlush();
 }
 
@@ -1680,6 +1908,14 @@ void blackboxUpdate(timeUs_t currentTimeUs)
         //On entry of this state, xmitState.headerIndex is 0 and xmitState.u.fieldIndex is -1
         if (!sendFieldDefinition('S', 0, blackboxSlowFields, blackboxSlowFields + 1, ARRAYLEN(blackboxSlowFields),
                 NULL, NULL)) {
+            blackboxSetState(blackboxConfig()->gyro_raw ? BLACKBOX_STATE_SEND_GYRO_RAW_HEADER : BLACKBOX_STATE_SEND_SYSINFO);
+        }
+        break;
+    case BLACKBOX_STATE_SEND_GYRO_RAW_HEADER:
+        blackboxReplenishHeaderBudget();
+        //On entry of this state, xmitState.headerIndex is 0 and xmitState.u.fieldIndex is -1
+        if (!sendFieldDefinition('R', 0, blackboxGyroRawFields, blackboxGyroRawFields + 1, ARRAYLEN(blackboxGyroRawFields),
+                NULL, NULL)) {
             blackboxSetState(BLACKBOX_STATE_SEND_SYSINFO);
         }
         break;
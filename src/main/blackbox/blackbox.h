@@ -38,6 +38,19 @@ typedef enum BlackboxMode {
     BLACKBOX_MODE_ALWAYS_ON
 } BlackboxMode;
 
+// P-frame predictor used for the smooth, high rate fields (gyro, motors and setpoint)
+typedef enum BlackboxPredictor {
+    BLACKBOX_PREDICTOR_STANDARD = 0,
+    BLACKBOX_PREDICTOR_QUADRATIC,
+    BLACKBOX_PREDICTOR_ADAPTIVE
+} BlackboxPredictor;
+
+// Encoding of the P-frame fields
+typedef enum BlackboxEncoding {
+    BLACKBOX_ENCODING_STANDARD = 0,
+    BLACKBOX_ENCODING_RICE
+} BlackboxEncoding;
+
 typedef enum FlightLogEvent {
     FLIGHT_LOG_EVENT_SYNC_BEEP = 0,
     FLIGHT_LOG_EVENT_AUTOTUNE_CYCLE_START = 10,   // UNUSED
@@ -55,6 +68,9 @@ typedef struct blackboxConfig_s {
     uint8_t device;
     uint8_t record_acc;
     uint8_t mode;
+    uint8_t predictor;
+    uint8_t encoding;
+    uint8_t gyro_raw; // also log every raw gyro sample in R frames
 } blackboxConfig_t;
 
 PG_DECLARE(blackboxConfig_t, blackboxConfig);
@@ -64,6 +80,8 @@ void blackboxLogEvent(FlightLogEvent event, union flightLogEventData_u *data);
 
 void blackboxInit(void);
 void blackboxUpdate(timeUs_t currentTimeUs);
+void blackboxEncode(timeUs_t currentTimeUs);
+void blackboxCaptureGyroRaw(timeUs_t currentTimeUs, const int16_t *gyroADCRaw);
 void blackboxSetStartDateTime(const char *dateTime, timeMs_t timeNowMs);
 int blackboxCalculatePDenom(int rateNum, int rateDenom);
 uint8_t blackboxGetRateDenom(void);
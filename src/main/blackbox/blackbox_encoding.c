@@ -28,12 +28,19 @@
 
 #ifdef USE_BLACKBOX
 
+#include "blackbox.h"
 #include "blackbox_encoding.h"
+#include "blackbox_fielddefs.h"
 #include "blackbox_io.h"
 
 #include "common/encoding.h"
+#include "common/maths.h"
 #include "common/printf.h"
 
+// Bits written by blackboxWriteBits() that don't make up a whole byte yet, in the low bits
+static uint32_t bitBuffer;
+static uint8_t bitCount;
+
 
 static void _putc(void *p, char c)
 {
@@ -493,6 +500,69 @@ void blackboxWriteTag8_8SVB(int32_t *values, int valueCount)
     }
 }
 
+/**
+ * Append the low count bits of value to the bit stream, writing out the bytes that are complete.
+ * value must fit in count bits, and count must be 24 or less.
+ */
+static void blackboxWriteBits(uint32_t value, int count)
+{
+    // The bits shifted out of the buffer have been written already
+    bitBuffer = (bitBuffer << count) | value;
+    bitCount += count;
+
+    while (bitCount >= 8) {
+        bitCount -= 8;
+        blackboxWrite((uint8_t)(bitBuffer >> bitCount));
+    }
+}
+
+/**
+ * Pad the bit stream with zeros to a byte boundary and write out the last byte.
+ */
+void blackboxFlushBits(void)
+{
+    if (bitCount) {
+        blackboxWrite((uint8_t)(bitBuffer << (8 - bitCount)));
+        bitCount = 0;
+    }
+}
+
+static int bitLength(uint32_t value)
+{
+    return value ? 32 - __builtin_clz(value) : 0;
+}
+
+/**
+ * Write a signed integer to the bit stream with an adaptive Rice code, see FLIGHT_LOG_FIELD_ENCODING_RICE. magnitudeSum
+ * is the state of the field, the caller must reset it to zero whenever the decoder does (on I-frames) and call
+ * blackboxFlushBits() before writing anything byte aligned.
+ */
+void blackboxWriteRice(int32_t value, uint32_t *magnitudeSum)
+{
+    const uint32_t u = zigzagEncode(value);
+    const int k = MIN(bitLength(*magnitudeSum >> (FLIGHT_LOG_RICE_MEAN_SHIFT + 1)), FLIGHT_LOG_RICE_MAX_K);
+    const uint32_t quotient = u >> k;
+
+    if (quotient < FLIGHT_LOG_RICE_ESCAPE) {
+        // Unary quotient terminated by a zero, then the remainder
+        blackboxWriteBits(((1 << quotient) - 1) << 1, quotient + 1);
+        blackboxWriteBits(u & ((1 << k) - 1), k);
+    } else {
+        // Rare large values are written in binary with their length
+        const int length = bitLength(u);
+        blackboxWriteBits((1 << FLIGHT_LOG_RICE_ESCAPE) - 1, FLIGHT_LOG_RICE_ESCAPE);
+        blackboxWriteBits(length - 1, 5);
+        if (length > 16) {
+            blackboxWriteBits(u >> 16, length - 16);
+            blackboxWriteBits(u & 0xFFFF, 16);
+        } else {
+            blackboxWriteBits(u, length);
+        }
+    }
+
+    *magnitudeSum += MIN(u, 0xFFFFU) - (*magnitudeSum >> FLIGHT_LOG_RICE_MEAN_SHIFT);
+}
+
 /** Write unsigned integer **/
 void blackboxWriteU32(int32_t value)
 {
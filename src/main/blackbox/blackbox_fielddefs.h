@@ -89,10 +89,46 @@ typedef enum FlightLogFieldPredictor {
     FLIGHT_LOG_FIELD_PREDICTOR_LAST_MAIN_FRAME_TIME = 10,
 
     //Predict that this field is the minimum motor output
-    FLIGHT_LOG_FIELD_PREDICTOR_MINMOTOR       = 11
+    FLIGHT_LOG_FIELD_PREDICTOR_MINMOTOR       = 11,
+
+    //Predict that the curvature through the past three history items continues (3 * prev - 3 * prev2 + prev3):
+    FLIGHT_LOG_FIELD_PREDICTOR_QUADRATIC      = 12,
+
+    //Predict the previous item plus a weighted sum of the past two deltas, see FLIGHT_LOG_ADAPTIVE_*:
+    FLIGHT_LOG_FIELD_PREDICTOR_ADAPTIVE       = 13
 
 } FlightLogFieldPredictor;
 
+/*
+ * The ADAPTIVE predictor, with d1 = prev - prev2 and d2 = prev2 - prev3:
+ *
+ *   prediction = prev + ((w1 * d1 + w2 * d2) >> FLIGHT_LOG_ADAPTIVE_WEIGHT_SHIFT)
+ *
+ * Both weights are zero after an I-frame. After each P-frame field is coded each weight moves by
+ * FLIGHT_LOG_ADAPTIVE_STEP towards reducing the residual (sign-sign LMS), i.e. by sign(residual) * sign(d),
+ * and is limited to +-FLIGHT_LOG_ADAPTIVE_WEIGHT_LIMIT. The shift is arithmetic.
+ */
+#define FLIGHT_LOG_ADAPTIVE_WEIGHT_SHIFT    8
+#define FLIGHT_LOG_ADAPTIVE_STEP            32
+#define FLIGHT_LOG_ADAPTIVE_WEIGHT_LIMIT    (2 << FLIGHT_LOG_ADAPTIVE_WEIGHT_SHIFT)
+
+/*
+ * The RICE encoding. The value is ZigZag mapped to u (0, -1, 1, -2... become 0, 1, 2, 3...) and written most
+ * significant bit first as u >> k one bits and a zero bit, followed by the low k bits of u. If u >> k is at
+ * least FLIGHT_LOG_RICE_ESCAPE then FLIGHT_LOG_RICE_ESCAPE one bits are written instead, followed by the bit
+ * length of u less one in 5 bits and then that many bits of u.
+ *
+ * Each field has its own k, the bit length of sum >> (FLIGHT_LOG_RICE_MEAN_SHIFT + 1) limited to
+ * FLIGHT_LOG_RICE_MAX_K. The sum is zero after an I-frame, and after each value is coded
+ * sum += min(u, 0xFFFF) - (sum >> FLIGHT_LOG_RICE_MEAN_SHIFT), so that sum >> FLIGHT_LOG_RICE_MEAN_SHIFT follows the mean of u.
+ *
+ * The bits of consecutive RICE fields are packed together, and padded with zeros to a byte boundary before a field
+ * with a byte aligned encoding and at the end of the frame.
+ */
+#define FLIGHT_LOG_RICE_ESCAPE              12
+#define FLIGHT_LOG_RICE_MEAN_SHIFT          2
+#define FLIGHT_LOG_RICE_MAX_K               16
+
 typedef enum FlightLogFieldEncoding {
     FLIGHT_LOG_FIELD_ENCODING_SIGNED_VB       = 0, // Signed variable-byte
     FLIGHT_LOG_FIELD_ENCODING_UNSIGNED_VB     = 1, // Unsigned variable-byte
@@ -101,7 +137,8 @@ typedef enum FlightLogFieldEncoding {
     FLIGHT_LOG_FIELD_ENCODING_TAG2_3S32       = 7,
     FLIGHT_LOG_FIELD_ENCODING_TAG8_4S16       = 8,
     FLIGHT_LOG_FIELD_ENCODING_NULL            = 9, // Nothing is written to the file, take value to be zero
-    FLIGHT_LOG_FIELD_ENCODING_TAG2_3SVARIABLE = 10
+    FLIGHT_LOG_FIELD_ENCODING_TAG2_3SVARIABLE = 10,
+    FLIGHT_LOG_FIELD_ENCODING_RICE            = 11  // Adaptive Rice code, bit packed, see FLIGHT_LOG_RICE_*
 } FlightLogFieldEncoding;
 
 typedef enum FlightLogFieldSign {
@@ -97,6 +97,7 @@ bool cliMode = false;
 #include "fc/board_info.h"
 #include "fc/controlrate_profile.h"
 #include "fc/core.h"
+#include "fc/latency_trace.h"
 #include "fc/rc.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
@@ -4333,6 +4334,74 @@ static uint8_t getWordLength(char *bufBegin, char *bufEnd)
     return bufEnd - bufBegin;
 }
 
+#ifdef USE_CLI_SETTING_NAME_INDEX
+// compare a name of the given length to a setting name, ordered like strcasecmp()
+static int compareSettingName(const char *name, uint8_t length, const char *settingName)
+{
+    const int result = strncasecmp(name, settingName, length);
+    if (result) {
+        return result;
+    }
+    // a name that is a prefix of the setting name orders before it
+    return settingName[length] ? -1 : 0;
+}
+
+// sort the setting indices by name so that names can be looked up with a binary search
+STATIC_UNIT_TESTED void cliBuildSettingNameIndex(const clivalue_t *table, uint16_t count, uint16_t *nameIndex)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        nameIndex[i] = i;
+    }
+
+    // shell sort, the table is too large for an insertion sort and too small to need anything more elaborate
+    uint16_t gap = 1;
+    while (gap < count / 3) {
+        gap = gap * 3 + 1;
+    }
+    for (; gap > 0; gap /= 3) {
+        for (uint16_t i = gap; i < count; i++) {
+            const uint16_t index = nameIndex[i];
+            uint16_t j = i;
+            while (j >= gap && strcasecmp(table[nameIndex[j - gap]].name, table[index].name) > 0) {
+                nameIndex[j] = nameIndex[j - gap];
+                j -= gap;
+            }
+            nameIndex[j] = index;
+        }
+    }
+}
+
+// returns the index of the setting with the given name, or count if there is none
+STATIC_UNIT_TESTED uint16_t cliFindSettingByName(const clivalue_t *table, uint16_t count, const uint16_t *nameIndex, const char *name, uint8_t length)
+{
+    uint16_t low = 0;
+    uint16_t high = count;
+    while (low < high) {
+        const uint16_t mid = low + (high - low) / 2;
+        const int result = compareSettingName(name, length, table[nameIndex[mid]].name);
+        if (result == 0) {
+            return nameIndex[mid];
+        } else if (result < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return count;
+}
+
+uint16_t cliGetSettingIndex(char *name, uint8_t length)
+{
+    // built on first use, pasting a diff does a lookup for every line
+    static bool nameIndexBuilt = false;
+    if (!nameIndexBuilt) {
+        cliBuildSettingNameIndex(valueTable, valueTableEntryCount, valueTableNameIndex);
+        nameIndexBuilt = true;
+    }
+
+    return cliFindSettingByName(valueTable, valueTableEntryCount, valueTableNameIndex, name, length);
+}
+#else
 uint16_t cliGetSettingIndex(char *name, uint8_t length)
 {
     for (uint32_t i = 0; i < valueTableEntryCount; i++) {
@@ -4345,6 +4414,7 @@ uint16_t cliGetSettingIndex(char *name, uint8_t length)
     }
     return valueTableEntryCount;
 }
+#endif // USE_CLI_SETTING_NAME_INDEX
 
 STATIC_UNIT_TESTED void cliSet(char *cmdline)
 {
@@ -4661,6 +4731,33 @@ static void cliStatus(char *cmdline)
     cliPrintLinefeed();
 }
 
+#ifdef USE_LATENCY_TRACE
+static void cliLatency(char *cmdline)
+{
+    if (strcasecmp(cmdline, "reset") == 0) {
+        latencyTraceReset();
+        cliPrintLine("Latency statistics reset");
+
+        return;
+    }
+
+    latencyTraceStats_t stats;
+    latencyTraceGetStats(&stats);
+    if (stats.sampleCount == 0) {
+        cliPrintLine("No RX frames traced, the RX protocol must report frame times");
+
+        return;
+    }
+
+    cliPrintLinef("Stick to motor latency over %d frames", stats.sampleCount);
+    cliPrintLinef("min/us %d avg/us %d p99/us %d max/us %d", stats.minUs, stats.avgUs, stats.p99Us, stats.maxUs);
+    cliPrintLine("Stage          avg/us");
+    for (int i = 0; i < LATENCY_STAGE_COUNT; i++) {
+        cliPrintLinef("%-14s %6d", latencyStageNames[i], stats.stageAvgUs[i]);
+    }
+}
+#endif
+
 #if defined(USE_TASK_STATISTICS)
 static void cliTasks(char *cmdline)
 {
@@ -4788,6 +4885,8 @@ static void cliRcSmoothing(char *cmdline)
                 cliPrintLine("manual)");
             }
         }
+    } else if (rxConfig()->rc_smoothing_type == RC_SMOOTHING_TYPE_PREDICT) {
+        cliPrintLine("PREDICT");
     } else {
         cliPrintLine("INTERPOLATION");
     }
@@ -4913,6 +5012,7 @@ const cliResourceValue_t resourceTable[] = {
 #endif
 #ifdef USE_MAX7456
     DEFS( OWNER_OSD_CS,        PG_MAX7456_CONFIG, max7456Config_t, csTag ),
+    DEFS( OWNER_OSD_VSYNC,     PG_MAX7456_CONFIG, max7456Config_t, vsyncTag ),
 #endif
 #ifdef USE_RX_SPI
     DEFS( OWNER_RX_SPI_CS,     PG_RX_SPI_CONFIG, rxSpiConfig_t, csnTag ),
@@ -6271,6 +6371,9 @@ const clicmd_t cmdTable[] = {
     CLI_COMMAND_DEF("gyroregisters", "dump gyro config registers contents", NULL, cliDumpGyroRegisters),
 #endif
     CLI_COMMAND_DEF("help", "display command help", "[search string]", cliHelp),
+#ifdef USE_LATENCY_TRACE
+    CLI_COMMAND_DEF("latency", "show stick to motor latency", "[reset]", cliLatency),
+#endif
 #ifdef USE_LED_STRIP_STATUS_MODE
         CLI_COMMAND_DEF("led", "configure leds", NULL, cliLed),
 #endif
@@ -41,6 +41,8 @@ typedef enum {
 #ifdef USE_BLACKBOX
     TABLE_BLACKBOX_DEVICE,
     TABLE_BLACKBOX_MODE,
+    TABLE_BLACKBOX_PREDICTOR,
+    TABLE_BLACKBOX_ENCODING,
 #endif
     TABLE_CURRENT_METER,
     TABLE_VOLTAGE_METER,
@@ -232,6 +234,10 @@ extern const lookupTableEntry_t lookupTables[];
 extern const uint16_t valueTableEntryCount;
 
 extern const clivalue_t valueTable[];
+#ifdef USE_CLI_SETTING_NAME_INDEX
+// indices of valueTable sorted by name, built by the CLI
+extern uint16_t valueTableNameIndex[];
+#endif
 //extern const uint8_t lookupTablesEntryCount;
 
 extern const char * const lookupTableGyroHardware[];
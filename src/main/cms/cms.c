@@ -31,6 +31,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <ctype.h>
+#include <limits.h>
 
 #include "platform.h"
 
@@ -249,6 +250,30 @@ static uint8_t cmsCursorAbsolute(displayPort_t *instance)
 
 uint8_t runtimeEntryFlags[CMS_MAX_ROWS] = { 0 };
 
+#define CMS_DRAW_BUFFER_LEN 12
+
+// Last value drawn on each row of the page, writes of an unchanged value are skipped
+static char runtimeEntryValues[CMS_MAX_ROWS][CMS_DRAW_BUFFER_LEN + 2];
+
+// Characters left in the per update budget of the current display
+static int cmsCharBudget;
+
+#define CMS_TX_ROOM_MIN 30
+#define CMS_OUT_OF_ROOM(room) ((room) < CMS_TX_ROOM_MIN || cmsCharBudget <= 0)
+
+static int cmsDisplayWrite(displayPort_t *pDisplay, uint8_t x, uint8_t y, const char *text)
+{
+    cmsCharBudget -= strlen(text);
+    return displayWrite(pDisplay, x, y, DISPLAYPORT_ATTR_NONE, text);
+}
+
+static void cmsInvalidateEntryValues(void)
+{
+    for (unsigned i = 0; i < CMS_MAX_ROWS; i++) {
+        runtimeEntryValues[i][0] = '\0';
+    }
+}
+
 static void cmsPageSelect(displayPort_t *instance, int8_t newpage)
 {
     currentCtx.page = (newpage + pageCount) % pageCount;
@@ -352,24 +377,28 @@ static void cmsPadToSize(char *buf, int size)
 #endif
 }
 
-static int cmsDrawMenuItemValue(displayPort_t *pDisplay, char *buff, uint8_t row, uint8_t maxSize)
+static int cmsDrawMenuItemValue(displayPort_t *pDisplay, char *lastValue, char *buff, uint8_t row, uint8_t maxSize)
 {
     int colpos;
     int cnt;
 
     cmsPadToSize(buff, maxSize);
+    if (strncmp(lastValue, buff, CMS_DRAW_BUFFER_LEN + 2) == 0) {
+        return 0;
+    }
 #ifdef CMS_OSD_RIGHT_ALIGNED_VALUES
     colpos = rightMenuColumn - maxSize;
 #else
     colpos = smallScreen ? rightMenuColumn - maxSize : rightMenuColumn;
 #endif
-    cnt = displayWrite(pDisplay, colpos, row, DISPLAYPORT_ATTR_NONE, buff);
+    cnt = cmsDisplayWrite(pDisplay, colpos, row, buff);
+    strncpy(lastValue, buff, CMS_DRAW_BUFFER_LEN + 1);
+    lastValue[CMS_DRAW_BUFFER_LEN + 1] = '\0';
     return cnt;
 }
 
-static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t row, bool selectedRow, uint8_t *flags)
+static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t row, bool selectedRow, uint8_t *flags, char *lastValue)
 {
-    #define CMS_DRAW_BUFFER_LEN 12
     #define CMS_NUM_FIELD_LEN 5
     #define CMS_CURSOR_BLINK_DELAY_MS 500
 
@@ -388,7 +417,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
     case OME_String:
         if (IS_PRINTVALUE(*flags) && p->data) {
             strncpy(buff, p->data, CMS_DRAW_BUFFER_LEN);
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_DRAW_BUFFER_LEN);
+            cnt = cmsDrawMenuItemValue(pDisplay, lastValue, buff, row, CMS_DRAW_BUFFER_LEN);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -410,7 +439,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
             strncat(buff, ">", CMS_DRAW_BUFFER_LEN);
 
             row = smallScreen ? row - 1 : row;
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, strlen(buff));
+            cnt = cmsDrawMenuItemValue(pDisplay, lastValue, buff, row, strlen(buff));
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -423,7 +452,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
               strcpy(buff, "NO ");
             }
 
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, 3);
+            cnt = cmsDrawMenuItemValue(pDisplay, lastValue, buff, row, 3);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -433,7 +462,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
             OSD_TAB_t *ptr = p->data;
             char * str = (char *)ptr->names[*ptr->val];
             strncpy(buff, str, CMS_DRAW_BUFFER_LEN);
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_DRAW_BUFFER_LEN);
+            cnt = cmsDrawMenuItemValue(pDisplay, lastValue, buff, row, CMS_DRAW_BUFFER_LEN);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -458,7 +487,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
                     }
                 }
             }
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, 3);
+            cnt = cmsDrawMenuItemValue(pDisplay, lastValue, buff, row, 3);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -468,7 +497,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
         if (IS_PRINTVALUE(*flags) && p->data) {
             OSD_UINT8_t *ptr = p->data;
             itoa(*ptr->val, buff, 10);
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN);
+            cnt = cmsDrawMenuItemValue(pDisplay, lastValue, buff, row, CMS_NUM_FIELD_LEN);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -477,7 +506,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
         if (IS_PRINTVALUE(*flags) && p->data) {
             OSD_INT8_t *ptr = p->data;
             itoa(*ptr->val, buff, 10);
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN);
+            cnt = cmsDrawMenuItemValue(pDisplay, lastValue, buff, row, CMS_NUM_FIELD_LEN);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -486,7 +515,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
         if (IS_PRINTVALUE(*flags) && p->data) {
             OSD_UINT16_t *ptr = p->data;
             itoa(*ptr->val, buff, 10);
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN);
+            cnt = cmsDrawMenuItemValue(pDisplay, lastValue, buff, row, CMS_NUM_FIELD_LEN);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -495,7 +524,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
         if (IS_PRINTVALUE(*flags) && p->data) {
             OSD_UINT16_t *ptr = p->data;
             itoa(*ptr->val, buff, 10);
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN);
+            cnt = cmsDrawMenuItemValue(pDisplay, lastValue, buff, row, CMS_NUM_FIELD_LEN);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -504,7 +533,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
         if (IS_PRINTVALUE(*flags) && p->data) {
             OSD_FLOAT_t *ptr = p->data;
             cmsFormatFloat(*ptr->val * ptr->multipler, buff);
-            cnt = cmsDrawMenuItemValue(pDisplay, buff, row, CMS_NUM_FIELD_LEN);
+            cnt = cmsDrawMenuItemValue(pDisplay, lastValue, buff, row, CMS_NUM_FIELD_LEN);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -512,7 +541,7 @@ static int cmsDrawMenuEntry(displayPort_t *pDisplay, const OSD_Entry *p, uint8_t
     case OME_Label:
         if (IS_PRINTVALUE(*flags) && p->data) {
             // A label with optional string, immediately following text
-            cnt = displayWrite(pDisplay, leftMenuColumn + 1 + (uint8_t)strlen(p->text), row, DISPLAYPORT_ATTR_NONE, p->data);
+            cnt = cmsDisplayWrite(pDisplay, leftMenuColumn + 1 + (uint8_t)strlen(p->text), row, p->data);
             CLR_PRINTVALUE(*flags);
         }
         break;
@@ -613,12 +642,14 @@ static void cmsDrawMenu(displayPort_t *pDisplay, uint32_t currentTimeUs)
     }
 
     uint32_t room = displayTxBytesFree(pDisplay);
+    cmsCharBudget = pDisplay->maxCmsCharsPerUpdate ? pDisplay->maxCmsCharsPerUpdate : INT_MAX;
 
     if (pDisplay->cleared) {
         for (p = pageTop, i= 0; (p <= pageTop + pageMaxRow); p++, i++) {
             SET_PRINTLABEL(runtimeEntryFlags[i]);
             SET_PRINTVALUE(runtimeEntryFlags[i]);
         }
+        cmsInvalidateEntryValues();
         pDisplay->cleared = false;
     } else if (drawPolled) {
         for (p = pageTop, i = 0; (p <= pageTop + pageMaxRow); p++, i++) {
@@ -638,19 +669,19 @@ static void cmsDrawMenu(displayPort_t *pDisplay, uint32_t currentTimeUs)
 #endif
 
     if (pDisplay->cursorRow >= 0 && currentCtx.cursorRow != pDisplay->cursorRow) {
-        room -= displayWrite(pDisplay, leftMenuColumn, top + pDisplay->cursorRow * linesPerMenuItem, DISPLAYPORT_ATTR_NONE, " ");
+        room -= cmsDisplayWrite(pDisplay, leftMenuColumn, top + pDisplay->cursorRow * linesPerMenuItem, " ");
     }
 
-    if (room < 30) {
+    if (CMS_OUT_OF_ROOM(room)) {
         return;
     }
 
     if (pDisplay->cursorRow != currentCtx.cursorRow) {
-        room -= displayWrite(pDisplay, leftMenuColumn, top + currentCtx.cursorRow * linesPerMenuItem, DISPLAYPORT_ATTR_NONE, ">");
+        room -= cmsDisplayWrite(pDisplay, leftMenuColumn, top + currentCtx.cursorRow * linesPerMenuItem, ">");
         pDisplay->cursorRow = currentCtx.cursorRow;
     }
 
-    if (room < 30) {
+    if (CMS_OUT_OF_ROOM(room)) {
         return;
     }
 
@@ -668,22 +699,22 @@ static void cmsDrawMenu(displayPort_t *pDisplay, uint32_t currentTimeUs)
         if (IS_PRINTLABEL(runtimeEntryFlags[i])) {
             uint8_t coloff = leftMenuColumn;
             coloff += (p->type == OME_Label) ? 0 : 1;
-            room -= displayWrite(pDisplay, coloff, top + i * linesPerMenuItem, DISPLAYPORT_ATTR_NONE, p->text);
+            room -= cmsDisplayWrite(pDisplay, coloff, top + i * linesPerMenuItem, p->text);
             CLR_PRINTLABEL(runtimeEntryFlags[i]);
-            if (room < 30) {
+            if (CMS_OUT_OF_ROOM(room)) {
                 return;
             }
         }
 
     // Print values
 
-    // XXX Polled values at latter positions in the list may not be
-    // XXX printed if not enough room in the middle of the list.
+    // Values that are unchanged since they were last drawn are not written,
+    // so polled values only use the room when they change.
 
         if (IS_PRINTVALUE(runtimeEntryFlags[i])) {
             bool selectedRow = i == currentCtx.cursorRow;
-            room -= cmsDrawMenuEntry(pDisplay, p, top + i * linesPerMenuItem, selectedRow, &runtimeEntryFlags[i]);
-            if (room < 30)
+            room -= cmsDrawMenuEntry(pDisplay, p, top + i * linesPerMenuItem, selectedRow, &runtimeEntryFlags[i], runtimeEntryValues[i]);
+            if (CMS_OUT_OF_ROOM(room))
                 return;
         }
     }
@@ -27,62 +27,55 @@
 
 /*
  * Source below found here: http://www.kasperkamperman.com/blog/arduino/arduino-programming-hsb-to-rgb/
+ *
+ * Each 60 degree hue segment sets one channel to the value, one to the base and one to a level
+ * rising or falling between them. The divisions by 60 are done as a multiply and shift, which is
+ * exact for the whole range of (val - base) * 60.
  */
 
+#define DIV_BY_60(x) (((uint32_t)(x) * 17477) >> 20)
+
+enum { HSV_LEVEL_VAL, HSV_LEVEL_BASE, HSV_LEVEL_RISING, HSV_LEVEL_FALLING };
+
+// the levels of the red, green and blue channels in each hue segment
+static const uint8_t hsvSegmentLevels[6][3] = {
+    { HSV_LEVEL_VAL,     HSV_LEVEL_RISING,  HSV_LEVEL_BASE    },
+    { HSV_LEVEL_FALLING, HSV_LEVEL_VAL,     HSV_LEVEL_BASE    },
+    { HSV_LEVEL_BASE,    HSV_LEVEL_VAL,     HSV_LEVEL_RISING  },
+    { HSV_LEVEL_BASE,    HSV_LEVEL_FALLING, HSV_LEVEL_VAL     },
+    { HSV_LEVEL_RISING,  HSV_LEVEL_BASE,    HSV_LEVEL_VAL     },
+    { HSV_LEVEL_VAL,     HSV_LEVEL_BASE,    HSV_LEVEL_FALLING },
+};
+
 rgbColor24bpp_t* hsvToRgb24(const hsvColor_t* c)
 {
     static rgbColor24bpp_t r;
 
-    uint16_t val = c->v;
-    uint16_t sat = 255 - c->s;
-    uint32_t base;
-    uint16_t hue = c->h;
+    const uint32_t val = c->v;
 
-    if (sat == 0) { // Acromatic color (gray). Hue doesn't mind.
+    if (c->s == 255) {
+        // Achromatic colour (grey), hue doesn't matter
         r.rgb.r = val;
         r.rgb.g = val;
         r.rgb.b = val;
-    } else {
 
-        base = ((255 - sat) * val) >> 8;
-
-        switch (hue / 60) {
-            case 0:
-            r.rgb.r = val;
-            r.rgb.g = (((val - base) * hue) / 60) + base;
-            r.rgb.b = base;
-            break;
-            case 1:
-            r.rgb.r = (((val - base) * (60 - (hue % 60))) / 60) + base;
-            r.rgb.g = val;
-            r.rgb.b = base;
-            break;
-
-            case 2:
-            r.rgb.r = base;
-            r.rgb.g = val;
-            r.rgb.b = (((val - base) * (hue % 60)) / 60) + base;
-            break;
+        return &r;
+    }
 
-            case 3:
-            r.rgb.r = base;
-            r.rgb.g = (((val - base) * (60 - (hue % 60))) / 60) + base;
-            r.rgb.b = val;
-            break;
+    const uint32_t base = (c->s * val) >> 8;
+    const uint32_t segment = DIV_BY_60(c->h);
+    const uint32_t offset = c->h - segment * 60;
 
-            case 4:
-            r.rgb.r = (((val - base) * (hue % 60)) / 60) + base;
-            r.rgb.g = base;
-            r.rgb.b = val;
-            break;
+    uint8_t levels[4];
+    levels[HSV_LEVEL_VAL] = val;
+    levels[HSV_LEVEL_BASE] = base;
+    levels[HSV_LEVEL_RISING] = DIV_BY_60((val - base) * offset) + base;
+    levels[HSV_LEVEL_FALLING] = DIV_BY_60((val - base) * (60 - offset)) + base;
 
-            case 5:
-            r.rgb.r = val;
-            r.rgb.g = base;
-            r.rgb.b = (((val - base) * (60 - (hue % 60))) / 60) + base;
-            break;
+    const uint8_t *segmentLevels = hsvSegmentLevels[segment % 6];
+    r.rgb.r = levels[segmentLevels[0]];
+    r.rgb.g = levels[segmentLevels[1]];
+    r.rgb.b = levels[segmentLevels[2]];
 
-        }
-    }
     return &r;
 }
@@ -0,0 +1,137 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_LZ
+
+#include "lz.h"
+
+#define LZ_HASH_BITS        6
+#define LZ_HASH_SIZE        (1 << LZ_HASH_BITS)
+#define LZ_NO_POSITION      0xFFFF
+#define LZ_NIBBLE_MAX       15
+
+static unsigned lzHash(const uint8_t *pos)
+{
+    const uint32_t value = pos[0] | (pos[1] << 8) | (pos[2] << 16) | ((uint32_t)pos[3] << 24);
+    return (value * 3266489917U) >> (32 - LZ_HASH_BITS);
+}
+
+static uint8_t *lzWriteExtraLength(uint8_t *out, int length)
+{
+    while (length >= 255) {
+        *out++ = 255;
+        length -= 255;
+    }
+    *out++ = length;
+    return out;
+}
+
+static uint8_t *lzWriteSequence(uint8_t *out, const uint8_t *literals, int literalCount, int offset, int matchLength)
+{
+    uint8_t *token = out++;
+
+    if (literalCount >= LZ_NIBBLE_MAX) {
+        *token = LZ_NIBBLE_MAX << 4;
+        out = lzWriteExtraLength(out, literalCount - LZ_NIBBLE_MAX);
+    } else {
+        *token = literalCount << 4;
+    }
+    memcpy(out, literals, literalCount);
+    out += literalCount;
+
+    if (matchLength) {
+        const int matchCode = matchLength - LZ_MIN_MATCH + 1;
+        *out++ = offset;
+        if (matchCode >= LZ_NIBBLE_MAX) {
+            *token |= LZ_NIBBLE_MAX;
+            out = lzWriteExtraLength(out, matchCode - LZ_NIBBLE_MAX);
+        } else {
+            *token |= matchCode;
+        }
+    }
+
+    return out;
+}
+
+/*
+ * Compresses one block of up to LZ_MAX_BLOCK_SIZE bytes and appends it to the output.
+ * The caller must leave room for inLen + LZ_BLOCK_OVERHEAD bytes, which is the size of
+ * an incompressible block; a sequence containing a match is never longer than its input.
+ */
+int lzEncodeBufStreaming(lzState_t *state, const uint8_t *inBuf, int inLen)
+{
+    if (inLen > LZ_MAX_BLOCK_SIZE || state->bytesWritten + inLen + LZ_BLOCK_OVERHEAD > state->outBufLen) {
+        return -1;
+    }
+
+    uint16_t hashTable[LZ_HASH_SIZE];
+    memset(hashTable, 0xFF, sizeof(hashTable));
+
+    uint8_t *out = state->outByte;
+    const uint8_t *end = inBuf + inLen;
+    const int matchStartLimit = inLen - LZ_MIN_MATCH;
+    const uint8_t *literals = inBuf;
+    const uint8_t *pos = inBuf;
+
+    while (pos - inBuf <= matchStartLimit) {
+        const unsigned hash = lzHash(pos);
+        const uint16_t candidate = hashTable[hash];
+        hashTable[hash] = pos - inBuf;
+
+        if (candidate == LZ_NO_POSITION || memcmp(inBuf + candidate, pos, LZ_MIN_MATCH) != 0) {
+            ++pos;
+            continue;
+        }
+
+        // extend the match, it may overlap the current position which the decoder handles by copying forwards
+        const uint8_t *ref = inBuf + candidate;
+        int matchLength = LZ_MIN_MATCH;
+        while (pos + matchLength < end && ref[matchLength] == pos[matchLength]) {
+            ++matchLength;
+        }
+
+        out = lzWriteSequence(out, literals, pos - literals, pos - ref, matchLength);
+
+        // index the positions covered by the match so that following repeats can find them
+        const uint8_t *matchEnd = pos + matchLength;
+        for (++pos; pos < matchEnd && pos - inBuf <= matchStartLimit; ++pos) {
+            hashTable[lzHash(pos)] = pos - inBuf;
+        }
+        pos = matchEnd;
+        literals = pos;
+    }
+
+    if (literals < end) {
+        out = lzWriteSequence(out, literals, end - literals, 0, 0);
+    }
+
+    state->bytesWritten += out - state->outByte;
+    state->outByte = out;
+
+    return 0;
+}
+
+#endif
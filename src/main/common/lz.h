@@ -0,0 +1,61 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Byte aligned LZ77 codec, similar to an LZ4 block.
+ *
+ * The stream is a sequence of:
+ *   token     - high nibble literal count, low nibble match length code
+ *   [length]  - extra literal count bytes if the literal nibble is 15
+ *   literals
+ *   [offset]  - one byte distance back into the output, present if match code != 0
+ *   [length]  - extra match length bytes if the match code is 15
+ *
+ * A match code of 0 means the sequence has no match, otherwise the match length
+ * is (code - 1 + LZ_MIN_MATCH). Extra length bytes are added to the nibble value,
+ * a byte of 255 means another length byte follows.
+ *
+ * Matches never reach further back than the start of the block being encoded,
+ * so each block is at most LZ_MAX_BLOCK_SIZE bytes and can be decoded using only
+ * the output produced so far.
+ */
+
+#define LZ_MIN_MATCH        4
+#define LZ_MAX_BLOCK_SIZE   256
+// worst case expansion of a block: one token plus one extended literal length byte
+#define LZ_BLOCK_OVERHEAD   2
+
+typedef struct lzState_s {
+    uint16_t    bytesWritten;
+    uint8_t     *outByte;
+    uint16_t    outBufLen;
+} lzState_t;
+
+struct lzInfo_s {
+    uint16_t uncompressedByteCount;
+};
+
+#define LZ_INFO_SIZE sizeof(struct lzInfo_s)
+
+int lzEncodeBufStreaming(lzState_t *state, const uint8_t *inBuf, int inLen);
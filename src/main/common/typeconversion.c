@@ -18,6 +18,7 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <math.h>
@@ -289,3 +290,129 @@ float fastA2F(const char *p)
     // Return signed and scaled floating point result.
     return sign * (frac ? (value / scale) : (value * scale));
 }
+
+/*
+ * Integer formatters for the OSD and other displays.
+ *
+ * These avoid interpreting a format string on every call, digits are emitted
+ * two at a time from a lookup table. Each formatter writes a NUL terminated
+ * string and returns a pointer to the terminator, so calls can be chained.
+ */
+
+#define FORMAT_DIGITS_MAX 10
+
+static const char digitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint32_t powersOfTen[FORMAT_DIGITS_MAX] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// Writes the digits of value backwards from end, with at least minDigits digits, returns the count
+static int formatDigits(char *end, uint32_t value, int minDigits)
+{
+    char *p = end;
+
+    while (value >= 100) {
+        const unsigned pair = (value % 100) * 2;
+        value /= 100;
+        *--p = digitPairs[pair + 1];
+        *--p = digitPairs[pair];
+    }
+    if (value >= 10) {
+        *--p = digitPairs[value * 2 + 1];
+        *--p = digitPairs[value * 2];
+    } else {
+        *--p = '0' + value;
+    }
+    while (end - p < minDigits) {
+        *--p = '0';
+    }
+
+    return end - p;
+}
+
+static char *formatPadded(char *buf, const char *text, int length, bool negative, int width, char pad)
+{
+    int padding = width - length - negative;
+
+    if (negative && pad == '0') {
+        // tfp_sprintf pads in front of the sign, keep its output
+        while (padding-- > 0) {
+            *buf++ = pad;
+        }
+        *buf++ = '-';
+    } else {
+        while (padding-- > 0) {
+            *buf++ = pad;
+        }
+        if (negative) {
+            *buf++ = '-';
+        }
+    }
+    memcpy(buf, text, length);
+    buf += length;
+    *buf = '\0';
+
+    return buf;
+}
+
+// Same as tfp_sprintf("%u"), or "%0<width>u" when pad is '0'
+char *formatUnsigned(char *buf, uint32_t value, uint8_t width, char pad)
+{
+    char digits[FORMAT_DIGITS_MAX];
+    const int length = formatDigits(digits + FORMAT_DIGITS_MAX, value, 1);
+
+    return formatPadded(buf, digits + FORMAT_DIGITS_MAX - length, length, false, width, pad);
+}
+
+// Same as tfp_sprintf("%<width>d")
+char *formatSigned(char *buf, int32_t value, uint8_t width)
+{
+    char digits[FORMAT_DIGITS_MAX];
+    const uint32_t magnitude = value < 0 ? -(uint32_t)value : (uint32_t)value;
+    const int length = formatDigits(digits + FORMAT_DIGITS_MAX, magnitude, 1);
+
+    return formatPadded(buf, digits + FORMAT_DIGITS_MAX - length, length, value < 0, width, ' ');
+}
+
+// Formats value / 10^decimals with all the decimals, eg 1234 with 2 decimals is "12.34",
+// space padded to width characters in total
+char *formatFixedPoint(char *buf, int32_t value, uint8_t decimals, uint8_t width)
+{
+    char digits[2 * FORMAT_DIGITS_MAX + 1];
+    char *end = digits + sizeof(digits);
+    const uint32_t magnitude = value < 0 ? -(uint32_t)value : (uint32_t)value;
+
+    if (decimals >= FORMAT_DIGITS_MAX) {
+        decimals = FORMAT_DIGITS_MAX - 1;
+    }
+
+    int length = 0;
+    if (decimals) {
+        length = formatDigits(end, magnitude % powersOfTen[decimals], decimals);
+        digits[sizeof(digits) - length - 1] = '.';
+        length++;
+    }
+    length += formatDigits(end - length, magnitude / powersOfTen[decimals], 1);
+
+    return formatPadded(buf, end - length, length, value < 0, width, ' ');
+}
+
+// Same as tfp_sprintf("%02d:%02d", seconds / 60, seconds % 60)
+char *formatMinutesSeconds(char *buf, uint32_t seconds)
+{
+    buf = formatUnsigned(buf, seconds / 60, 2, '0');
+    *buf++ = ':';
+
+    return formatUnsigned(buf, seconds % 60, 2, '0');
+}
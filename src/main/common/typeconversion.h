@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #define FTOA_BUFFER_LENGTH 11
 
 void uli2a(unsigned long int num, unsigned int base, int uc, char *bf);
@@ -30,6 +32,11 @@ char a2i(char ch, const char **src, int base, int *nump);
 char *ftoa(float x, char *floatString);
 float fastA2F(const char *p);
 
+char *formatUnsigned(char *buf, uint32_t value, uint8_t width, char pad);
+char *formatSigned(char *buf, int32_t value, uint8_t width);
+char *formatFixedPoint(char *buf, int32_t value, uint8_t decimals, uint8_t width);
+char *formatMinutesSeconds(char *buf, uint32_t seconds);
+
 #ifndef HAVE_ITOA_FUNCTION
 char *itoa(int i, char *a, int r);
 #endif
@@ -728,14 +728,6 @@ bool resetEEPROM(bool useCustomDefaults)
     return true;
 }
 
-void ensureEEPROMStructureIsValid(void)
-{
-    if (isEEPROMStructureValid()) {
-        return;
-    }
-    resetEEPROM(false);
-}
-
 void saveConfigAndNotify(void)
 {
     writeEEPROM();
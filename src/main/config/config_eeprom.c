@@ -41,7 +41,15 @@
 #include "drivers/flash.h"
 #include "drivers/system.h"
 
+#if !defined(CONFIG_IN_EXTERNAL_FLASH)
+// Changed PGs are appended to the stored config as updates, the config is only rewritten in full when there is no room left.
+// This needs unused space to read as erased flash that can be written without erasing it first.
+#define CONFIG_APPEND_UPDATES
+#endif
+
 static uint16_t eepromConfigSize;
+static uint16_t eepromAppendOffset;     // where the next update can be appended
+static uint8_t eepromUpdateSequence;    // sequence number of the last update, 0 if there is none
 
 typedef enum {
     CR_CLASSICATION_SYSTEM   = 0,
@@ -71,12 +79,28 @@ typedef struct {
     uint8_t pg[];
 } PG_PACKED configRecord_t;
 
+// Header for an update appended to the saved copy. It is followed by the changed PGs, a footer and a checksum.
+typedef struct {
+    uint8_t magic_c5;           // magic number, should be 0xC5
+    uint8_t sequence;           // number of updates since the saved copy was written in full, starting at 1
+} PG_PACKED configUpdateHeader_t;
+
 // Footer for the saved copy.
 typedef struct {
     uint16_t terminator;
 } PG_PACKED configFooter_t;
 // checksum is appended just after footer. It is not included in footer to make checksum calculation consistent
 
+// Offsets of the stored records from the start of the config, hashed by PGN.
+#define CONFIG_RECORD_INDEX_SIZE    128 // must be a power of 2
+#define CONFIG_RECORD_INDEX_EMPTY   0   // the header is at offset 0, so no record can be
+
+typedef struct {
+    uint16_t offset[CONFIG_RECORD_INDEX_SIZE];
+    pgn_t pgn;                  // if not 0, only the records of this PG are indexed
+    bool complete;              // false if some records did not fit in the index
+} configRecordIndex_t;
+
 // Used to check the compiler packing at build time.
 typedef struct {
     uint8_t byte;
@@ -281,20 +305,51 @@ bool isEEPROMVersionValid(void)
     return true;
 }
 
-// Scan the EEPROM config. Returns true if the config is valid.
-bool isEEPROMStructureValid(void)
+static void initEEPROMRecordIndex(configRecordIndex_t *index, pgn_t pgn)
 {
-    const uint8_t *p = &__config_start;
-    const configHeader_t *header = (const configHeader_t *)p;
+    memset(index, 0, sizeof(*index));
+    index->pgn = pgn;
+    index->complete = true;
+}
 
-    if (header->magic_be != 0xBE) {
-        return false;
+static bool isSameEEPROMRecord(const configRecord_t *a, const configRecord_t *b)
+{
+    return a->pgn == b->pgn
+        && (a->flags & CR_CLASSIFICATION_MASK) == (b->flags & CR_CLASSIFICATION_MASK);
+}
+
+// Add a record to the index, replacing an earlier record of the same PG
+static void indexEEPROMRecord(configRecordIndex_t *index, const configRecord_t *record)
+{
+    if (index->pgn && index->pgn != record->pgn) {
+        return;
     }
 
-    uint16_t crc = CRC_START_VALUE;
-    crc = crc16_ccitt_update(crc, header, sizeof(*header));
-    p += sizeof(*header);
+    for (unsigned i = 0; i < CONFIG_RECORD_INDEX_SIZE; i++) {
+        const unsigned slot = (record->pgn + i) & (CONFIG_RECORD_INDEX_SIZE - 1);
+        const uint16_t offset = index->offset[slot];
+        if (offset == CONFIG_RECORD_INDEX_EMPTY
+            || isSameEEPROMRecord((const configRecord_t *)(&__config_start + offset), record)) {
+            index->offset[slot] = (const uint8_t *)record - &__config_start;
+            return;
+        }
+    }
+    // index is full, lookups of records that are not in it have to scan the EEPROM
+    index->complete = false;
+}
+
+static void indexEEPROMRecords(configRecordIndex_t *index, const uint8_t *p)
+{
+    for (const configRecord_t *record = (const configRecord_t *)p; record->size != 0; record = (const configRecord_t *)p) {
+        indexEEPROMRecord(index, record);
+        p += record->size;
+    }
+}
 
+// Scan a list of records up to the footer and the CRC following it, crc is the CRC of the preceding header.
+// Returns a pointer past the CRC, or NULL if the records are not valid.
+static const uint8_t *scanEEPROMRecords(const uint8_t *p, uint16_t crc)
+{
     for (;;) {
         const configRecord_t *record = (const configRecord_t *)p;
 
@@ -305,7 +360,7 @@ bool isEEPROMStructureValid(void)
         if (p + record->size >= &__config_end
             || record->size < sizeof(*record)) {
             // Too big or too small.
-            return false;
+            return NULL;
         }
 
         crc = crc16_ccitt_update(crc, p, record->size);
@@ -320,12 +375,79 @@ bool isEEPROMStructureValid(void)
     // include stored CRC in the CRC calculation
     const uint16_t *storedCrc = (const uint16_t *)p;
     crc = crc16_ccitt_update(crc, storedCrc, sizeof(*storedCrc));
-    p += sizeof(storedCrc);
+    p += sizeof(*storedCrc);
+
+    // CRC has the property that if the CRC itself is included in the calculation the resulting CRC will have constant value
+    return crc == CRC_CHECK_VALUE ? p : NULL;
+}
+
+// Updates start at a write boundary, skipping the zero padding before them
+static const uint8_t *skipEEPROMPadding(const uint8_t *p)
+{
+    static const uint8_t padding[CONFIG_STREAMER_BUFFER_SIZE] = { 0 };
+
+    const uint16_t offset = p - &__config_start;
+    p = &__config_start + (offset + CONFIG_STREAMER_BUFFER_SIZE - 1) / CONFIG_STREAMER_BUFFER_SIZE * CONFIG_STREAMER_BUFFER_SIZE;
+    while (p + CONFIG_STREAMER_BUFFER_SIZE <= &__config_end && memcmp(p, padding, CONFIG_STREAMER_BUFFER_SIZE) == 0) {
+        p += CONFIG_STREAMER_BUFFER_SIZE;
+    }
+    return p;
+}
+
+// Scan the EEPROM config, the saved copy followed by the updates appended to it. Returns true if the config is valid.
+// If an index is given, the latest record of each PG is added to it in the same pass.
+static bool scanEEPROM(configRecordIndex_t *index)
+{
+    const uint8_t *p = &__config_start;
+    const configHeader_t *header = (const configHeader_t *)p;
+
+    if (header->magic_be != 0xBE) {
+        return false;
+    }
+
+    const uint8_t *records = p + sizeof(*header);
+    p = scanEEPROMRecords(records, crc16_ccitt_update(CRC_START_VALUE, header, sizeof(*header)));
+    if (!p) {
+        return false;
+    }
+    if (index) {
+        indexEEPROMRecords(index, records);
+    }
+
+    // an update that is not valid, e.g. because power was lost while it was written, ends the config
+    eepromUpdateSequence = 0;
+    for (;;) {
+        const uint8_t *update = skipEEPROMPadding(p);
+        eepromAppendOffset = update - &__config_start;
+
+        const configUpdateHeader_t *updateHeader = (const configUpdateHeader_t *)update;
+        if (update + sizeof(*updateHeader) >= &__config_end
+            || updateHeader->magic_c5 != 0xC5
+            || updateHeader->sequence != eepromUpdateSequence + 1) {
+            break;
+        }
+
+        records = update + sizeof(*updateHeader);
+        const uint8_t *updateEnd = scanEEPROMRecords(records, crc16_ccitt_update(CRC_START_VALUE, updateHeader, sizeof(*updateHeader)));
+        if (!updateEnd) {
+            break;
+        }
+        if (index) {
+            indexEEPROMRecords(index, records);
+        }
+
+        eepromUpdateSequence = updateHeader->sequence;
+        p = updateEnd;
+    }
 
     eepromConfigSize = p - &__config_start;
 
-    // CRC has the property that if the CRC itself is included in the calculation the resulting CRC will have constant value
-    return crc == CRC_CHECK_VALUE;
+    return true;
+}
+
+bool isEEPROMStructureValid(void)
+{
+    return scanEEPROM(NULL);
 }
 
 uint16_t getEEPROMConfigSize(void)
@@ -347,37 +469,53 @@ size_t getEEPROMStorageSize(void)
 #endif
 }
 
-// find config record for reg + classification (profile info) in EEPROM
-// return NULL when record is not found
-// this function assumes that EEPROM content is valid
-static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFlags_e classification)
+static const configRecord_t *lookupEEPROMRecord(const configRecordIndex_t *index, const pgRegistry_t *reg, configRecordFlags_e classification)
 {
-    const uint8_t *p = &__config_start;
-    p += sizeof(configHeader_t);             // skip header
-    while (true) {
-        const configRecord_t *record = (const configRecord_t *)p;
-        if (record->size == 0
-            || p + record->size >= &__config_end
-            || record->size < sizeof(*record))
+    for (unsigned i = 0; i < CONFIG_RECORD_INDEX_SIZE; i++) {
+        const uint16_t offset = index->offset[(pgN(reg) + i) & (CONFIG_RECORD_INDEX_SIZE - 1)];
+        if (offset == CONFIG_RECORD_INDEX_EMPTY) {
             break;
+        }
+        const configRecord_t *record = (const configRecord_t *)(&__config_start + offset);
         if (pgN(reg) == record->pgn
-            && (record->flags & CR_CLASSIFICATION_MASK) == classification)
+            && (record->flags & CR_CLASSIFICATION_MASK) == classification) {
             return record;
-        p += record->size;
+        }
     }
     // record not found
     return NULL;
 }
 
+// find config record for reg + classification (profile info) in EEPROM
+// return NULL when record is not found
+// this function assumes that EEPROM content is valid
+static const configRecord_t *findEEPROM(const configRecordIndex_t *index, const pgRegistry_t *reg, configRecordFlags_e classification)
+{
+    const configRecord_t *record = lookupEEPROMRecord(index, reg, classification);
+    if (record || index->complete) {
+        return record;
+    }
+
+    // the record may not have fitted in the index, scan the EEPROM again only indexing this PG
+    configRecordIndex_t pgIndex;
+    initEEPROMRecordIndex(&pgIndex, pgN(reg));
+    scanEEPROM(&pgIndex);
+    return lookupEEPROMRecord(&pgIndex, reg, classification);
+}
+
 // Initialize all PG records from EEPROM.
-// This functions processes all PGs sequentially, scanning EEPROM for each one. This is suboptimal,
-//   but each PG is loaded/initialized exactly once and in defined order.
+// The EEPROM is scanned once, checking its structure and CRC while building an index of the stored records.
+// Each PG is then loaded/initialized exactly once and in defined order. If the EEPROM is not valid, all PGs are reset.
 bool loadEEPROM(void)
 {
-    bool success = true;
+    configRecordIndex_t index;
+    initEEPROMRecordIndex(&index, 0);
+
+    const bool structureValid = scanEEPROM(&index);
+    bool success = structureValid;
 
     PG_FOREACH(reg) {
-        const configRecord_t *rec = findEEPROM(reg, CR_CLASSICATION_SYSTEM);
+        const configRecord_t *rec = structureValid ? findEEPROM(&index, reg, CR_CLASSICATION_SYSTEM) : NULL;
         if (rec) {
             // config from EEPROM is available, use it to initialize PG. pgLoad will handle version mismatch
             if (!pgLoad(reg, rec->pg, rec->size - offsetof(configRecord_t, pg), rec->version)) {
@@ -393,6 +531,50 @@ bool loadEEPROM(void)
     return success;
 }
 
+static uint16_t writeEEPROMRecord(config_streamer_t *streamer, const pgRegistry_t *reg, uint16_t crc)
+{
+    const uint16_t regSize = pgSize(reg);
+    configRecord_t record = {
+        .size = sizeof(configRecord_t) + regSize,
+        .pgn = pgN(reg),
+        .version = pgVersion(reg),
+        .flags = 0
+    };
+
+    record.flags |= CR_CLASSICATION_SYSTEM;
+    config_streamer_write(streamer, (uint8_t *)&record, sizeof(record));
+    crc = crc16_ccitt_update(crc, (uint8_t *)&record, sizeof(record));
+    config_streamer_write(streamer, reg->address, regSize);
+    crc = crc16_ccitt_update(crc, reg->address, regSize);
+
+    return crc;
+}
+
+static void writeEEPROMFooter(config_streamer_t *streamer, uint16_t crc)
+{
+    configFooter_t footer = {
+        .terminator = 0,
+    };
+
+    config_streamer_write(streamer, (uint8_t *)&footer, sizeof(footer));
+    crc = crc16_ccitt_update(crc, (uint8_t *)&footer, sizeof(footer));
+
+    // include inverted CRC in big endian format in the CRC
+    const uint16_t invertedBigEndianCrc = ~(((crc & 0xFF) << 8) | (crc >> 8));
+    config_streamer_write(streamer, (uint8_t *)&invertedBigEndianCrc, sizeof(crc));
+
+    config_streamer_flush(streamer);
+
+#ifdef CONFIG_APPEND_UPDATES
+    // The space after the config must read as erased. If the config ends on a page boundary the next page
+    // may still hold old updates, writing padding to it erases it.
+    if (streamer->address % FLASH_PAGE_SIZE == 0 && streamer->address < (uintptr_t)&__config_end) {
+        const uint8_t padding[CONFIG_STREAMER_BUFFER_SIZE] = { 0 };
+        config_streamer_write(streamer, padding, sizeof(padding));
+    }
+#endif
+}
+
 static bool writeSettingsToEEPROM(void)
 {
     config_streamer_t streamer;
@@ -409,42 +591,115 @@ static bool writeSettingsToEEPROM(void)
     uint16_t crc = CRC_START_VALUE;
     crc = crc16_ccitt_update(crc, (uint8_t *)&header, sizeof(header));
     PG_FOREACH(reg) {
-        const uint16_t regSize = pgSize(reg);
-        configRecord_t record = {
-            .size = sizeof(configRecord_t) + regSize,
-            .pgn = pgN(reg),
-            .version = pgVersion(reg),
-            .flags = 0
-        };
+        crc = writeEEPROMRecord(&streamer, reg, crc);
+    }
+
+    writeEEPROMFooter(&streamer, crc);
+
+    const bool success = config_streamer_finish(&streamer) == 0;
+
+    return success;
+}
+
+#ifdef CONFIG_APPEND_UPDATES
+static bool isPGSaved(const configRecordIndex_t *index, const pgRegistry_t *reg)
+{
+    const configRecord_t *rec = findEEPROM(index, reg, CR_CLASSICATION_SYSTEM);
+
+    return rec
+        && rec->version == pgVersion(reg)
+        && rec->size == sizeof(configRecord_t) + pgSize(reg)
+        && memcmp(rec->pg, reg->address, pgSize(reg)) == 0;
+}
+
+static bool isEEPROMErased(uint16_t offset, uint16_t size)
+{
+    if (offset + size > &__config_end - &__config_start) {
+        return false;
+    }
+    for (const uint8_t *p = &__config_start + offset; p < &__config_start + offset + size; p++) {
+        if (*p != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Append the PGs that differ from the saved config as an update, without erasing the flash.
+// Returns false if this is not possible and the config has to be written in full.
+static bool appendSettingsToEEPROM(void)
+{
+    configRecordIndex_t index;
+    initEEPROMRecordIndex(&index, 0);
+
+    if (!scanEEPROM(&index) || !isEEPROMVersionValid() || eepromUpdateSequence == UINT8_MAX) {
+        return false;
+    }
+
+    uint16_t updateSize = sizeof(configUpdateHeader_t) + sizeof(configFooter_t) + sizeof(uint16_t);
+    bool changed = false;
+    PG_FOREACH(reg) {
+        if (!isPGSaved(&index, reg)) {
+            updateSize += sizeof(configRecord_t) + pgSize(reg);
+            changed = true;
+        }
+    }
 
-        record.flags |= CR_CLASSICATION_SYSTEM;
-        config_streamer_write(&streamer, (uint8_t *)&record, sizeof(record));
-        crc = crc16_ccitt_update(crc, (uint8_t *)&record, sizeof(record));
-        config_streamer_write(&streamer, reg->address, regSize);
-        crc = crc16_ccitt_update(crc, reg->address, regSize);
+    if (!changed) {
+        return true;
     }
 
-    configFooter_t footer = {
-        .terminator = 0,
+    // the update is padded to a whole write, and must be followed by erased space so it cannot run into old data
+    updateSize = (updateSize + CONFIG_STREAMER_BUFFER_SIZE - 1) / CONFIG_STREAMER_BUFFER_SIZE * CONFIG_STREAMER_BUFFER_SIZE;
+    if (!isEEPROMErased(eepromAppendOffset, updateSize + CONFIG_STREAMER_BUFFER_SIZE)) {
+        return false;
+    }
+
+    config_streamer_t streamer;
+    config_streamer_init(&streamer);
+
+    config_streamer_start(&streamer, (uintptr_t)&__config_start + eepromAppendOffset, &__config_end - &__config_start - eepromAppendOffset);
+
+    const uint8_t sequence = eepromUpdateSequence + 1;
+    configUpdateHeader_t header = {
+        .magic_c5 =             0xC5,
+        .sequence =             sequence,
     };
 
-    config_streamer_write(&streamer, (uint8_t *)&footer, sizeof(footer));
-    crc = crc16_ccitt_update(crc, (uint8_t *)&footer, sizeof(footer));
+    config_streamer_write(&streamer, (uint8_t *)&header, sizeof(header));
+    uint16_t crc = CRC_START_VALUE;
+    crc = crc16_ccitt_update(crc, (uint8_t *)&header, sizeof(header));
+    PG_FOREACH(reg) {
+        if (!isPGSaved(&index, reg)) {
+            crc = writeEEPROMRecord(&streamer, reg, crc);
+        }
+    }
 
-    // include inverted CRC in big endian format in the CRC
-    const uint16_t invertedBigEndianCrc = ~(((crc & 0xFF) << 8) | (crc >> 8));
-    config_streamer_write(&streamer, (uint8_t *)&invertedBigEndianCrc, sizeof(crc));
+    writeEEPROMFooter(&streamer, crc);
 
-    config_streamer_flush(&streamer);
+    if (config_streamer_finish(&streamer) != 0) {
+        return false;
+    }
 
-    const bool success = config_streamer_finish(&streamer) == 0;
+#ifdef CONFIG_IN_SDCARD
+    // copy it back from the SD card to the in-memory buffer.
+    if (!loadEEPROMFromSDCard()) {
+        return false;
+    }
+#endif
 
-    return success;
+    // check the update was stored
+    return scanEEPROM(NULL) && eepromUpdateSequence == sequence;
 }
+#endif
 
 void writeConfigToEEPROM(void)
 {
     bool success = false;
+#ifdef CONFIG_APPEND_UPDATES
+    // append only the PGs that changed if possible, avoiding the flash erase and full rewrite
+    success = appendSettingsToEEPROM();
+#endif
     // write it
     for (int attempt = 0; attempt < 3 && !success; attempt++) {
         if (writeSettingsToEEPROM()) {
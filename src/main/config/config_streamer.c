@@ -30,6 +30,9 @@
 #if !defined(CONFIG_IN_FLASH)
 #if defined(CONFIG_IN_RAM) && defined(PERSISTENT)
 PERSISTENT uint8_t eepromData[EEPROM_SIZE];
+#elif defined(CONFIG_IN_FILE)
+// the file is erased in pages like the embedded flash
+uint8_t eepromData[EEPROM_SIZE] __attribute__((aligned(FLASH_PAGE_SIZE)));
 #else
 uint8_t eepromData[EEPROM_SIZE];
 #endif
@@ -39,50 +42,6 @@ uint8_t eepromData[EEPROM_SIZE];
 #if defined(STM32H750xx) && !(defined(CONFIG_IN_EXTERNAL_FLASH) || defined(CONFIG_IN_RAM) || defined(CONFIG_IN_SDCARD))
 #error "STM32750xx only has one flash page which contains the bootloader, no spare flash pages available, use external storage for persistent config or ram for target testing"
 #endif
-// @todo this is not strictly correct for F4/F7, where sector sizes are variable
-#if !defined(FLASH_PAGE_SIZE)
-// F1
-# if defined(STM32F10X_MD)
-#  define FLASH_PAGE_SIZE                 (0x400)
-# elif defined(STM32F10X_HD)
-#  define FLASH_PAGE_SIZE                 (0x800)
-// F3
-# elif defined(STM32F303xC)
-#  define FLASH_PAGE_SIZE                 (0x800)
-// F4
-# elif defined(STM32F40_41xxx)
-#  define FLASH_PAGE_SIZE                 ((uint32_t)0x4000) // 16K sectors
-# elif defined (STM32F411xE)
-#  define FLASH_PAGE_SIZE                 ((uint32_t)0x4000)
-# elif defined(STM32F427_437xx)
-#  define FLASH_PAGE_SIZE                 ((uint32_t)0x4000)
-# elif defined (STM32F446xx)
-#  define FLASH_PAGE_SIZE                 ((uint32_t)0x4000)
-// F7
-#elif defined(STM32F722xx)
-#  define FLASH_PAGE_SIZE                 ((uint32_t)0x4000) // 16K sectors
-# elif defined(STM32F745xx)
-#  define FLASH_PAGE_SIZE                 ((uint32_t)0x8000) // 32K sectors
-# elif defined(STM32F746xx)
-#  define FLASH_PAGE_SIZE                 ((uint32_t)0x8000)
-# elif defined(STM32F765xx)
-#  define FLASH_PAGE_SIZE                 ((uint32_t)0x8000)
-# elif defined(UNIT_TEST)
-#  define FLASH_PAGE_SIZE                 (0x400)
-// H7
-# elif defined(STM32H743xx) || defined(STM32H750xx)
-#  define FLASH_PAGE_SIZE                 ((uint32_t)0x20000) // 128K sectors
-# elif defined(STM32G4)
-   // G4 V1.0.0 library forces us to use dual bank mode
-   // 2 bank * 128 page/bank * 2KB/page
-#  define FLASH_PAGE_SIZE                 ((uint32_t)0x800) // 2K page
-// SIMULATOR
-# elif defined(SIMULATOR_BUILD)
-#  define FLASH_PAGE_SIZE                 (0x400)
-# else
-#  error "Flash page size not defined for target."
-# endif
-#endif
 
 void config_streamer_init(config_streamer_t *c)
 {
@@ -423,17 +382,11 @@ static int write_word(config_streamer_t *c, config_streamer_buffer_align_type_t
 
 #elif defined(CONFIG_IN_RAM) || defined(CONFIG_IN_SDCARD)
     if (c->address == (uintptr_t)&eepromData[0]) {
-        memset(eepromData, 0, sizeof(eepromData));
+        // unused space reads as erased flash, so that changes can be appended later
+        memset(eepromData, 0xFF, sizeof(eepromData));
     }
 
-    uint64_t *dest_addr = (uint64_t *)c->address;
-    uint64_t *src_addr = (uint64_t*)buffer;
-    uint8_t row_index = 4;
-    /* copy the 256 bits flash word */
-    do
-    {
-      *dest_addr++ = *src_addr++;
-    } while (--row_index != 0);
+    memcpy((uint8_t *)c->address, buffer, CONFIG_STREAMER_BUFFER_SIZE);
 
 #elif defined(CONFIG_IN_FILE)
 
@@ -40,6 +40,51 @@ typedef uint64_t config_streamer_buffer_align_type_t;
 typedef uint32_t config_streamer_buffer_align_type_t;
 #endif
 
+// @todo this is not strictly correct for F4/F7, where sector sizes are variable
+#if !defined(FLASH_PAGE_SIZE)
+// F1
+# if defined(STM32F10X_MD)
+#  define FLASH_PAGE_SIZE                 (0x400)
+# elif defined(STM32F10X_HD)
+#  define FLASH_PAGE_SIZE                 (0x800)
+// F3
+# elif defined(STM32F303xC)
+#  define FLASH_PAGE_SIZE                 (0x800)
+// F4
+# elif defined(STM32F40_41xxx)
+#  define FLASH_PAGE_SIZE                 ((uint32_t)0x4000) // 16K sectors
+# elif defined (STM32F411xE)
+#  define FLASH_PAGE_SIZE                 ((uint32_t)0x4000)
+# elif defined(STM32F427_437xx)
+#  define FLASH_PAGE_SIZE                 ((uint32_t)0x4000)
+# elif defined (STM32F446xx)
+#  define FLASH_PAGE_SIZE                 ((uint32_t)0x4000)
+// F7
+#elif defined(STM32F722xx)
+#  define FLASH_PAGE_SIZE                 ((uint32_t)0x4000) // 16K sectors
+# elif defined(STM32F745xx)
+#  define FLASH_PAGE_SIZE                 ((uint32_t)0x8000) // 32K sectors
+# elif defined(STM32F746xx)
+#  define FLASH_PAGE_SIZE                 ((uint32_t)0x8000)
+# elif defined(STM32F765xx)
+#  define FLASH_PAGE_SIZE                 ((uint32_t)0x8000)
+# elif defined(UNIT_TEST)
+#  define FLASH_PAGE_SIZE                 (0x400)
+// H7
+# elif defined(STM32H743xx) || defined(STM32H750xx)
+#  define FLASH_PAGE_SIZE                 ((uint32_t)0x20000) // 128K sectors
+# elif defined(STM32G4)
+   // G4 V1.0.0 library forces us to use dual bank mode
+   // 2 bank * 128 page/bank * 2KB/page
+#  define FLASH_PAGE_SIZE                 ((uint32_t)0x800) // 2K page
+// SIMULATOR
+# elif defined(SIMULATOR_BUILD)
+#  define FLASH_PAGE_SIZE                 (0x400)
+# else
+#  error "Flash page size not defined for target."
+# endif
+#endif
+
 typedef struct config_streamer_s {
     uintptr_t address;
     int size;
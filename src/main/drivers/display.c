@@ -31,9 +31,64 @@
 
 #include "display.h"
 
-void displayClearScreen(displayPort_t *instance)
+static bool displaySoftLayerActive(const displayPort_t *instance)
+{
+    return instance->softLayer && instance->softLayer->activeLayer == DISPLAYPORT_LAYER_BACKGROUND;
+}
+
+static void displaySoftLayerClear(displaySoftLayer_t *softLayer)
+{
+    memset(softLayer->chars, ' ', sizeof(softLayer->chars));
+    memset(softLayer->attrs, 0, sizeof(softLayer->attrs));
+}
+
+static void displaySoftLayerWrite(displayPort_t *instance, uint8_t x, uint8_t y, uint8_t attr, const char *s)
+{
+    displaySoftLayer_t *softLayer = instance->softLayer;
+
+    if (y >= DISPLAYPORT_SOFT_LAYER_ROWS) {
+        return;
+    }
+    for (; *s && x < DISPLAYPORT_SOFT_LAYER_COLS; s++, x++) {
+        softLayer->chars[y][x] = *s;
+        softLayer->attrs[y][x] = attr;
+    }
+}
+
+// Composites the background layer onto the cleared device screen, as runs of non blank cells with the same attribute
+static void displaySoftLayerCopyToDevice(displayPort_t *instance)
 {
+    const displaySoftLayer_t *softLayer = instance->softLayer;
+    char run[DISPLAYPORT_SOFT_LAYER_COLS + 1];
+
     instance->vTable->clearScreen(instance);
+
+    for (uint8_t y = 0; y < instance->rows; y++) {
+        uint8_t x = 0;
+        while (x < instance->cols) {
+            if (softLayer->chars[y][x] == ' ') {
+                x++;
+                continue;
+            }
+            const uint8_t start = x;
+            const uint8_t attr = softLayer->attrs[y][x];
+            int len = 0;
+            while (x < instance->cols && softLayer->chars[y][x] != ' ' && softLayer->attrs[y][x] == attr) {
+                run[len++] = softLayer->chars[y][x++];
+            }
+            run[len] = 0;
+            instance->vTable->writeString(instance, start, y, attr, run);
+        }
+    }
+}
+
+void displayClearScreen(displayPort_t *instance)
+{
+    if (displaySoftLayerActive(instance)) {
+        displaySoftLayerClear(instance->softLayer);
+    } else {
+        instance->vTable->clearScreen(instance);
+    }
     instance->cleared = true;
     instance->cursorRow = -1;
 }
@@ -83,6 +138,10 @@ int displayWrite(displayPort_t *instance, uint8_t x, uint8_t y, uint8_t attr, co
 {
     instance->posX = x + strlen(s);
     instance->posY = y;
+    if (displaySoftLayerActive(instance)) {
+        displaySoftLayerWrite(instance, x, y, attr, s);
+        return 0;
+    }
     return instance->vTable->writeString(instance, x, y, attr, s);
 }
 
@@ -90,6 +149,11 @@ int displayWriteChar(displayPort_t *instance, uint8_t x, uint8_t y, uint8_t attr
 {
     instance->posX = x + 1;
     instance->posY = y;
+    if (displaySoftLayerActive(instance)) {
+        const char s[2] = { c, 0 };
+        displaySoftLayerWrite(instance, x, y, attr, s);
+        return 0;
+    }
     return instance->vTable->writeChar(instance, x, y, attr, c);
 }
 
@@ -123,6 +187,8 @@ bool displayLayerSupported(displayPort_t *instance, displayPortLayer_e layer)
     if (layer == DISPLAYPORT_LAYER_FOREGROUND) {
         // Every device must support the foreground (default) layer
         return true;
+    } else if (instance->softLayer) {
+        return layer == DISPLAYPORT_LAYER_BACKGROUND && instance->rows <= DISPLAYPORT_SOFT_LAYER_ROWS && instance->cols <= DISPLAYPORT_SOFT_LAYER_COLS;
     } else if (layer < DISPLAYPORT_LAYER_COUNT && instance->vTable->layerSupported) {
         return instance->vTable->layerSupported(instance, layer);
     }
@@ -131,6 +197,13 @@ bool displayLayerSupported(displayPort_t *instance, displayPortLayer_e layer)
 
 bool displayLayerSelect(displayPort_t *instance, displayPortLayer_e layer)
 {
+    if (instance->softLayer) {
+        if (layer < DISPLAYPORT_LAYER_COUNT) {
+            instance->softLayer->activeLayer = layer;
+            return true;
+        }
+        return false;
+    }
     if (instance->vTable->layerSelect) {
         return instance->vTable->layerSelect(instance, layer);
     }
@@ -139,6 +212,13 @@ bool displayLayerSelect(displayPort_t *instance, displayPortLayer_e layer)
 
 bool displayLayerCopy(displayPort_t *instance, displayPortLayer_e destLayer, displayPortLayer_e sourceLayer)
 {
+    if (instance->softLayer) {
+        if (destLayer == DISPLAYPORT_LAYER_FOREGROUND && sourceLayer == DISPLAYPORT_LAYER_BACKGROUND) {
+            displaySoftLayerCopyToDevice(instance);
+            return true;
+        }
+        return false;
+    }
     if (instance->vTable->layerCopy && sourceLayer != destLayer) {
         return instance->vTable->layerCopy(instance, destLayer, sourceLayer);
     }
@@ -178,6 +258,18 @@ void displayCommitTransaction(displayPort_t *instance)
     }
 }
 
+/*
+ * Devices that should only be drawn to at certain times, like an OSD chip during the vertical blanking
+ * interval of the video, return true with the start of the current or next window in which to draw.
+ */
+bool displayGetDrawWindow(const displayPort_t *instance, timeUs_t currentTimeUs, timeUs_t *windowStartUs)
+{
+    if (instance->vTable->getDrawWindow) {
+        return instance->vTable->getDrawWindow(instance, currentTimeUs, windowStartUs);
+    }
+    return false;
+}
+
 bool displayGetCanvas(displayCanvas_t *canvas, const displayPort_t *instance)
 {
 #if defined(USE_CANVAS)
@@ -196,9 +288,20 @@ bool displayGetCanvas(displayCanvas_t *canvas, const displayPort_t *instance)
 void displayInit(displayPort_t *instance, const displayPortVTable_t *vTable)
 {
     instance->vTable = vTable;
+    instance->softLayer = NULL;
     instance->vTable->clearScreen(instance);
     instance->useFullscreen = false;
     instance->cleared = true;
     instance->grabCount = 0;
     instance->cursorRow = -1;
+    instance->maxCmsCharsPerUpdate = 0;
+}
+
+// Gives a device without layers of its own a background layer. Static artwork drawn to it is kept
+// in RAM and composited onto the device screen by displayLayerCopy() instead of being redrawn.
+void displayInitSoftLayer(displayPort_t *instance, displaySoftLayer_t *softLayer)
+{
+    displaySoftLayerClear(softLayer);
+    softLayer->activeLayer = DISPLAYPORT_LAYER_FOREGROUND;
+    instance->softLayer = softLayer;
 }
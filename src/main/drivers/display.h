@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/time.h"
+
 typedef enum {
     DISPLAYPORT_ATTR_NONE = 0,
     DISPLAYPORT_ATTR_INFO,
@@ -46,6 +48,16 @@ struct displayCanvas_s;
 struct osdCharacter_s;
 struct displayPortVTable_s;
 
+// Background layer kept in RAM for devices that have no layers of their own
+#define DISPLAYPORT_SOFT_LAYER_ROWS 16
+#define DISPLAYPORT_SOFT_LAYER_COLS 30
+
+typedef struct displaySoftLayer_s {
+    displayPortLayer_e activeLayer;
+    uint8_t chars[DISPLAYPORT_SOFT_LAYER_ROWS][DISPLAYPORT_SOFT_LAYER_COLS];
+    uint8_t attrs[DISPLAYPORT_SOFT_LAYER_ROWS][DISPLAYPORT_SOFT_LAYER_COLS];
+} displaySoftLayer_t;
+
 typedef struct displayPort_s {
     const struct displayPortVTable_s *vTable;
     void *device;
@@ -62,6 +74,10 @@ typedef struct displayPort_s {
 
     // Displayport device capability
     bool useDeviceBlink;
+    uint16_t maxCmsCharsPerUpdate;  // limit for slow links, 0 if only limited by txBytesFree
+
+    // Background layer emulation, NULL if the device doesn't use it
+    displaySoftLayer_t *softLayer;
 } displayPort_t;
 
 typedef struct displayPortVTable_s {
@@ -85,6 +101,7 @@ typedef struct displayPortVTable_s {
     void (*beginTransaction)(displayPort_t *displayPort, displayTransactionOption_e opts);
     void (*commitTransaction)(displayPort_t *displayPort);
     bool (*getCanvas)(struct displayCanvas_s *canvas, const displayPort_t *displayPort);
+    bool (*getDrawWindow)(const displayPort_t *displayPort, timeUs_t currentTimeUs, timeUs_t *windowStartUs);
 } displayPortVTable_t;
 
 void displayGrab(displayPort_t *instance);
@@ -107,7 +124,9 @@ bool displayIsReady(displayPort_t *instance);
 void displayBeginTransaction(displayPort_t *instance, displayTransactionOption_e opts);
 void displayCommitTransaction(displayPort_t *instance);
 bool displayGetCanvas(struct displayCanvas_s *canvas, const displayPort_t *instance);
+bool displayGetDrawWindow(const displayPort_t *instance, timeUs_t currentTimeUs, timeUs_t *windowStartUs);
 void displayInit(displayPort_t *instance, const displayPortVTable_t *vTable);
+void displayInitSoftLayer(displayPort_t *instance, displaySoftLayer_t *softLayer);
 bool displayLayerSupported(displayPort_t *instance, displayPortLayer_e layer);
 bool displayLayerSelect(displayPort_t *instance, displayPortLayer_e layer);
 bool displayLayerCopy(displayPort_t *instance, displayPortLayer_e destLayer, displayPortLayer_e sourceLayer);
@@ -38,20 +38,19 @@
 
 #include "common/color.h"
 #include "common/colorconversion.h"
+#include "common/utils.h"
 
 #include "drivers/dma.h"
 #include "drivers/io.h"
 
 #include "light_ws2811strip.h"
 
-#if defined(STM32F1) || defined(STM32F3)
-uint8_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
-#elif defined(STM32F7)
-FAST_RAM_ZERO_INIT uint32_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
+#if defined(STM32F7)
+FAST_RAM_ZERO_INIT ledStripDMABufferEntry_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
 #elif defined(STM32H7)
-DMA_RAM uint32_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
+DMA_RAM ledStripDMABufferEntry_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
 #else
-uint32_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
+ledStripDMABufferEntry_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
 #endif
 
 static ioTag_t ledStripIoTag;
@@ -59,16 +58,36 @@ static bool ws2811Initialised = false;
 volatile bool ws2811LedDataTransferInProgress = false;
 static unsigned usedLedCount = 0;
 static bool needsFullRefresh = true;
+static ledStripFormatRGB_e lastLedFormat = LED_GRB;
 
 uint16_t BIT_COMPARE_1 = 0;
 uint16_t BIT_COMPARE_0 = 0;
 
 static hsvColor_t ledColorBuffer[WS2811_DATA_BUFFER_SIZE];
 
+// LEDs whose colour changed since their DMA buffer entries were last encoded
+static uint32_t ledDirtyBits[(WS2811_DATA_BUFFER_SIZE + 31) / 32];
+#define SET_LED_DIRTY(index) (ledDirtyBits[(index) / 32] |= (1U << ((index) % 32)))
+
+// DMA buffer entries for each nibble value, most significant bit first
+static ledStripDMABufferEntry_t nibbleCompareValues[16][4];
+static uint16_t nibbleCompareValue1;
+static uint16_t nibbleCompareValue0;
+
+static void setLedColor(uint16_t index, const hsvColor_t *color)
+{
+    hsvColor_t *ledColor = &ledColorBuffer[index];
+
+    if (ledColor->h != color->h || ledColor->s != color->s || ledColor->v != color->v) {
+        *ledColor = *color;
+        SET_LED_DIRTY(index);
+    }
+}
+
 #if !defined(USE_WS2811_SINGLE_COLOUR)
 void setLedHsv(uint16_t index, const hsvColor_t *color)
 {
-    ledColorBuffer[index] = *color;
+    setLedColor(index, color);
 }
 
 void getLedHsv(uint16_t index, hsvColor_t *color)
@@ -78,19 +97,22 @@ void getLedHsv(uint16_t index, hsvColor_t *color)
 
 void setLedValue(uint16_t index, const uint8_t value)
 {
-    ledColorBuffer[index].v = value;
+    if (ledColorBuffer[index].v != value) {
+        ledColorBuffer[index].v = value;
+        SET_LED_DIRTY(index);
+    }
 }
 
 void scaleLedValue(uint16_t index, const uint8_t scalePercent)
 {
-    ledColorBuffer[index].v = ((uint16_t)ledColorBuffer[index].v * scalePercent / 100);
+    setLedValue(index, (uint16_t)ledColorBuffer[index].v * scalePercent / 100);
 }
 #endif
 
 void setStripColor(const hsvColor_t *color)
 {
     for (unsigned index = 0; index < usedLedCount; index++) {
-        ledColorBuffer[index] = *color;
+        setLedColor(index, color);
     }
 }
 
@@ -138,26 +160,45 @@ bool isWS2811LedStripReady(void)
     return ws2811Initialised && !ws2811LedDataTransferInProgress;
 }
 
+static void updateNibbleCompareValues(void)
+{
+    for (unsigned nibble = 0; nibble < 16; nibble++) {
+        for (unsigned bit = 0; bit < 4; bit++) {
+            nibbleCompareValues[nibble][bit] = (nibble & (0x8 >> bit)) ? BIT_COMPARE_1 : BIT_COMPARE_0;
+        }
+    }
+    nibbleCompareValue1 = BIT_COMPARE_1;
+    nibbleCompareValue0 = BIT_COMPARE_0;
+}
+
+static void encodeLEDDMAByte(ledStripDMABufferEntry_t *dmaBuffer, uint8_t value)
+{
+    memcpy(dmaBuffer, nibbleCompareValues[value >> 4], sizeof(nibbleCompareValues[0]));
+    memcpy(dmaBuffer + 4, nibbleCompareValues[value & 0x0F], sizeof(nibbleCompareValues[0]));
+}
+
 STATIC_UNIT_TESTED void updateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbColor24bpp_t *color, unsigned ledIndex)
 {
+    // the compare values are only set once the timer is configured
+    if (nibbleCompareValue1 != BIT_COMPARE_1 || nibbleCompareValue0 != BIT_COMPARE_0) {
+        updateNibbleCompareValues();
+    }
 
-    uint32_t packed_colour;
+    ledStripDMABufferEntry_t *dmaBuffer = &ledStripDMABuffer[ledIndex * WS2811_BITS_PER_LED];
 
     switch (ledFormat) {
         case LED_RGB: // WS2811 drivers use RGB format
-            packed_colour = (color->rgb.r << 16) | (color->rgb.g << 8) | (color->rgb.b);
+            encodeLEDDMAByte(dmaBuffer, color->rgb.r);
+            encodeLEDDMAByte(dmaBuffer + 8, color->rgb.g);
             break;
 
         case LED_GRB: // WS2812 drivers use GRB format
         default:
-            packed_colour = (color->rgb.g << 16) | (color->rgb.r << 8) | (color->rgb.b);
+            encodeLEDDMAByte(dmaBuffer, color->rgb.g);
+            encodeLEDDMAByte(dmaBuffer + 8, color->rgb.r);
         break;
     }
-
-    unsigned dmaBufferOffset = 0;
-    for (int index = 23; index >= 0; index--) {
-        ledStripDMABuffer[ledIndex * WS2811_BITS_PER_LED + dmaBufferOffset++] = (packed_colour & (1 << index)) ? BIT_COMPARE_1 : BIT_COMPARE_0;
-    }
+    encodeLEDDMAByte(dmaBuffer + 16, color->rgb.b);
 }
 
 /*
@@ -171,18 +212,29 @@ void ws2811UpdateStrip(ledStripFormatRGB_e ledFormat)
         return;
     }
 
-    unsigned ledIndex = 0;              // reset led index
+    if (needsFullRefresh || ledFormat != lastLedFormat) {
+        memset(ledDirtyBits, 0xFF, sizeof(ledDirtyBits));
+        needsFullRefresh = false;
+        lastLedFormat = ledFormat;
+    }
 
     // fill transmit buffer with correct compare values to achieve
-    // correct pulse widths according to color values
-    const unsigned ledUpdateCount = needsFullRefresh ? WS2811_DATA_BUFFER_SIZE : usedLedCount;
+    // correct pulse widths according to color values, only for the LEDs that changed
     const hsvColor_t hsvBlack = { 0, 0, 0 };
-    while (ledIndex < ledUpdateCount) {
-        rgbColor24bpp_t *rgb24 = hsvToRgb24(ledIndex < usedLedCount ? &ledColorBuffer[ledIndex] : &hsvBlack);
-
-        updateLEDDMABuffer(ledFormat, rgb24, ledIndex++);
+    for (unsigned word = 0; word < ARRAYLEN(ledDirtyBits); word++) {
+        uint32_t dirtyBits = ledDirtyBits[word];
+        ledDirtyBits[word] = 0;
+
+        while (dirtyBits) {
+            const unsigned ledIndex = word * 32 + __builtin_ctz(dirtyBits);
+            dirtyBits &= dirtyBits - 1;
+
+            if (ledIndex < WS2811_DATA_BUFFER_SIZE) {
+                rgbColor24bpp_t *rgb24 = hsvToRgb24(ledIndex < usedLedCount ? &ledColorBuffer[ledIndex] : &hsvBlack);
+                updateLEDDMABuffer(ledFormat, rgb24, ledIndex);
+            }
+        }
     }
-    needsFullRefresh = false;
 
     ws2811LedDataTransferInProgress = true;
     ws2811LedStripDMAEnable();
@@ -72,10 +72,12 @@ void setUsedLedCount(unsigned ledCount);
 bool isWS2811LedStripReady(void);
 
 #if defined(STM32F1) || defined(STM32F3)
-extern uint8_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
+typedef uint8_t ledStripDMABufferEntry_t;
 #else
-extern uint32_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
+typedef uint32_t ledStripDMABufferEntry_t;
 #endif
+
+extern ledStripDMABufferEntry_t ledStripDMABuffer[WS2811_DMA_BUFFER_SIZE];
 extern volatile bool ws2811LedDataTransferInProgress;
 
 extern uint16_t BIT_COMPARE_1;
@@ -28,11 +28,15 @@
 
 #include "build/debug.h"
 
+#include "common/maths.h"
+#include "common/utils.h"
+
 #include "pg/max7456.h"
 #include "pg/vcd.h"
 
 #include "drivers/bus_spi.h"
 #include "drivers/dma.h"
+#include "drivers/exti.h"
 #include "drivers/io.h"
 #include "drivers/light_led.h"
 #include "drivers/max7456.h"
@@ -102,11 +106,13 @@
 #define STAT_PAL      0x01
 #define STAT_NTSC     0x02
 #define STAT_LOS      0x04
+#define STAT_VSYNC    0x10 // low during vertical sync
 #define STAT_NVR_BUSY 0x20
 
 #define STAT_IS_PAL(val)  ((val) & STAT_PAL)
 #define STAT_IS_NTSC(val) ((val) & STAT_NTSC)
 #define STAT_IS_LOS(val)  ((val) & STAT_LOS)
+#define STAT_IS_VSYNC(val) (!((val) & STAT_VSYNC))
 
 #define VIN_IS_PAL(val)  (!STAT_IS_LOS(val) && STAT_IS_PAL(val))
 #define VIN_IS_NTSC(val)  (!STAT_IS_LOS(val) && STAT_IS_NTSC(val))
@@ -122,7 +128,24 @@
 #define MAX7456_SIGNAL_CHECK_INTERVAL_MS 1000 // msec
 #define MAX7456_STALL_CHECK_INTERVAL_MS  1000 // msec
 
+// Video field timing. The display memory is written during the vertical blanking interval at the start of
+// each field, so that an update is not shown half done and the SPI time per field is bounded.
+#define VIDEO_FIELD_US_PAL          20000
+#define VIDEO_FIELD_US_NTSC         16683
+#define VIDEO_VBLANK_US_PAL         (25 * 64)   // 25 blanked lines
+#define VIDEO_VBLANK_US_NTSC        (20 * 64)   // 20 blanked lines
+#define VIDEO_VSYNC_PULSE_US        (3 * 64)    // VSYNC is low for 3 lines
+
+// An interrupt driven field start is no longer trusted after this many fields without an interrupt
+#define MAX7456_VSYNC_TIMEOUT_FIELDS    3
+// An estimated field start is searched for again after this many predicted VSYNC pulses were not seen
+#define MAX7456_VSYNC_MAX_MISSES        3
+
+// SPI throughput including the gaps between bytes at the full clock, bytes per millisecond
+#define MAX7456_SPI_BYTES_PER_MS        1000
+
 // DMM special bits
+#define DMM_AUTO_INCREMENT 0x01
 #define CLEAR_DISPLAY 0x04
 #define CLEAR_DISPLAY_VERT 0x06
 #define INVERT_PIXEL_COLOR 0x08
@@ -205,6 +228,12 @@ uint16_t maxScreenSize = VIDEO_BUFFER_CHARS_PAL;
 
 static uint8_t shadowBuffer[VIDEO_BUFFER_CHARS_PAL];
 
+// Rows that may differ from shadowBuffer, only these are compared when drawing.
+static uint32_t dirtyRows;
+STATIC_ASSERT(VIDEO_LINES_PAL <= 32, dirtyRows_too_small);
+
+#define ALL_ROWS_DIRTY 0xffffffff
+
 //Max chars to update in one idle
 
 #define MAX_CHARS2UPDATE    100
@@ -214,6 +243,14 @@ volatile bool dmaTransactionInProgress = false;
 
 static uint8_t spiBuff[MAX_CHARS2UPDATE*6];
 
+// A changed character is written with an address as 6 bytes. A run of characters is written in auto-increment
+// mode as 2 bytes each, plus 8 bytes to set the address, enable auto-increment and terminate it.
+#define DIRECT_WRITE_SIZE   6
+#define RUN_OVERHEAD_SIZE   8
+#define RUN_MIN_LENGTH      3
+// Unchanged characters between changes in a row are included in a run if that is cheaper than starting a new run
+#define RUN_MAX_GAP         3
+
 static uint8_t  videoSignalCfg;
 static uint8_t  videoSignalReg  = OSD_ENABLE; // OSD_ENABLE required to trigger first ReInit
 static uint8_t  displayMemoryModeReg = 0;
@@ -230,6 +267,15 @@ static uint8_t max7456DeviceType;
 static uint8_t previousBlackWhiteRegister = INVALID_PREVIOUS_REGISTER_STATE;
 static uint8_t previousInvertRegister = INVALID_PREVIOUS_REGISTER_STATE;
 
+static max7456VsyncSource_e vsyncSource = MAX7456_VSYNC_NONE;
+static volatile timeUs_t vsyncAtUs;     // start of the last field seen
+static bool vsyncLocked;                // the estimated field start is valid
+static uint8_t vsyncMisses;
+
+#ifdef USE_EXTI
+static extiCallbackRec_t vsyncExtiCallbackRec;
+#endif
+
 static void max7456DrawScreenSlow(void);
 
 static uint8_t *getLayerBuffer(displayPortLayer_e layer)
@@ -374,12 +420,14 @@ uint8_t max7456GetRowsCount(void)
 static void max7456ClearShadowBuffer(void)
 {
     memset(shadowBuffer, 0, maxScreenSize);
+    dirtyRows = ALL_ROWS_DIRTY;
 }
 
 // Buffer is filled with the whitespace character (0x20)
 static void max7456ClearLayer(displayPortLayer_e layer)
 {
     memset(getLayerBuffer(layer), 0x20, VIDEO_BUFFER_CHARS_PAL);
+    dirtyRows = ALL_ROWS_DIRTY;
 }
 
 
@@ -434,6 +482,10 @@ void max7456ReInit(void)
     max7456Send(MAX7456ADD_DMM, displayMemoryModeReg | CLEAR_DISPLAY);
     __spiBusTransactionEnd(busdev);
 
+    // The field period may have changed, find the field start again
+    vsyncLocked = false;
+    vsyncMisses = 0;
+
     // Clear shadow to force redraw all screen in non-dma mode.
     max7456ClearShadowBuffer();
     if (firstInit) {
@@ -442,6 +494,16 @@ void max7456ReInit(void)
     }
 }
 
+#ifdef USE_EXTI
+static void max7456VsyncExtiHandler(extiCallbackRec_t *cb)
+{
+    UNUSED(cb);
+
+    vsyncAtUs = microsISR();
+    vsyncLocked = true;
+}
+#endif
+
 void max7456PreInit(const max7456Config_t *max7456Config)
 {
     spiPreinitRegister(max7456Config->csTag, max7456Config->preInitOPU ? IOCFG_OUT_PP : IOCFG_IPU, 1);
@@ -559,6 +621,18 @@ bool max7456Init(const max7456Config_t *max7456Config, const vcdProfile_t *pVcdP
     dmaSetHandler(MAX7456_DMA_IRQ_HANDLER_ID, max7456_dma_irq_handler, NVIC_PRIO_MAX7456_DMA, 0);
 #endif
 
+    vsyncSource = MAX7456_VSYNC_ESTIMATED;
+#ifdef USE_EXTI
+    IO_t vsyncIO = IOGetByTag(max7456Config->vsyncTag);
+    if (vsyncIO) {
+        IOInit(vsyncIO, OWNER_OSD_VSYNC, 0);
+        EXTIHandlerInit(&vsyncExtiCallbackRec, max7456VsyncExtiHandler);
+        EXTIConfig(vsyncIO, &vsyncExtiCallbackRec, NVIC_PRIO_MAX7456_VSYNC_EXTI, IOCFG_IPU, BETAFLIGHT_EXTI_TRIGGER_FALLING);
+        EXTIEnable(vsyncIO, true);
+        vsyncSource = MAX7456_VSYNC_EXTI;
+    }
+#endif
+
     // Real init will be made later when driver detect idle.
     return true;
 }
@@ -615,6 +689,7 @@ void max7456WriteChar(uint8_t x, uint8_t y, uint8_t c)
     uint8_t *buffer = getActiveLayerBuffer();
     if (x < CHARS_PER_LINE && y < VIDEO_LINES_PAL) {
         buffer[y * CHARS_PER_LINE + x] = c;
+        dirtyRows |= 1 << y;
     }
 }
 
@@ -625,6 +700,7 @@ void max7456Write(uint8_t x, uint8_t y, const char *buff)
         for (int i = 0; buff[i] && x + i < CHARS_PER_LINE; i++) {
             buffer[y * CHARS_PER_LINE + x + i] = buff[i];
         }
+        dirtyRows |= 1 << y;
     }
 }
 
@@ -640,7 +716,10 @@ bool max7456LayerSupported(displayPortLayer_e layer)
 bool max7456LayerSelect(displayPortLayer_e layer)
 {
     if (max7456LayerSupported(layer)) {
-        activeLayer = layer;
+        if (layer != activeLayer) {
+            activeLayer = layer;
+            dirtyRows = ALL_ROWS_DIRTY;
+        }
         return true;
     } else {
         return false;
@@ -651,6 +730,7 @@ bool max7456LayerCopy(displayPortLayer_e destLayer, displayPortLayer_e sourceLay
 {
     if ((sourceLayer != destLayer) && max7456LayerSupported(sourceLayer) && max7456LayerSupported(destLayer)) {
         memcpy(getLayerBuffer(destLayer), getLayerBuffer(sourceLayer), VIDEO_BUFFER_CHARS_PAL);
+        dirtyRows = ALL_ROWS_DIRTY;
         return true;
     } else {
         return false;
@@ -668,12 +748,7 @@ bool max7456DmaInProgress(void)
 
 bool max7456BuffersSynced(void)
 {
-    for (int i = 0; i < maxScreenSize; i++) {
-        if (displayLayers[DISPLAYPORT_LAYER_FOREGROUND].buffer[i] != shadowBuffer[i]) {
-            return false;
-        }
-    }
-    return true;
+    return memcmp(displayLayers[DISPLAYPORT_LAYER_FOREGROUND].buffer, shadowBuffer, maxScreenSize) == 0;
 }
 
 void max7456ReInitIfRequired(bool forceStallCheck)
@@ -731,6 +806,188 @@ void max7456ReInitIfRequired(bool forceStallCheck)
     //------------   end of (re)init-------------------------------------
 }
 
+static timeDelta_t max7456FieldPeriodUs(void)
+{
+    return VIDEO_MODE_IS_PAL(videoSignalReg) ? VIDEO_FIELD_US_PAL : VIDEO_FIELD_US_NTSC;
+}
+
+// Returns how long after the start of a field the display memory can be written
+static timeDelta_t max7456DrawWindowUs(void)
+{
+    const timeDelta_t vblankUs = VIDEO_MODE_IS_PAL(videoSignalReg) ? VIDEO_VBLANK_US_PAL : VIDEO_VBLANK_US_NTSC;
+
+    // an estimated field start can be late by up to the length of the VSYNC pulse
+    return vsyncSource == MAX7456_VSYNC_ESTIMATED ? vblankUs - VIDEO_VSYNC_PULSE_US : vblankUs;
+}
+
+// Returns the time since the start of the current field, or -1 if the field timing is not known
+static timeDelta_t max7456FieldPhaseUs(timeUs_t currentTimeUs)
+{
+    const timeDelta_t fieldPeriodUs = max7456FieldPeriodUs();
+    // the interrupt may have moved vsyncAtUs past currentTimeUs
+    const timeDelta_t sinceVsyncUs = MAX(cmpTimeUs(currentTimeUs, vsyncAtUs), 0);
+
+    switch (vsyncSource) {
+    case MAX7456_VSYNC_EXTI:
+        if (!vsyncLocked || sinceVsyncUs > MAX7456_VSYNC_TIMEOUT_FIELDS * fieldPeriodUs) {
+            return -1;
+        }
+        return sinceVsyncUs % fieldPeriodUs;
+
+    case MAX7456_VSYNC_ESTIMATED:
+        if (!vsyncLocked) {
+            return -1;
+        }
+        return sinceVsyncUs % fieldPeriodUs;
+
+    default:
+        return -1;
+    }
+}
+
+// Without the VSYNC interrupt the status register is polled, first to find a VSYNC pulse and then
+// to check that the following pulses are where the field period predicts them
+static void max7456TrackVsync(timeUs_t currentTimeUs)
+{
+    const timeDelta_t phaseUs = max7456FieldPhaseUs(currentTimeUs);
+
+    if (phaseUs >= VIDEO_VSYNC_PULSE_US) {
+        // nothing to check, keep the field start recent so that the time difference can't overflow
+        vsyncAtUs = currentTimeUs - phaseUs;
+        return;
+    }
+
+    __spiBusTransactionBegin(busdev);
+    const uint8_t stat = max7456Send(MAX7456ADD_STAT, 0x00);
+    __spiBusTransactionEnd(busdev);
+
+    if (STAT_IS_VSYNC(stat)) {
+        vsyncAtUs = currentTimeUs - MAX(phaseUs, 0);
+        vsyncLocked = true;
+        vsyncMisses = 0;
+    } else if (phaseUs >= 0 && ++vsyncMisses >= MAX7456_VSYNC_MAX_MISSES) {
+        vsyncLocked = false;
+        vsyncMisses = 0;
+    }
+}
+
+// Returns how many bytes can be sent now, all of spiBuff unless updates are paced to the video
+static int max7456DrawBudget(timeUs_t currentTimeUs)
+{
+    const timeDelta_t phaseUs = max7456FieldPhaseUs(currentTimeUs);
+    if (phaseUs < 0) {
+        return sizeof(spiBuff);
+    }
+
+    const timeDelta_t remainingUs = max7456DrawWindowUs() - phaseUs;
+    if (remainingUs <= 0) {
+        return 0;
+    }
+    const int bytesPerMs = (max7456SpiClock == MAX7456_SPI_CLK) ? MAX7456_SPI_BYTES_PER_MS : MAX7456_SPI_BYTES_PER_MS / 2;
+
+    return MIN(remainingUs * bytesPerMs / 1000, (int)sizeof(spiBuff));
+}
+
+max7456VsyncSource_e max7456GetVsyncSource(void)
+{
+    return vsyncSource;
+}
+
+// Returns false if the field timing is not known, otherwise the start of the current or next window to draw in
+bool max7456GetDrawWindow(timeUs_t currentTimeUs, timeUs_t *windowStartUs)
+{
+    const timeDelta_t phaseUs = max7456FieldPhaseUs(currentTimeUs);
+    if (phaseUs < 0) {
+        return false;
+    }
+
+    *windowStartUs = currentTimeUs - phaseUs;
+    if (phaseUs >= max7456DrawWindowUs()) {
+        *windowStartUs += max7456FieldPeriodUs();
+    }
+
+    return true;
+}
+
+// Returns the position of the first character from pos up to end that differs from shadowBuffer, or end
+static uint16_t findChangedChar(const uint8_t *buffer, uint16_t pos, uint16_t end)
+{
+    // compare a word at a time, most of a row is usually unchanged
+    while (pos + sizeof(uint32_t) <= end) {
+        uint32_t word;
+        uint32_t shadowWord;
+        memcpy(&word, &buffer[pos], sizeof(word));
+        memcpy(&shadowWord, &shadowBuffer[pos], sizeof(shadowWord));
+        if (word != shadowWord) {
+            break;
+        }
+        pos += sizeof(uint32_t);
+    }
+    while (pos < end && buffer[pos] == shadowBuffer[pos]) {
+        pos++;
+    }
+    return pos;
+}
+
+// Returns the length of the run starting at the changed character at pos, up to and including the last changed character in it
+static uint16_t changedRunLength(const uint8_t *buffer, uint16_t pos, uint16_t end)
+{
+    uint16_t runEnd = pos + 1;
+    // END_STRING terminates auto-increment mode, so it cannot be part of a run
+    for (uint16_t next = runEnd; next < end && buffer[next] != END_STRING; next++) {
+        if (buffer[next] != shadowBuffer[next]) {
+            runEnd = next + 1;
+        } else if (next - runEnd >= RUN_MAX_GAP) {
+            break;
+        }
+    }
+    return runEnd - pos;
+}
+
+// Adds the characters of a run to spiBuff, returns the number of characters added or 0 if buff_limit is reached
+static uint16_t max7456QueueRun(const uint8_t *buffer, uint16_t pos, uint16_t length, int *buff_len, int buff_limit)
+{
+    const int space = buff_limit - *buff_len;
+    uint8_t *spi = &spiBuff[*buff_len];
+
+    if (buffer[pos] == END_STRING) {
+        length = 1;
+    } else if (RUN_OVERHEAD_SIZE + 2 * length > space) {
+        length = space > RUN_OVERHEAD_SIZE ? (space - RUN_OVERHEAD_SIZE) / 2 : 0;
+    }
+    if (length < RUN_MIN_LENGTH) {
+        // a short run is cheaper to write character by character
+        if (space < DIRECT_WRITE_SIZE) {
+            return 0;
+        }
+        length = 1;
+    }
+
+    *spi++ = MAX7456ADD_DMAH;
+    *spi++ = pos >> 8;
+    *spi++ = MAX7456ADD_DMAL;
+    *spi++ = pos & 0xff;
+
+    if (length == 1) {
+        *spi++ = MAX7456ADD_DMDI;
+        *spi++ = buffer[pos];
+    } else {
+        *spi++ = MAX7456ADD_DMM;
+        *spi++ = displayMemoryModeReg | DMM_AUTO_INCREMENT;
+        for (int i = 0; i < length; i++) {
+            *spi++ = MAX7456ADD_DMDI;
+            *spi++ = buffer[pos + i];
+        }
+        *spi++ = MAX7456ADD_DMDI;
+        *spi++ = END_STRING;
+    }
+
+    memcpy(&shadowBuffer[pos], &buffer[pos], length);
+    *buff_len = spi - spiBuff;
+
+    return length;
+}
+
 void max7456DrawScreen(void)
 {
     static uint16_t pos = 0;
@@ -741,23 +998,42 @@ void max7456DrawScreen(void)
 
         max7456ReInitIfRequired(false);
 
+        const timeUs_t currentTimeUs = micros();
+        if (vsyncSource == MAX7456_VSYNC_ESTIMATED) {
+            max7456TrackVsync(currentTimeUs);
+        }
+        // outside of the vertical blanking window nothing is sent, the changes stay pending
+        const int buff_limit = max7456DrawBudget(currentTimeUs);
+
         uint8_t *buffer = getActiveLayerBuffer();
+        const uint8_t rows = maxScreenSize / CHARS_PER_LINE;
 
         int buff_len = 0;
-        for (int k = 0; k < MAX_CHARS2UPDATE; k++) {
-            if (buffer[pos] != shadowBuffer[pos]) {
-                spiBuff[buff_len++] = MAX7456ADD_DMAH;
-                spiBuff[buff_len++] = pos >> 8;
-                spiBuff[buff_len++] = MAX7456ADD_DMAL;
-                spiBuff[buff_len++] = pos & 0xff;
-                spiBuff[buff_len++] = MAX7456ADD_DMDI;
-                spiBuff[buff_len++] = buffer[pos];
-                shadowBuffer[pos] = buffer[pos];
+        bool spiBuffFull = (buff_limit == 0);
+        // check every row once, plus the rest of the row the previous update stopped in
+        for (int i = 0; i <= rows && !spiBuffFull; i++) {
+            if (pos >= maxScreenSize) {
+                pos = 0;
             }
+            const uint8_t row = pos / CHARS_PER_LINE;
+            const uint16_t rowEnd = (row + 1) * CHARS_PER_LINE;
 
-            if (++pos >= maxScreenSize) {
-                pos = 0;
-                break;
+            if (pos % CHARS_PER_LINE == 0) {
+                if (!(dirtyRows & (1 << row))) {
+                    pos = rowEnd;
+                    continue;
+                }
+                // a write to the row while it is being updated marks it again
+                dirtyRows &= ~(1 << row);
+            }
+
+            while ((pos = findChangedChar(buffer, pos, rowEnd)) < rowEnd) {
+                const uint16_t queued = max7456QueueRun(buffer, pos, changedRunLength(buffer, pos, rowEnd), &buff_len, buff_limit);
+                if (!queued) {
+                    spiBuffFull = true;
+                    break;
+                }
+                pos += queued;
             }
         }
 
@@ -784,7 +1060,7 @@ static void max7456DrawScreenSlow(void)
     // The "escape" character 0xFF must be skipped as it causes the MAX7456 to exit auto-increment mode.
     max7456Send(MAX7456ADD_DMAH, 0);
     max7456Send(MAX7456ADD_DMAL, 0);
-    max7456Send(MAX7456ADD_DMM, displayMemoryModeReg | 1);
+    max7456Send(MAX7456ADD_DMM, displayMemoryModeReg | DMM_AUTO_INCREMENT);
 
     for (int xx = 0; xx < maxScreenSize; xx++) {
         if (buffer[xx] == END_STRING) {
@@ -795,6 +1071,7 @@ static void max7456DrawScreenSlow(void)
         }
         shadowBuffer[xx] = buffer[xx];
     }
+    dirtyRows = 0;
 
     max7456Send(MAX7456ADD_DMDI, END_STRING);
     max7456Send(MAX7456ADD_DMM, displayMemoryModeReg);
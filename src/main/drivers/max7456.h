@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/time.h"
+
 #include "drivers/display.h"
 
 /** PAL or NTSC, value is number of chars total */
@@ -28,6 +30,13 @@
 #define VIDEO_LINES_NTSC          13
 #define VIDEO_LINES_PAL           16
 
+// How the start of each video field is known, to draw during vertical blanking
+typedef enum {
+    MAX7456_VSYNC_NONE,         // unknown, changes are sent whenever the screen is drawn
+    MAX7456_VSYNC_ESTIMATED,    // found by polling the VSYNC status and predicted from the field period
+    MAX7456_VSYNC_EXTI,         // from an interrupt on the VSYNC pin
+} max7456VsyncSource_e;
+
 extern uint16_t maxScreenSize;
 struct vcdProfile_s;
 void    max7456HardwareReset(void);
@@ -49,3 +58,5 @@ bool    max7456LayerSupported(displayPortLayer_e layer);
 bool    max7456LayerSelect(displayPortLayer_e layer);
 bool    max7456LayerCopy(displayPortLayer_e destLayer, displayPortLayer_e sourceLayer);
 bool    max7456IsDeviceDetected(void);
+max7456VsyncSource_e max7456GetVsyncSource(void);
+bool    max7456GetDrawWindow(timeUs_t currentTimeUs, timeUs_t *windowStartUs);
@@ -109,4 +109,5 @@ const char * const ownerNames[OWNER_TOTAL_COUNT] = {
     "PULLDOWN",
     "DSHOT_BITBANG",
     "SWD",
+    "OSD_VSYNC",
 };
@@ -107,6 +107,7 @@ typedef enum {
     OWNER_PULLDOWN,
     OWNER_DSHOT_BITBANG,
     OWNER_SWD,
+    OWNER_OSD_VSYNC,
     OWNER_TOTAL_COUNT
 } resourceOwner_e;
 
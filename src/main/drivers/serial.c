@@ -107,6 +107,43 @@ void serialSetBaudRateCb(serialPort_t *serialPort, void (*cb)(serialPort_t *cont
     }
 }
 
+/*
+ * Switch the port to frame mode, where the driver gathers the bytes received in frameBuffer and hands them to cb in one
+ * go when the line goes idle, rather than calling the rx callback for every byte. The rx callback data is passed to cb.
+ * Returns false if the driver can't detect an idle line, in which case the port keeps calling the rx callback.
+ */
+bool serialSetRxFrameCb(serialPort_t *serialPort, serialReceiveFrameCallbackPtr cb, uint8_t *frameBuffer, uint16_t frameBufferSize)
+{
+    if (!serialPort->vTable->setRxFrameCb) {
+        return false;
+    }
+    serialPort->vTable->setRxFrameCb(serialPort, cb, frameBuffer, frameBufferSize);
+    return true;
+}
+
+// Called by drivers in frame mode for every byte received
+void serialRxFrameByte(serialPort_t *instance, uint8_t ch)
+{
+    if (instance->rxFrameLength < instance->rxFrameBufferSize) {
+        instance->rxFrameBuffer[instance->rxFrameLength] = ch;
+    }
+    // Count one byte past the end of the buffer, so that a frame too large for it is dropped
+    if (instance->rxFrameLength <= instance->rxFrameBufferSize) {
+        instance->rxFrameLength++;
+    }
+}
+
+// Called by drivers in frame mode when the line goes idle after a frame
+void serialRxFrameIdle(serialPort_t *instance)
+{
+    const uint16_t length = instance->rxFrameLength;
+
+    instance->rxFrameLength = 0;
+    if (length > 0 && length <= instance->rxFrameBufferSize) {
+        instance->rxFrameCallback(instance->rxFrameBuffer, length, instance->rxCallbackData);
+    }
+}
+
 void serialWriteBufShim(void *instance, const uint8_t *data, int count)
 {
     serialWriteBuf((serialPort_t *)instance, data, count);
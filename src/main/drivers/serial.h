@@ -60,6 +60,7 @@ typedef enum {
 
 typedef void (*serialReceiveCallbackPtr)(uint16_t data, void *rxCallbackData);   // used by serial drivers to return frames to app
 typedef void (*serialIdleCallbackPtr)();
+typedef void (*serialReceiveFrameCallbackPtr)(const uint8_t *frame, uint16_t length, void *rxCallbackData);   // used by serial drivers to return whole frames in frame mode
 
 typedef struct serialPort_s {
 
@@ -84,6 +85,12 @@ typedef struct serialPort_s {
 
     serialIdleCallbackPtr idleCallback;
 
+    // Frame mode, the bytes received are gathered in rxFrameBuffer and passed on when the line goes idle
+    serialReceiveFrameCallbackPtr rxFrameCallback;
+    uint8_t *rxFrameBuffer;
+    uint16_t rxFrameBufferSize;
+    uint16_t rxFrameLength;
+
     uint8_t identifier;
 } serialPort_t;
 
@@ -121,6 +128,8 @@ struct serialPortVTable {
     void (*setMode)(serialPort_t *instance, portMode_e mode);
     void (*setCtrlLineStateCb)(serialPort_t *instance, void (*cb)(void *instance, uint16_t ctrlLineState), void *context);
     void (*setBaudRateCb)(serialPort_t *instance, void (*cb)(serialPort_t *context, uint32_t baud), serialPort_t *context);
+    // Optional, for drivers that can detect the end of a frame from an idle line.
+    void (*setRxFrameCb)(serialPort_t *instance, serialReceiveFrameCallbackPtr cb, uint8_t *frameBuffer, uint16_t frameBufferSize);
 
     void (*writeBuf)(serialPort_t *instance, const void *data, int count);
     // Optional functions used to buffer large writes.
@@ -137,6 +146,9 @@ void serialSetBaudRate(serialPort_t *instance, uint32_t baudRate);
 void serialSetMode(serialPort_t *instance, portMode_e mode);
 void serialSetCtrlLineStateCb(serialPort_t *instance, void (*cb)(void *context, uint16_t ctrlLineState), void *context);
 void serialSetBaudRateCb(serialPort_t *instance, void (*cb)(serialPort_t *context, uint32_t baud), serialPort_t *context);
+bool serialSetRxFrameCb(serialPort_t *instance, serialReceiveFrameCallbackPtr cb, uint8_t *frameBuffer, uint16_t frameBufferSize);
+void serialRxFrameByte(serialPort_t *instance, uint8_t ch);
+void serialRxFrameIdle(serialPort_t *instance);
 bool isSerialTransmitBufferEmpty(const serialPort_t *instance);
 void serialPrint(serialPort_t *instance, const char *str);
 uint32_t serialGetBaudRate(serialPort_t *instance);
@@ -864,6 +864,7 @@ const struct serialPortVTable escSerialVTable[] = {
         .setMode = escSerialSetMode,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
+        .setRxFrameCb = NULL,
         .writeBuf = NULL,
         .beginWrite = NULL,
         .endWrite = NULL
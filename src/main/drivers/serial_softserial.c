@@ -640,6 +640,7 @@ static const struct serialPortVTable softSerialVTable = {
     .setMode = softSerialSetMode,
     .setCtrlLineStateCb = NULL,
     .setBaudRateCb = NULL,
+    .setRxFrameCb = NULL,
     .writeBuf = NULL,
     .beginWrite = NULL,
     .endWrite = NULL
@@ -116,6 +116,7 @@ serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr rxCallback,
     // callback works for IRQ-based RX ONLY
     s->port.rxCallback = rxCallback;
     s->port.rxCallbackData = rxCallbackData;
+    s->port.rxFrameCallback = NULL;
     s->port.mode = mode;
     s->port.baudRate = baudRate;
     s->port.options = options;
@@ -245,6 +246,31 @@ static uint8_t uartRead(serialPort_t *instance)
     return ch;
 }
 
+static void uartSetRxFrameCb(serialPort_t *instance, serialReceiveFrameCallbackPtr cb, uint8_t *frameBuffer, uint16_t frameBufferSize)
+{
+    uartPort_t *uartPort = (uartPort_t *)instance;
+    uartPort->port.rxFrameBuffer = frameBuffer;
+    uartPort->port.rxFrameBufferSize = frameBufferSize;
+    uartPort->port.rxFrameLength = 0;
+    uartPort->port.rxFrameCallback = cb;
+    // Enables the idle line interrupt
+    uartReconfigure(uartPort);
+}
+
+// Called from the IRQ handler in frame mode when the line goes idle
+void uartRxFrameIdle(uartPort_t *s)
+{
+#ifdef USE_DMA
+    // The DMA has stored the frame in the rx buffer, move it to the frame buffer
+    if (s->rxDMAResource) {
+        while (uartTotalRxBytesWaiting(&s->port)) {
+            serialRxFrameByte(&s->port, uartRead(&s->port));
+        }
+    }
+#endif
+    serialRxFrameIdle(&s->port);
+}
+
 static void uartWrite(serialPort_t *instance, uint8_t ch)
 {
     uartPort_t *s = (uartPort_t *)instance;
@@ -282,6 +308,7 @@ const struct serialPortVTable uartVTable[] = {
         .setMode = uartSetMode,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
+        .setRxFrameCb = uartSetRxFrameCb,
         .writeBuf = NULL,
         .beginWrite = NULL,
         .endWrite = NULL,
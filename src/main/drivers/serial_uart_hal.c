@@ -141,6 +141,16 @@ void uartReconfigure(uartPort_t *uartPort)
             HAL_UART_Receive_DMA(&uartPort->Handle, (uint8_t*)uartPort->port.rxBuffer, uartPort->port.rxBufferSize);
 
             uartPort->rxDMAPos = __HAL_DMA_GET_COUNTER(&uartPort->rxDMAHandle);
+
+            if (uartPort->port.rxFrameCallback) {
+                /* Enable Idle Line detection, for the end of a frame */
+                SET_BIT(uartPort->USARTx->CR1, USART_CR1_IDLEIE);
+
+                /* Only ports in frame mode take the UART interrupt with RX DMA */
+                const uartHardware_t *hardware = ((uartDevice_t *)uartPort)->hardware;
+                HAL_NVIC_SetPriority(hardware->rxIrq, NVIC_PRIORITY_BASE(hardware->rxPriority), NVIC_PRIORITY_SUB(hardware->rxPriority));
+                HAL_NVIC_EnableIRQ(hardware->rxIrq);
+            }
         } else
 #endif
         {
@@ -275,10 +285,13 @@ void uartIrqHandler(uartPort_t *s)
 {
     UART_HandleTypeDef *huart = &s->Handle;
     /* UART in mode Receiver ---------------------------------------------------*/
-    if ((__HAL_UART_GET_IT(huart, UART_IT_RXNE) != RESET)) {
+    // The IRQ is also enabled with RX DMA, for the idle line interrupt, so check the source is enabled
+    if ((__HAL_UART_GET_IT(huart, UART_IT_RXNE) != RESET) && (__HAL_UART_GET_IT_SOURCE(huart, UART_IT_RXNE) != RESET)) {
         uint8_t rbyte = (uint8_t)(huart->Instance->RDR & (uint8_t) 0xff);
 
-        if (s->port.rxCallback) {
+        if (s->port.rxFrameCallback) {
+            serialRxFrameByte(&s->port, rbyte);
+        } else if (s->port.rxCallback) {
             s->port.rxCallback(rbyte, s->port.rxCallbackData);
         } else {
             s->port.rxBuffer[s->port.rxBufferHead] = rbyte;
@@ -353,6 +366,9 @@ void uartIrqHandler(uartPort_t *s)
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
+        if (s->port.rxFrameCallback) {
+            uartRxFrameIdle(s);
+        }
 
         __HAL_UART_CLEAR_IDLEFLAG(huart);
     }
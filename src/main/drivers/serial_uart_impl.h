@@ -205,6 +205,7 @@ void uartTryStartTxDMA(uartPort_t *s);
 uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options);
 
 void uartIrqHandler(uartPort_t *s);
+void uartRxFrameIdle(uartPort_t *s);
 
 void uartReconfigure(uartPort_t *uartPort);
 
@@ -150,6 +150,21 @@ void uartReconfigure(uartPort_t *uartPort)
             xDMA_Cmd(uartPort->rxDMAResource, ENABLE);
             USART_DMACmd(uartPort->USARTx, USART_DMAReq_Rx, ENABLE);
             uartPort->rxDMAPos = xDMA_GetCurrDataCounter(uartPort->rxDMAResource);
+
+            if (uartPort->port.rxFrameCallback) {
+                // The end of a frame
+                USART_ITConfig(uartPort->USARTx, USART_IT_IDLE, ENABLE);
+
+                // Only ports in frame mode take the UART interrupt with RX DMA
+                const uartHardware_t *hardware = ((uartDevice_t *)uartPort)->hardware;
+                NVIC_InitTypeDef NVIC_InitStructure;
+
+                NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
+                NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = NVIC_PRIORITY_BASE(hardware->rxPriority);
+                NVIC_InitStructure.NVIC_IRQChannelSubPriority = NVIC_PRIORITY_SUB(hardware->rxPriority);
+                NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+                NVIC_Init(&NVIC_InitStructure);
+            }
         } else {
             USART_ClearITPendingBit(uartPort->USARTx, USART_IT_RXNE);
             USART_ITConfig(uartPort->USARTx, USART_IT_RXNE, ENABLE);
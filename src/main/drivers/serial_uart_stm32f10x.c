@@ -195,7 +195,9 @@ void uartIrqHandler(uartPort_t *s)
 
     if (SR & USART_FLAG_RXNE && !s->rxDMAResource) {
         // If we registered a callback, pass crap there
-        if (s->port.rxCallback) {
+        if (s->port.rxFrameCallback) {
+            serialRxFrameByte(&s->port, s->USARTx->DR);
+        } else if (s->port.rxCallback) {
             s->port.rxCallback(s->USARTx->DR, s->port.rxCallbackData);
         } else {
             s->port.rxBuffer[s->port.rxBufferHead++] = s->USARTx->DR;
@@ -204,7 +206,7 @@ void uartIrqHandler(uartPort_t *s)
             }
         }
     }
-    if (SR & USART_FLAG_TXE) {
+    if (SR & USART_FLAG_TXE && !s->txDMAResource) {
         if (s->port.txBufferTail != s->port.txBufferHead) {
             s->USARTx->DR = s->port.txBuffer[s->port.txBufferTail++];
             if (s->port.txBufferTail >= s->port.txBufferSize) {
@@ -218,6 +220,9 @@ void uartIrqHandler(uartPort_t *s)
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
+        if (s->port.rxFrameCallback) {
+            uartRxFrameIdle(s);
+        }
 
         const uint32_t read_to_clear = s->USARTx->DR;
         (void) read_to_clear;
@@ -283,7 +283,9 @@ void uartIrqHandler(uartPort_t *s)
     uint32_t ISR = s->USARTx->ISR;
 
     if (!s->rxDMAResource && (ISR & USART_FLAG_RXNE)) {
-        if (s->port.rxCallback) {
+        if (s->port.rxFrameCallback) {
+            serialRxFrameByte(&s->port, s->USARTx->RDR);
+        } else if (s->port.rxCallback) {
             s->port.rxCallback(s->USARTx->RDR, s->port.rxCallbackData);
         } else {
             s->port.rxBuffer[s->port.rxBufferHead++] = s->USARTx->RDR;
@@ -313,6 +315,9 @@ void uartIrqHandler(uartPort_t *s)
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
+        if (s->port.rxFrameCallback) {
+            uartRxFrameIdle(s);
+        }
 
         USART_ClearITPendingBit(s->USARTx, USART_IT_IDLE);
     }
@@ -312,7 +312,9 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
 void uartIrqHandler(uartPort_t *s)
 {
     if (!s->rxDMAResource && (USART_GetITStatus(s->USARTx, USART_IT_RXNE) == SET)) {
-        if (s->port.rxCallback) {
+        if (s->port.rxFrameCallback) {
+            serialRxFrameByte(&s->port, s->USARTx->DR);
+        } else if (s->port.rxCallback) {
             s->port.rxCallback(s->USARTx->DR, s->port.rxCallbackData);
         } else {
             s->port.rxBuffer[s->port.rxBufferHead] = s->USARTx->DR;
@@ -337,6 +339,9 @@ void uartIrqHandler(uartPort_t *s)
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
+        if (s->port.rxFrameCallback) {
+            uartRxFrameIdle(s);
+        }
 
         // clear
         (void) s->USARTx->SR;
@@ -210,6 +210,7 @@ static const struct serialPortVTable usbVTable[] = {
         .setMode = usbVcpSetMode,
         .setCtrlLineStateCb = usbVcpSetCtrlLineStateCb,
         .setBaudRateCb = usbVcpSetBaudRateCb,
+        .setRxFrameCb = NULL,
         .writeBuf = usbVcpWriteBuf,
         .beginWrite = usbVcpBeginWrite,
         .endWrite = usbVcpEndWrite
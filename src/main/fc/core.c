@@ -53,6 +53,7 @@
 #include "config/config.h"
 #include "fc/controlrate_profile.h"
 #include "fc/core.h"
+#include "fc/latency_trace.h"
 #include "fc/rc.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
@@ -1174,6 +1175,7 @@ static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
     }
 
     mixTable(currentTimeUs, currentPidProfile->vbatPidCompensation);
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_MIXER);
 
 #ifdef USE_SERVOS
     // motor outputs are used as sources for servo mixing, so motors must be calculated using mixTable() before servos.
@@ -1183,6 +1185,7 @@ static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
 #endif
 
     writeMotors();
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_MOTOR);
 
 #ifdef USE_DSHOT_TELEMETRY_STATS
     if (debugMode == DEBUG_DSHOT_RPM_ERRORS && useDshotTelemetry) {
@@ -1221,8 +1224,11 @@ static FAST_CODE_NOINLINE void subTaskRcCommand(timeUs_t currentTimeUs)
 
 FAST_CODE void taskGyroSample(timeUs_t currentTimeUs)
 {
-    UNUSED(currentTimeUs);
     gyroUpdate();
+#ifdef USE_BLACKBOX
+    // Every sample, before the downsampling to the PID loop rate
+    blackboxCaptureGyroRaw(currentTimeUs, gyro.rawSensorDev->gyroADCRaw);
+#endif
     if (pidUpdateCounter % activePidLoopDenom == 0) {
         pidUpdateCounter = 0;
     }
@@ -1268,7 +1274,9 @@ FAST_CODE void taskMainPidLoop(timeUs_t currentTimeUs)
     DEBUG_SET(DEBUG_PIDLOOP, 0, micros() - currentTimeUs);
 
     subTaskRcCommand(currentTimeUs);
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_RC_SMOOTHING);
     subTaskPidController(currentTimeUs);
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_PID);
     subTaskMotorUpdate(currentTimeUs);
     subTaskPidSubprocesses(currentTimeUs);
 
@@ -430,8 +430,7 @@ void init(void)
 
     initEEPROM();
 
-    ensureEEPROMStructureIsValid();
-
+    // the EEPROM structure is validated while it is read, an invalid EEPROM is reset below
     bool readSuccess = readEEPROM();
 
 #if defined(USE_BOARD_INFO)
@@ -0,0 +1,142 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_LATENCY_TRACE
+
+#include "common/maths.h"
+
+#include "drivers/time.h"
+
+#include "fc/latency_trace.h"
+
+uint8_t latencyTraceNextStage = LATENCY_STAGE_COUNT;
+
+const char * const latencyStageNames[LATENCY_STAGE_COUNT] = {
+    "RX", "RC_COMMAND", "RC_SMOOTHING", "PID", "MIXER", "MOTOR"
+};
+
+static timeUs_t traceFrameTimeUs;
+static uint16_t traceStageUs[LATENCY_STAGE_COUNT];
+static uint16_t lastStageUs[LATENCY_STAGE_COUNT];
+
+static uint16_t motorLatencyUs[LATENCY_TRACE_WINDOW];
+static uint8_t motorLatencyIndex;
+static uint16_t motorLatencyCount;
+
+// Halved when the count reaches the window size, so the averages follow recent traces
+static uint32_t stageSumUs[LATENCY_STAGE_COUNT];
+static uint16_t stageSumCount;
+
+// Called with the arrival time of every RX frame the protocol timestamps
+void latencyTraceFrame(timeUs_t frameTimeUs)
+{
+    // A frame that has not reached the motors yet is dropped in favour of the new one
+    traceFrameTimeUs = frameTimeUs;
+    latencyTraceNextStage = LATENCY_STAGE_RX;
+}
+
+void latencyTraceRecordStage(latencyStage_e stage)
+{
+    const timeDelta_t latencyUs = cmpTimeUs(micros(), traceFrameTimeUs);
+    traceStageUs[stage] = constrain(latencyUs, 0, UINT16_MAX);
+
+    if (stage + 1 < LATENCY_STAGE_COUNT) {
+        latencyTraceNextStage = stage + 1;
+        return;
+    }
+
+    // The frame has reached the motors
+    latencyTraceNextStage = LATENCY_STAGE_COUNT;
+    memcpy(lastStageUs, traceStageUs, sizeof(lastStageUs));
+
+    motorLatencyUs[motorLatencyIndex] = traceStageUs[LATENCY_STAGE_MOTOR];
+    motorLatencyIndex = (motorLatencyIndex + 1) % LATENCY_TRACE_WINDOW;
+    if (motorLatencyCount < LATENCY_TRACE_WINDOW) {
+        motorLatencyCount++;
+    }
+
+    if (stageSumCount >= LATENCY_TRACE_WINDOW) {
+        for (int i = 0; i < LATENCY_STAGE_COUNT; i++) {
+            stageSumUs[i] /= 2;
+        }
+        stageSumCount /= 2;
+    }
+    for (int i = 0; i < LATENCY_STAGE_COUNT; i++) {
+        stageSumUs[i] += traceStageUs[i];
+    }
+    stageSumCount++;
+}
+
+// The stages of the last frame traced through to the motors
+uint16_t latencyTraceLastUs(latencyStage_e stage)
+{
+    return lastStageUs[stage];
+}
+
+void latencyTraceGetStats(latencyTraceStats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+
+    const int count = motorLatencyCount;
+    if (count == 0) {
+        return;
+    }
+
+    // Sort a copy, this is only done on request
+    uint16_t sorted[LATENCY_TRACE_WINDOW];
+    uint32_t sum = 0;
+    for (int i = 0; i < count; i++) {
+        const uint16_t value = motorLatencyUs[i];
+        int j = i;
+        for (; j > 0 && sorted[j - 1] > value; j--) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = value;
+        sum += value;
+    }
+
+    stats->sampleCount = count;
+    stats->minUs = sorted[0];
+    stats->avgUs = sum / count;
+    stats->p99Us = sorted[(count * 99 + 99) / 100 - 1]; // nearest rank
+    stats->maxUs = sorted[count - 1];
+    for (int i = 0; i < LATENCY_STAGE_COUNT; i++) {
+        stats->stageAvgUs[i] = stageSumUs[i] / stageSumCount;
+    }
+}
+
+void latencyTraceReset(void)
+{
+    latencyTraceNextStage = LATENCY_STAGE_COUNT;
+    memset(lastStageUs, 0, sizeof(lastStageUs));
+    motorLatencyIndex = 0;
+    motorLatencyCount = 0;
+    memset(stageSumUs, 0, sizeof(stageSumUs));
+    stageSumCount = 0;
+}
+
+#endif
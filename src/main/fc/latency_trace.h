@@ -0,0 +1,76 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common/time.h"
+
+/*
+ * Stick to motor latency tracer.
+ *
+ * Each RX frame with a timestamp is followed from its arrival through the
+ * stages below, the time of the first pass through each stage after the
+ * frame arrived is recorded relative to the arrival. A trace is complete
+ * when the motors have been written.
+ */
+
+typedef enum {
+    LATENCY_STAGE_RX = 0,           // processRx() has decoded the frame
+    LATENCY_STAGE_RC_COMMAND,       // updateRcCommands()
+    LATENCY_STAGE_RC_SMOOTHING,     // processRcCommand() in the PID loop
+    LATENCY_STAGE_PID,              // pidController()
+    LATENCY_STAGE_MIXER,            // mixTable()
+    LATENCY_STAGE_MOTOR,            // writeMotors()
+    LATENCY_STAGE_COUNT
+} latencyStage_e;
+
+#define LATENCY_TRACE_WINDOW 128    // stick to motor samples kept for the statistics
+
+typedef struct latencyTraceStats_s {
+    uint16_t sampleCount;
+    uint16_t minUs;
+    uint16_t avgUs;
+    uint16_t p99Us;
+    uint16_t maxUs;
+    uint16_t stageAvgUs[LATENCY_STAGE_COUNT];   // from the frame arriving to the end of each stage
+} latencyTraceStats_t;
+
+#ifdef USE_LATENCY_TRACE
+
+extern uint8_t latencyTraceNextStage;
+extern const char * const latencyStageNames[LATENCY_STAGE_COUNT];
+
+void latencyTraceFrame(timeUs_t frameTimeUs);
+void latencyTraceRecordStage(latencyStage_e stage);
+uint16_t latencyTraceLastUs(latencyStage_e stage);
+void latencyTraceGetStats(latencyTraceStats_t *stats);
+void latencyTraceReset(void);
+
+// Only reads the time while a frame is being traced, so it is cheap enough for the PID loop
+#define LATENCY_TRACE_STAGE(stage) do { if (latencyTraceNextStage == (stage)) { latencyTraceRecordStage(stage); } } while (0)
+
+#else
+
+#define LATENCY_TRACE_STAGE(stage) do {} while (0)
+
+#endif
@@ -40,6 +40,7 @@
 #include "fc/rc.h"
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
+#include "fc/rc_prediction.h"
 #include "fc/runtime_config.h"
 
 #include "flight/failsafe.h"
@@ -72,6 +73,7 @@ static float throttlePIDAttenuation;
 static bool reverseMotors = false;
 static applyRatesFn *applyRates;
 uint16_t currentRxRefreshRate;
+timeUs_t currentRxFrameTimeUs;
 
 FAST_RAM_ZERO_INIT uint8_t interpolationChannels;
 static FAST_RAM_ZERO_INIT uint32_t rcFrameNumber;
@@ -623,6 +625,40 @@ static FAST_CODE uint8_t processRcSmoothingFilter(void)
 
     return interpolationChannels;
 }
+
+// Extrapolates the last received channel values along their current trend each pid loop,
+// using the time elapsed since the rx frame was received. A new frame is applied without
+// delay, so compared to the smoothing filter this trades a small bounded overshoot for latency.
+static FAST_CODE uint8_t processRcPrediction(void)
+{
+    static FAST_RAM_ZERO_INIT rcPrediction_t prediction[PRIMARY_CHANNEL_COUNT];
+
+    if (isRXDataNew) {
+        for (int i = 0; i < PRIMARY_CHANNEL_COUNT; i++) {
+            if ((1 << i) & interpolationChannels) {
+                rcPredictionUpdate(&prediction[i], rcCommand[i], currentRxRefreshRate);
+            }
+        }
+    }
+
+    const timeDelta_t elapsedUs = cmpTimeUs(micros(), currentRxFrameTimeUs);
+
+    for (int i = 0; i < PRIMARY_CHANNEL_COUNT; i++) {
+        if ((1 << i) & interpolationChannels) {
+            if (i == THROTTLE) {
+                rcCommand[i] = rcPredictionApply(&prediction[i], elapsedUs, PWM_RANGE_MIN, PWM_RANGE_MAX);
+            } else {
+                rcCommand[i] = rcPredictionApply(&prediction[i], elapsedUs, -500.0f, 500.0f);
+            }
+        }
+    }
+
+    DEBUG_SET(DEBUG_RC_INTERPOLATION, 0, lrintf(prediction[0].lastRxData));
+    DEBUG_SET(DEBUG_RC_INTERPOLATION, 1, lrintf(currentRxRefreshRate / 1000));
+    DEBUG_SET(DEBUG_RC_INTERPOLATION, 2, constrain(elapsedUs, 0, currentRxRefreshRate));
+
+    return interpolationChannels;
+}
 #endif // USE_RC_SMOOTHING_FILTER
 
 FAST_CODE void processRcCommand(void)
@@ -654,6 +690,9 @@ FAST_CODE void processRcCommand(void)
     case RC_SMOOTHING_TYPE_FILTER:
         updatedChannel = processRcSmoothingFilter();
         break;
+    case RC_SMOOTHING_TYPE_PREDICT:
+        updatedChannel = processRcPrediction();
+        break;
 #endif // USE_RC_SMOOTHING_FILTER
     case RC_SMOOTHING_TYPE_INTERPOLATION:
     default:
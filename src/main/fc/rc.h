@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "common/time.h"
+
 #include "fc/rc_controls.h"
 
 typedef enum {
@@ -31,6 +33,7 @@ typedef enum {
 } interpolationChannels_e;
 
 extern uint16_t currentRxRefreshRate;
+extern timeUs_t currentRxFrameTimeUs;
 
 void processRcCommand(void);
 float getSetpointRate(int axis);
@@ -0,0 +1,59 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <math.h>
+
+#include "platform.h"
+
+#ifdef USE_RC_SMOOTHING_FILTER
+
+#include "common/maths.h"
+
+#include "fc/rc_prediction.h"
+
+// Takes the channel value of a new rx frame, received frameIntervalUs after the previous one
+FAST_CODE void rcPredictionUpdate(rcPrediction_t *prediction, float rxData, timeDelta_t frameIntervalUs)
+{
+    const float step = rxData - prediction->lastRxData;
+
+    // Only extrapolate a trend confirmed by two consecutive steps in the same direction, a
+    // reversal or rx noise holds the value. Extrapolating the smaller of the two steps over at
+    // most one frame interval limits the overshoot when the stick decelerates or stops.
+    if (fabsf(step) > RC_PREDICTION_DEADBAND && step * prediction->lastRxStep > 0 && frameIntervalUs > 0) {
+        const float predictedStep = (step > 0) ? MIN(step, prediction->lastRxStep) : MAX(step, prediction->lastRxStep);
+        prediction->slope = predictedStep / frameIntervalUs;
+    } else {
+        prediction->slope = 0;
+    }
+    prediction->lastRxStep = step;
+    prediction->lastRxData = rxData;
+    prediction->frameIntervalUs = frameIntervalUs;
+}
+
+// Returns the channel value elapsedUs after the last rx frame, limited to the range of the channel
+FAST_CODE float rcPredictionApply(const rcPrediction_t *prediction, timeDelta_t elapsedUs, float min, float max)
+{
+    elapsedUs = constrain(elapsedUs, 0, prediction->frameIntervalUs);
+
+    return constrainf(prediction->lastRxData + prediction->slope * elapsedUs, min, max);
+}
+
+#endif // USE_RC_SMOOTHING_FILTER
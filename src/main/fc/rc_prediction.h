@@ -0,0 +1,38 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "common/time.h"
+
+// rcCommand steps up to this size are treated as rx noise and held
+#define RC_PREDICTION_DEADBAND 1.0f
+
+// Extrapolation of one rc channel between rx frames
+typedef struct rcPrediction_s {
+    float lastRxData;
+    float lastRxStep;
+    float slope;                // rcCommand units per microsecond
+    timeDelta_t frameIntervalUs;
+} rcPrediction_t;
+
+void rcPredictionUpdate(rcPrediction_t *prediction, float rxData, timeDelta_t frameIntervalUs);
+float rcPredictionApply(const rcPrediction_t *prediction, timeDelta_t elapsedUs, float min, float max);
@@ -24,6 +24,8 @@
 
 #include "platform.h"
 
+#include "blackbox/blackbox.h"
+
 #include "build/debug.h"
 
 #include "cli/cli.h"
@@ -48,6 +50,7 @@
 
 #include "config/config.h"
 #include "fc/core.h"
+#include "fc/latency_trace.h"
 #include "fc/rc.h"
 #include "fc/dispatch.h"
 #include "fc/rc_controls.h"
@@ -167,12 +170,16 @@ static void taskUpdateRxMain(timeUs_t currentTimeUs)
     }
 
     timeDelta_t rxFrameDeltaUs;
-    if (!rxGetFrameDelta(&rxFrameDeltaUs)) {
+    if (rxGetFrameDelta(&rxFrameDeltaUs)) {
+        currentRxFrameTimeUs = rxGetFrameTimeUs();
+    } else {
         rxFrameDeltaUs = cmpTimeUs(currentTimeUs, lastRxTimeUs); // calculate a delta here if not supplied by the protocol
+        currentRxFrameTimeUs = currentTimeUs;
     }
     lastRxTimeUs = currentTimeUs;
     currentRxRefreshRate = constrain(rxFrameDeltaUs, 1000, 30000);
     isRXDataNew = true;
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_RX);
 
 #ifdef USE_USB_CDC_HID
     if (!ARMING_FLAG(ARMED)) {
@@ -182,6 +189,7 @@ static void taskUpdateRxMain(timeUs_t currentTimeUs)
 
     // updateRcCommands sets rcCommand, which is needed by updateAltHoldState and updateSonarAltHoldState
     updateRcCommands();
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_RC_COMMAND);
     updateArmingStatus();
 }
 
@@ -280,6 +288,10 @@ void tasksInit(void)
     setTaskEnabled(TASK_BEEPER, true);
 #endif
 
+#ifdef USE_BLACKBOX
+    setTaskEnabled(TASK_BLACKBOX, blackboxConfig()->device != BLACKBOX_DEVICE_NONE);
+#endif
+
 #ifdef USE_GPS
     setTaskEnabled(TASK_GPS, featureIsEnabled(FEATURE_GPS));
 #endif
@@ -413,6 +425,10 @@ cfTask_t cfTasks[TASK_COUNT] = {
     [TASK_BEEPER] = DEFINE_TASK("BEEPER", NULL, NULL, beeperUpdate, TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW),
 #endif
 
+#ifdef USE_BLACKBOX
+    [TASK_BLACKBOX] = DEFINE_TASK("BLACKBOX", NULL, NULL, blackboxEncode, TASK_PERIOD_HZ(1000), TASK_PRIORITY_MEDIUM_HIGH), // Must keep up with the frames captured by the PID loop
+#endif
+
 #ifdef USE_GPS
     [TASK_GPS] = DEFINE_TASK("GPS", NULL, NULL, gpsUpdate, TASK_PERIOD_HZ(100), TASK_PRIORITY_MEDIUM), // Required to prevent buffer overruns if running at 115200 baud (115 bytes / period < 256 bytes buffer)
 #endif
@@ -434,7 +450,7 @@ cfTask_t cfTasks[TASK_COUNT] = {
 #endif
 
 #ifdef USE_OSD
-    [TASK_OSD] = DEFINE_TASK("OSD", NULL, NULL, osdUpdate, TASK_PERIOD_HZ(60), TASK_PRIORITY_LOW),
+    [TASK_OSD] = DEFINE_TASK("OSD", NULL, osdUpdateCheck, osdUpdate, TASK_PERIOD_HZ(OSD_TASK_FREQUENCY_HZ), TASK_PRIORITY_LOW),
 #endif
 
 #ifdef USE_TELEMETRY
@@ -83,9 +83,10 @@ static int crsfWriteString(displayPort_t *displayPort, uint8_t col, uint8_t row,
     }
     const size_t truncLen = MIN((int)strlen(s), crsfScreen.cols-col);  // truncate at colCount
     char *rowStart = &crsfScreen.buffer[row * crsfScreen.cols + col];
-    crsfScreen.pendingTransport[row] = memcmp(rowStart, s, truncLen);
-    if (crsfScreen.pendingTransport[row]) {
+    // an unchanged write must not cancel an earlier change still waiting to be sent
+    if (memcmp(rowStart, s, truncLen)) {
         memcpy(rowStart, s, truncLen);
+        crsfScreen.pendingTransport[row] = true;
     }
     return 0;
 }
@@ -206,6 +207,7 @@ displayPort_t *displayPortCrsfInit()
 {
     crsfDisplayPortSetDimensions(CRSF_DISPLAY_PORT_ROWS_MAX, CRSF_DISPLAY_PORT_COLS_MAX);
     displayInit(&crsfDisplayPort, &crsfDisplayPortVTable);
+    crsfDisplayPort.maxCmsCharsPerUpdate = CRSF_DISPLAY_PORT_CMS_CHARS_PER_UPDATE;
     return &crsfDisplayPort;
 }
 
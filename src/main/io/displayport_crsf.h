@@ -25,6 +25,8 @@
 #define CRSF_DISPLAY_PORT_ROWS_MAX          9
 #define CRSF_DISPLAY_PORT_COLS_MAX          32
 #define CRSF_DISPLAY_PORT_MAX_BUFFER_SIZE   (CRSF_DISPLAY_PORT_ROWS_MAX * CRSF_DISPLAY_PORT_COLS_MAX)
+// rows are sent one per telemetry frame, so drawing more per CMS update only queues
+#define CRSF_DISPLAY_PORT_CMS_CHARS_PER_UPDATE  (2 * CRSF_DISPLAY_PORT_COLS_MAX)
 
 typedef struct crsfDisplayPortScreen_s {
     char buffer[CRSF_DISPLAY_PORT_MAX_BUFFER_SIZE];
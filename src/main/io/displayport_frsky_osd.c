@@ -34,6 +34,7 @@
 #include "io/frsky_osd.h"
 
 static displayPort_t frskyOsdDisplayPort;
+static displaySoftLayer_t frskyOsdSoftLayer;
 
 static int grab(displayPort_t *displayPort)
 {
@@ -494,6 +495,7 @@ displayPort_t *frskyOsdDisplayPortInit(const videoSystem_e videoSystem)
 {
     if (frskyOsdInit(videoSystem)) {
         displayInit(&frskyOsdDisplayPort, &frskyOsdVTable);
+        displayInitSoftLayer(&frskyOsdDisplayPort, &frskyOsdSoftLayer);
         resync(&frskyOsdDisplayPort);
         return &frskyOsdDisplayPort;
     }
@@ -29,6 +29,8 @@
 #include "cms/cms.h"
 #include "telemetry/hott.h"
 
+#define HOTT_DISPLAY_PORT_CMS_CHARS_PER_UPDATE (2 * HOTT_TEXTMODE_DISPLAY_COLUMNS)
+
 displayPort_t hottDisplayPort;
 
 static int hottDrawScreen(displayPort_t *displayPort)
@@ -135,6 +137,7 @@ displayPort_t *displayPortHottInit()
     hottDisplayPort.useFullscreen = true;
     hottDisplayPort.rows = HOTT_TEXTMODE_DISPLAY_ROWS;
     hottDisplayPort.cols = HOTT_TEXTMODE_DISPLAY_COLUMNS;
+    hottDisplayPort.maxCmsCharsPerUpdate = HOTT_DISPLAY_PORT_CMS_CHARS_PER_UPDATE;
     return &hottDisplayPort;
 }
 
@@ -171,6 +171,13 @@ static bool isReady(displayPort_t *instance)
     return max7456IsDeviceDetected();
 }
 
+static bool getDrawWindow(const displayPort_t *displayPort, timeUs_t currentTimeUs, timeUs_t *windowStartUs)
+{
+    UNUSED(displayPort);
+
+    return max7456GetDrawWindow(currentTimeUs, windowStartUs);
+}
+
 static const displayPortVTable_t max7456VTable = {
     .grab = grab,
     .release = release,
@@ -189,6 +196,7 @@ static const displayPortVTable_t max7456VTable = {
     .layerCopy = layerCopy,
     .writeFontCharacter = writeFontCharacter,
     .isReady = isReady,
+    .getDrawWindow = getDrawWindow,
 };
 
 displayPort_t *max7456DisplayPortInit(const vcdProfile_t *vcdProfile)
@@ -27,6 +27,7 @@
 
 #ifdef USE_MSP_DISPLAYPORT
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "drivers/display.h"
@@ -38,6 +39,7 @@
 #include "msp/msp_serial.h"
 
 static displayPort_t mspDisplayPort;
+static displaySoftLayer_t mspSoftLayer;
 
 #ifdef USE_CLI
 extern uint8_t cliMode;
@@ -56,39 +58,220 @@ static int output(displayPort_t *displayPort, uint8_t cmd, uint8_t *buf, int len
     return mspSerialPush(displayPortProfileMsp()->displayPortSerial, cmd, buf, len, MSP_DIRECTION_REPLY);
 }
 
-static int heartbeat(displayPort_t *displayPort)
+// MSP V1 header and checksum bytes around each payload
+#define MSP_V1_FRAME_OVERHEAD   6
+#define SPAN_HEADER_LENGTH      4   // row, col, attr, length
+
+// The OSD draws into screen, shadow holds what the device has been sent. Only cells that differ
+// are transmitted, so the device must keep its canvas between MSP_DP_DRAW_SCREEN commands.
+typedef struct mspDisplayCanvas_s {
+    uint8_t chars[DISPLAYPORT_MSP_ROWS][DISPLAYPORT_MSP_COLS];
+    uint8_t attrs[DISPLAYPORT_MSP_ROWS][DISPLAYPORT_MSP_COLS];
+} mspDisplayCanvas_t;
+
+static mspDisplayCanvas_t screen;
+static mspDisplayCanvas_t shadow;
+static bool fullRefreshRequired;
+static uint8_t refreshRow;
+
+static int sendCommand(displayPort_t *displayPort, uint8_t subcmd)
 {
-    uint8_t subcmd[] = { 0 };
+    return output(displayPort, MSP_DISPLAYPORT, &subcmd, sizeof(subcmd));
+}
 
+static void clearCanvas(mspDisplayCanvas_t *canvas)
+{
+    memset(canvas->chars, ' ', sizeof(canvas->chars));
+    memset(canvas->attrs, 0, sizeof(canvas->attrs));
+}
+
+static int heartbeat(displayPort_t *displayPort)
+{
     // heartbeat is used to:
     // a) ensure display is not released by MW OSD software
     // b) prevent OSD Slave boards from displaying a 'disconnected' status.
-    return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+    return sendCommand(displayPort, MSP_DP_HEARTBEAT);
 }
 
 static int grab(displayPort_t *displayPort)
 {
+    // the device may have been showing something else, start from a known canvas
+    fullRefreshRequired = true;
+
     return heartbeat(displayPort);
 }
 
 static int release(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 1 };
-
-    return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+    return sendCommand(displayPort, MSP_DP_RELEASE);
 }
 
 static int clearScreen(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 2 };
+    UNUSED(displayPort);
+
+    clearCanvas(&screen);
+
+    return 0;
+}
+
+// Forces every cell of a row to be resent, the version bit is never set in an attribute sent to the device
+static void invalidateRow(uint8_t row)
+{
+    for (int col = 0; col < DISPLAYPORT_MSP_COLS; col++) {
+        shadow.attrs[row][col] = screen.attrs[row][col] ^ DISPLAYPORT_MSP_ATTR_VERSION;
+    }
+}
 
-    return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+static bool cellChanged(uint8_t row, uint8_t col)
+{
+    return screen.chars[row][col] != shadow.chars[row][col] || screen.attrs[row][col] != shadow.attrs[row][col];
+}
+
+// Finds the next span of changed cells in a row at or after *col. A span has a single attribute and
+// includes unchanged cells between changes when resending them is cheaper than starting a new span.
+// Returns the span length, or 0 if the rest of the row is unchanged.
+static int findChangedSpan(const displayPort_t *displayPort, uint8_t row, uint8_t *col, int maxGap, int maxLength)
+{
+    int start = *col;
+    while (start < displayPort->cols && !cellChanged(row, start)) {
+        start++;
+    }
+    if (start >= displayPort->cols) {
+        return 0;
+    }
+
+    const uint8_t attr = screen.attrs[row][start];
+    int end = start + 1;
+    for (int pos = end; pos < displayPort->cols && pos - start < maxLength && screen.attrs[row][pos] == attr; pos++) {
+        if (cellChanged(row, pos)) {
+            end = pos + 1;
+        } else if (pos + 1 - end > maxGap) {
+            break;
+        }
+    }
+
+    *col = start;
+    return end - start;
+}
+
+static void commitSpan(uint8_t row, uint8_t col, uint8_t attr, const uint8_t *chars, int len)
+{
+    memcpy(&shadow.chars[row][col], chars, len);
+    memset(&shadow.attrs[row][col], attr, len);
+}
+
+// Each span is sent as its own MSP_DP_WRITE_STRING frame
+static int drawStringSpans(displayPort_t *displayPort)
+{
+    uint8_t buf[DISPLAYPORT_MSP_MAX_STRING_LENGTH + 4];
+    int bytesSent = 0;
+
+    buf[0] = MSP_DP_WRITE_STRING;
+    for (uint8_t row = 0; row < displayPort->rows; row++) {
+        uint8_t col = 0;
+        int len;
+        while ((len = findChangedSpan(displayPort, row, &col, SPAN_HEADER_LENGTH + MSP_V1_FRAME_OVERHEAD, DISPLAYPORT_MSP_MAX_STRING_LENGTH))) {
+            buf[1] = row;
+            buf[2] = col;
+            buf[3] = screen.attrs[row][col];
+            memcpy(&buf[4], &screen.chars[row][col], len);
+            const int sent = output(displayPort, MSP_DISPLAYPORT, buf, len + 4);
+            if (!sent) {
+                // out of TX buffer, the rest goes with the next draw
+                return bytesSent;
+            }
+            bytesSent += sent;
+            commitSpan(row, col, buf[3], &buf[4], len);
+            col += len;
+        }
+    }
+
+    return bytesSent;
+}
+
+static int flushSpansFrame(displayPort_t *displayPort, uint8_t *buf, int frameLength)
+{
+    const int sent = output(displayPort, MSP_DISPLAYPORT, buf, frameLength);
+    if (sent) {
+        for (int pos = 1; pos < frameLength; pos += SPAN_HEADER_LENGTH + buf[pos + 3]) {
+            commitSpan(buf[pos], buf[pos + 1], buf[pos + 2], &buf[pos + SPAN_HEADER_LENGTH], buf[pos + 3]);
+        }
+    }
+
+    return sent;
+}
+
+// Spans are packed into as few MSP_DP_WRITE_SPANS frames as possible
+static int drawPackedSpans(displayPort_t *displayPort)
+{
+    uint8_t buf[DISPLAYPORT_MSP_MAX_SPANS_LENGTH];
+    int frameLength = 1;
+    int bytesSent = 0;
+
+    buf[0] = MSP_DP_WRITE_SPANS;
+    for (uint8_t row = 0; row < displayPort->rows; row++) {
+        uint8_t col = 0;
+        int len;
+        while ((len = findChangedSpan(displayPort, row, &col, SPAN_HEADER_LENGTH, DISPLAYPORT_MSP_COLS))) {
+            if (frameLength + SPAN_HEADER_LENGTH + len > DISPLAYPORT_MSP_MAX_SPANS_LENGTH) {
+                const int sent = flushSpansFrame(displayPort, buf, frameLength);
+                if (!sent) {
+                    return bytesSent;
+                }
+                bytesSent += sent;
+                frameLength = 1;
+            }
+            buf[frameLength] = row;
+            buf[frameLength + 1] = col;
+            buf[frameLength + 2] = screen.attrs[row][col];
+            buf[frameLength + 3] = len;
+            memcpy(&buf[frameLength + SPAN_HEADER_LENGTH], &screen.chars[row][col], len);
+            frameLength += SPAN_HEADER_LENGTH + len;
+            col += len;
+        }
+    }
+
+    if (frameLength > 1) {
+        bytesSent += flushSpansFrame(displayPort, buf, frameLength);
+    }
+
+    return bytesSent;
 }
 
 static int drawScreen(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 4 };
-    return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+#ifdef USE_CLI
+    if (cliMode) {
+        return 0;
+    }
+#endif
+
+    int bytesSent = 0;
+
+    if (fullRefreshRequired) {
+        if (!sendCommand(displayPort, MSP_DP_CLEAR_SCREEN)) {
+            return 0;
+        }
+        clearCanvas(&shadow);
+        fullRefreshRequired = false;
+    }
+
+    // Resend one row per draw so that a device which connects late or loses a frame catches up
+    invalidateRow(refreshRow);
+    refreshRow = (refreshRow + 1) % displayPort->rows;
+
+    if (displayPortProfileMsp()->useSpanUpdates) {
+        bytesSent += drawPackedSpans(displayPort);
+    } else {
+        bytesSent += drawStringSpans(displayPort);
+    }
+
+    if (bytesSent) {
+        bytesSent += sendCommand(displayPort, MSP_DP_DRAW_SCREEN);
+    }
+
+    return bytesSent;
 }
 
 static int screenSize(const displayPort_t *displayPort)
@@ -98,35 +281,27 @@ static int screenSize(const displayPort_t *displayPort)
 
 static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t attr, const char *string)
 {
-#define MSP_OSD_MAX_STRING_LENGTH 30 // FIXME move this
-    uint8_t buf[MSP_OSD_MAX_STRING_LENGTH + 4];
-
-    int len = strlen(string);
-    if (len >= MSP_OSD_MAX_STRING_LENGTH) {
-        len = MSP_OSD_MAX_STRING_LENGTH;
+    if (row >= displayPort->rows || col >= displayPort->cols) {
+        return 0;
     }
 
-    buf[0] = 3;
-    buf[1] = row;
-    buf[2] = col;
-    buf[3] = displayPortProfileMsp()->attrValues[attr] & ~DISPLAYPORT_MSP_ATTR_BLINK & DISPLAYPORT_MSP_ATTR_MASK;
-
+    uint8_t mspAttr = displayPortProfileMsp()->attrValues[attr & ~DISPLAYPORT_ATTR_BLINK] & ~DISPLAYPORT_MSP_ATTR_BLINK & DISPLAYPORT_MSP_ATTR_MASK;
     if (attr & DISPLAYPORT_ATTR_BLINK) {
-        buf[3] |= DISPLAYPORT_MSP_ATTR_BLINK;
+        mspAttr |= DISPLAYPORT_MSP_ATTR_BLINK;
     }
 
-    memcpy(&buf[4], string, len);
+    const int len = MIN((int)strlen(string), displayPort->cols - col);
+    memcpy(&screen.chars[row][col], string, len);
+    memset(&screen.attrs[row][col], mspAttr, len);
 
-    return output(displayPort, MSP_DISPLAYPORT, buf, len + 4);
+    return 0;
 }
 
 static int writeChar(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t attr, uint8_t c)
 {
-    char buf[2];
+    const char buf[2] = { c, 0 };
 
-    buf[0] = c;
-    buf[1] = 0;
-    return writeString(displayPort, col, row, attr, buf); //!!TODO - check if there is a direct MSP command to do this
+    return writeString(displayPort, col, row, attr, buf);
 }
 
 static bool isTransferInProgress(const displayPort_t *displayPort)
@@ -138,13 +313,14 @@ static bool isTransferInProgress(const displayPort_t *displayPort)
 static bool isSynced(const displayPort_t *displayPort)
 {
     UNUSED(displayPort);
-    return true;
+    return !fullRefreshRequired && memcmp(&screen, &shadow, sizeof(screen)) == 0;
 }
 
 static void resync(displayPort_t *displayPort)
 {
-    displayPort->rows = 13 + displayPortProfileMsp()->rowAdjust; // XXX Will reflect NTSC/PAL in the future
-    displayPort->cols = 30 + displayPortProfileMsp()->colAdjust;
+    displayPort->rows = DISPLAYPORT_MSP_ROWS + displayPortProfileMsp()->rowAdjust; // XXX Will reflect NTSC/PAL in the future
+    displayPort->cols = DISPLAYPORT_MSP_COLS + displayPortProfileMsp()->colAdjust;
+    fullRefreshRequired = true;
     drawScreen(displayPort);
 }
 
@@ -190,6 +366,7 @@ displayPort_t *displayPortMspInit(void)
 #endif
 
     displayInit(&mspDisplayPort, &mspDisplayPortVTable);
+    displayInitSoftLayer(&mspDisplayPort, &mspSoftLayer);
 
     if (displayPortProfileMsp()->useDeviceBlink) {
         mspDisplayPort.useDeviceBlink = true;
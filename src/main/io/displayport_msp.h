@@ -29,4 +29,20 @@
 #define DISPLAYPORT_MSP_ATTR_BLINK   BIT(6) // Device local blink
 #define DISPLAYPORT_MSP_ATTR_MASK    (~(DISPLAYPORT_MSP_ATTR_VERSION|DISPLAYPORT_MSP_ATTR_BLINK))
 
+// MSP_DISPLAYPORT subcommands
+typedef enum {
+    MSP_DP_HEARTBEAT = 0,
+    MSP_DP_RELEASE = 1,
+    MSP_DP_CLEAR_SCREEN = 2,
+    MSP_DP_WRITE_STRING = 3,   // row, col, attr, string
+    MSP_DP_DRAW_SCREEN = 4,
+    MSP_DP_WRITE_SPANS = 7,    // one or more of: row, col, attr, length, chars[length]
+} displayPortMspCommand_e;
+
+#define DISPLAYPORT_MSP_ROWS            13
+#define DISPLAYPORT_MSP_COLS            30
+#define DISPLAYPORT_MSP_MAX_STRING_LENGTH 30
+// Largest MSP_DP_WRITE_SPANS payload, kept below the MSP V1 jumbo frame size marker
+#define DISPLAYPORT_MSP_MAX_SPANS_LENGTH  240
+
 struct displayPort_s *displayPortMspInit(void);
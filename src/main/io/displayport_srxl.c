@@ -32,6 +32,8 @@
 
 #include "telemetry/srxl.h"
 
+#define SRXL_DISPLAY_PORT_CMS_CHARS_PER_UPDATE (2 * SPEKTRUM_SRXL_TEXTGEN_BUFFER_COLS)
+
 displayPort_t srxlDisplayPort;
 
 static int srxlDrawScreen(displayPort_t *displayPort)
@@ -144,6 +146,7 @@ displayPort_t *displayPortSrxlInit()
     displayInit(&srxlDisplayPort, &srxlVTable);
     srxlDisplayPort.rows = SPEKTRUM_SRXL_TEXTGEN_BUFFER_ROWS;
     srxlDisplayPort.cols = SPEKTRUM_SRXL_TEXTGEN_BUFFER_COLS;
+    srxlDisplayPort.maxCmsCharsPerUpdate = SRXL_DISPLAY_PORT_CMS_CHARS_PER_UPDATE;
     return &srxlDisplayPort;
 }
 
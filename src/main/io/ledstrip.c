@@ -153,6 +153,10 @@ STATIC_UNIT_TESTED int8_t lowestXValueForEast;
 
 STATIC_UNIT_TESTED ledCounts_t ledCounts;
 
+STATIC_UNIT_TESTED ledStripPlan_t ledStripPlan;
+
+STATIC_ASSERT(LED_MAX_STRIP_LENGTH <= sizeof(ledStripPlan.functionLeds[0]) * 8, ledStripPlan_mask_too_small);
+
 static const modeColorIndexes_t defaultModeColors[] = {
     //                          NORTH             EAST               SOUTH            WEST             UP          DOWN
     [LED_MODE_ORIENTATION] = {{ COLOR_WHITE,      COLOR_DARK_VIOLET, COLOR_RED,       COLOR_DEEP_PINK, COLOR_BLUE, COLOR_ORANGE }},
@@ -272,11 +276,77 @@ STATIC_UNIT_TESTED void updateLedCount(void)
     setUsedLedCount(ledCounts.count);
 }
 
+typedef enum {
+    // the ordering is important, see below how NSEW is mapped to  NE/SE/NW/SW
+    QUADRANT_NORTH      = 1 << 0,
+    QUADRANT_SOUTH      = 1 << 1,
+    QUADRANT_EAST       = 1 << 2,
+    QUADRANT_WEST       = 1 << 3,
+} quadrant_e;
+
+static quadrant_e calculateLedQuadrant(const ledConfig_t *ledConfig)
+{
+    int x = ledGetX(ledConfig);
+    int y = ledGetY(ledConfig);
+
+    int quad = 0;
+    if (y <= highestYValueForNorth)
+        quad |= QUADRANT_NORTH;
+    else if (y >= lowestYValueForSouth)
+        quad |= QUADRANT_SOUTH;
+    if (x >= lowestXValueForEast)
+        quad |= QUADRANT_EAST;
+    else if (x <= highestXValueForWest)
+        quad |= QUADRANT_WEST;
+
+    return quad;
+}
+
+static int calculateModeColorDirection(const ledConfig_t *ledConfig)
+{
+    const int ledDirection = ledGetDirection(ledConfig);
+
+    for (unsigned i = 0; i < LED_DIRECTION_COUNT; i++) {
+        if (ledDirection & (1 << i)) {
+            return i;
+        }
+    }
+
+    return LED_NO_DIRECTION;
+}
+
+// Decode the led configs once, so the layers only visit the leds they own
+STATIC_UNIT_TESTED void updateLedStripPlan(void)
+{
+    memset(&ledStripPlan, 0, sizeof(ledStripPlan));
+
+    for (int ledIndex = 0; ledIndex < ledCounts.count; ledIndex++) {
+        const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[ledIndex];
+        ledPlanEntry_t *entry = &ledStripPlan.leds[ledIndex];
+        const uint32_t ledBit = 1U << ledIndex;
+
+        entry->function = ledGetFunction(ledConfig);
+        entry->color = ledGetColor(ledConfig);
+        entry->quadrant = calculateLedQuadrant(ledConfig);
+        entry->modeColorDirection = calculateModeColorDirection(ledConfig);
+
+        if (entry->function < LED_BASEFUNCTION_COUNT) {
+            ledStripPlan.functionLeds[entry->function] |= ledBit;
+        }
+        for (int overlay = 0; overlay < LED_OVERLAY_COUNT; overlay++) {
+            if (ledGetOverlayBit(ledConfig, overlay)) {
+                ledStripPlan.overlayLeds[overlay] |= ledBit;
+            }
+        }
+    }
+}
+
 void reevaluateLedConfig(void)
 {
     updateLedCount();
     updateDimensions();
     updateLedRingCounts();
+    updateLedStripPlan();
     updateRequiredOverlay();
 }
 
@@ -407,46 +477,15 @@ void generateLedConfig(ledConfig_t *ledConfig, char *ledConfigBuffer, size_t buf
     tfp_sprintf(ledConfigBuffer, "%u,%u:%s:%s:%u", ledGetX(ledConfig), ledGetY(ledConfig), directions, baseFunctionOverlays, ledGetColor(ledConfig));
 }
 
-typedef enum {
-    // the ordering is important, see below how NSEW is mapped to  NE/SE/NW/SW
-    QUADRANT_NORTH      = 1 << 0,
-    QUADRANT_SOUTH      = 1 << 1,
-    QUADRANT_EAST       = 1 << 2,
-    QUADRANT_WEST       = 1 << 3,
-} quadrant_e;
-
-static quadrant_e getLedQuadrant(const int ledIndex)
-{
-    const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[ledIndex];
-
-    int x = ledGetX(ledConfig);
-    int y = ledGetY(ledConfig);
-
-    int quad = 0;
-    if (y <= highestYValueForNorth)
-        quad |= QUADRANT_NORTH;
-    else if (y >= lowestYValueForSouth)
-        quad |= QUADRANT_SOUTH;
-    if (x >= lowestXValueForEast)
-        quad |= QUADRANT_EAST;
-    else if (x <= highestXValueForWest)
-        quad |= QUADRANT_WEST;
-
-    return quad;
-}
-
 static const hsvColor_t* getDirectionalModeColor(const int ledIndex, const modeColorIndexes_t *modeColors)
 {
-    const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[ledIndex];
-    const int ledDirection = ledGetDirection(ledConfig);
+    const int modeColorDirection = ledStripPlan.leds[ledIndex].modeColorDirection;
 
-    for (unsigned i = 0; i < LED_DIRECTION_COUNT; i++) {
-        if (ledDirection & (1 << i)) {
-            return &ledStripStatusModeConfig()->colors[modeColors->color[i]];
-        }
+    if (modeColorDirection == LED_NO_DIRECTION) {
+        return NULL;
     }
 
-    return NULL;
+    return &ledStripStatusModeConfig()->colors[modeColors->color[modeColorDirection]];
 }
 
 // map flight mode to led mode, in order of priority
@@ -466,21 +505,24 @@ static const struct {
 
 static void applyLedFixedLayers(void)
 {
+    const uint32_t throttleLeds = ledStripPlan.overlayLeds[LED_OVERLAY_THROTTLE];
+
     for (int ledIndex = 0; ledIndex < ledCounts.count; ledIndex++) {
-        const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[ledIndex];
+        const ledPlanEntry_t *entry = &ledStripPlan.leds[ledIndex];
+        const bool throttleOverlay = throttleLeds & (1U << ledIndex);
         hsvColor_t color = *getSC(LED_SCOLOR_BACKGROUND);
 
-        int fn = ledGetFunction(ledConfig);
+        int fn = entry->function;
         int hOffset = HSV_HUE_MAX + 1;
 
         switch (fn) {
         case LED_FUNCTION_COLOR:
-            color = ledStripStatusModeConfig()->colors[ledGetColor(ledConfig)];
+            color = ledStripStatusModeConfig()->colors[entry->color];
 
-            hsvColor_t nextColor = ledStripStatusModeConfig()->colors[(ledGetColor(ledConfig) + 1 + LED_CONFIGURABLE_COLOR_COUNT) % LED_CONFIGURABLE_COLOR_COUNT];
-            hsvColor_t previousColor = ledStripStatusModeConfig()->colors[(ledGetColor(ledConfig) - 1 + LED_CONFIGURABLE_COLOR_COUNT) % LED_CONFIGURABLE_COLOR_COUNT];
+            hsvColor_t nextColor = ledStripStatusModeConfig()->colors[(entry->color + 1 + LED_CONFIGURABLE_COLOR_COUNT) % LED_CONFIGURABLE_COLOR_COUNT];
+            hsvColor_t previousColor = ledStripStatusModeConfig()->colors[(entry->color - 1 + LED_CONFIGURABLE_COLOR_COUNT) % LED_CONFIGURABLE_COLOR_COUNT];
 
-            if (ledGetOverlayBit(ledConfig, LED_OVERLAY_THROTTLE)) {   //smooth fade with selected Aux channel of all HSV values from previousColor through color to nextColor
+            if (throttleOverlay) {   //smooth fade with selected Aux channel of all HSV values from previousColor through color to nextColor
                 const int auxInput = rcData[ledStripStatusModeConfig()->ledstrip_aux_channel];
                 int centerPWM = (PWM_RANGE_MIN + PWM_RANGE_MAX) / 2;
                 if (auxInput < centerPWM) {
@@ -526,7 +568,7 @@ static void applyLedFixedLayers(void)
             break;
         }
 
-        if ((fn != LED_FUNCTION_COLOR) && ledGetOverlayBit(ledConfig, LED_OVERLAY_THROTTLE)) {
+        if ((fn != LED_FUNCTION_COLOR) && throttleOverlay) {
             const int auxInput = rcData[ledStripStatusModeConfig()->ledstrip_aux_channel];
             hOffset += scaleRange(auxInput, PWM_RANGE_MIN, PWM_RANGE_MAX, 0, HSV_HUE_MAX + 1);
         }
@@ -536,12 +578,13 @@ static void applyLedFixedLayers(void)
     }
 }
 
-static void applyLedHsv(uint32_t mask, const hsvColor_t *color)
+static void applyLedHsv(uint32_t ledMask, const hsvColor_t *color)
 {
-    for (int ledIndex = 0; ledIndex < ledCounts.count; ledIndex++) {
-        const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[ledIndex];
-        if ((*ledConfig & mask) == mask)
-            setLedHsv(ledIndex, color);
+    while (ledMask) {
+        const int ledIndex = __builtin_ctz(ledMask);
+        ledMask &= ledMask - 1;
+
+        setLedHsv(ledIndex, color);
     }
 }
 
@@ -609,7 +652,7 @@ static void applyLedWarningLayer(bool updateNow, timeUs_t *timer)
     }
 
     if (warningColor) {
-        applyLedHsv(LED_MOV_OVERLAY(LED_FLAG_OVERLAY(LED_OVERLAY_WARNING)), warningColor);
+        applyLedHsv(ledStripPlan.overlayLeds[LED_OVERLAY_WARNING], warningColor);
     }
 }
 
@@ -657,27 +700,28 @@ static void applyLedVtxLayer(bool updateNow, timeUs_t *timer)
     hsvColor_t color = {0, 0, 0};
     if (showSettings) { // show settings
         uint8_t vtxLedCount = 0;
-        for (int i = 0; i < ledCounts.count && vtxLedCount < 6; ++i) {
-            const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[i];
-            if (ledGetOverlayBit(ledConfig, LED_OVERLAY_VTX)) {
-                if (vtxLedCount == 0) {
-                    color.h = HSV(GREEN).h;
-                    color.s = HSV(GREEN).s;
-                    color.v = blink ? 15 : 0; // blink received settings
-                }
-                else if (vtxLedCount > 0 && power >= vtxLedCount && !(vtxStatus & VTX_STATUS_PIT_MODE)) { // show power
-                    color.h = HSV(ORANGE).h;
-                    color.s = HSV(ORANGE).s;
-                    color.v = blink ? 15 : 0; // blink received settings
-                }
-                else { // turn rest off
-                    color.h = HSV(BLACK).h;
-                    color.s = HSV(BLACK).s;
-                    color.v = HSV(BLACK).v;
-                }
-                setLedHsv(i, &color);
-                ++vtxLedCount;
+        uint32_t vtxLeds = ledStripPlan.overlayLeds[LED_OVERLAY_VTX];
+        while (vtxLeds && vtxLedCount < 6) {
+            const int i = __builtin_ctz(vtxLeds);
+            vtxLeds &= vtxLeds - 1;
+
+            if (vtxLedCount == 0) {
+                color.h = HSV(GREEN).h;
+                color.s = HSV(GREEN).s;
+                color.v = blink ? 15 : 0; // blink received settings
+            }
+            else if (vtxLedCount > 0 && power >= vtxLedCount && !(vtxStatus & VTX_STATUS_PIT_MODE)) { // show power
+                color.h = HSV(ORANGE).h;
+                color.s = HSV(ORANGE).s;
+                color.v = blink ? 15 : 0; // blink received settings
             }
+            else { // turn rest off
+                color.h = HSV(BLACK).h;
+                color.s = HSV(BLACK).s;
+                color.v = HSV(BLACK).v;
+            }
+            setLedHsv(i, &color);
+            ++vtxLedCount;
         }
     }
     else { // show frequency
@@ -702,7 +746,7 @@ static void applyLedVtxLayer(bool updateNow, timeUs_t *timer)
         }
         hsvColor_t color = ledStripStatusModeConfig()->colors[colorIndex];
         color.v = (vtxStatus & VTX_STATUS_PIT_MODE) ? (blink ? 15 : 0) : 255; // blink when in pit mode
-        applyLedHsv(LED_MOV_OVERLAY(LED_FLAG_OVERLAY(LED_OVERLAY_VTX)), &color);
+        applyLedHsv(ledStripPlan.overlayLeds[LED_OVERLAY_VTX], &color);
     }
 }
 #endif
@@ -738,7 +782,7 @@ static void applyLedBatteryLayer(bool updateNow, timeUs_t *timer)
 
     if (!flash) {
        const hsvColor_t *bgc = getSC(LED_SCOLOR_BACKGROUND);
-       applyLedHsv(LED_MOV_FUNCTION(LED_FUNCTION_BATTERY), bgc);
+       applyLedHsv(ledStripPlan.functionLeds[LED_FUNCTION_BATTERY], bgc);
     }
 }
 
@@ -767,7 +811,7 @@ static void applyLedRssiLayer(bool updateNow, timeUs_t *timer)
 
     if (!flash) {
         const hsvColor_t *bgc = getSC(LED_SCOLOR_BACKGROUND);
-        applyLedHsv(LED_MOV_FUNCTION(LED_FUNCTION_RSSI), bgc);
+        applyLedHsv(ledStripPlan.functionLeds[LED_FUNCTION_RSSI], bgc);
     }
 }
 
@@ -805,7 +849,7 @@ static void applyLedGpsLayer(bool updateNow, timeUs_t *timer)
         }
     }
 
-    applyLedHsv(LED_MOV_FUNCTION(LED_FUNCTION_GPS), gpsColor);
+    applyLedHsv(ledStripPlan.functionLeds[LED_FUNCTION_GPS], gpsColor);
 }
 #endif
 
@@ -845,12 +889,13 @@ static void applyLedIndicatorLayer(bool updateNow, timeUs_t *timer)
         quadrants |= QUADRANT_SOUTH;
     }
 
-    for (int ledIndex = 0; ledIndex < ledCounts.count; ledIndex++) {
-        const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[ledIndex];
-        if (ledGetOverlayBit(ledConfig, LED_OVERLAY_INDICATOR)) {
-            if (getLedQuadrant(ledIndex) & quadrants)
-                setLedHsv(ledIndex, flashColor);
-        }
+    uint32_t indicatorLeds = ledStripPlan.overlayLeds[LED_OVERLAY_INDICATOR];
+    while (indicatorLeds) {
+        const int ledIndex = __builtin_ctz(indicatorLeds);
+        indicatorLeds &= indicatorLeds - 1;
+
+        if (ledStripPlan.leds[ledIndex].quadrant & quadrants)
+            setLedHsv(ledIndex, flashColor);
     }
 }
 
@@ -866,24 +911,24 @@ static void applyLedThrustRingLayer(bool updateNow, timeUs_t *timer)
         *timer += HZ_TO_US(5 + (45 * scaledThrottle) / 100);  // 5 - 50Hz update rate
     }
 
-    for (int ledIndex = 0; ledIndex < ledCounts.count; ledIndex++) {
-        const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[ledIndex];
-        if (ledGetFunction(ledConfig) == LED_FUNCTION_THRUST_RING) {
+    uint32_t ringLeds = ledStripPlan.functionLeds[LED_FUNCTION_THRUST_RING];
+    while (ringLeds) {
+        const int ledIndex = __builtin_ctz(ringLeds);
+        ringLeds &= ringLeds - 1;
 
-            bool applyColor;
-            if (ARMING_FLAG(ARMED)) {
-                applyColor = (ledRingIndex + rotationPhase) % ledCounts.ringSeqLen < ROTATION_SEQUENCE_LED_WIDTH;
-            } else {
-                applyColor = !(ledRingIndex % 2); // alternating pattern
-            }
-
-            if (applyColor) {
-                const hsvColor_t *ringColor = &ledStripStatusModeConfig()->colors[ledGetColor(ledConfig)];
-                setLedHsv(ledIndex, ringColor);
-            }
+        bool applyColor;
+        if (ARMING_FLAG(ARMED)) {
+            applyColor = (ledRingIndex + rotationPhase) % ledCounts.ringSeqLen < ROTATION_SEQUENCE_LED_WIDTH;
+        } else {
+            applyColor = !(ledRingIndex % 2); // alternating pattern
+        }
 
-            ledRingIndex++;
+        if (applyColor) {
+            const hsvColor_t *ringColor = &ledStripStatusModeConfig()->colors[ledStripPlan.leds[ledIndex].color];
+            setLedHsv(ledIndex, ringColor);
         }
+
+        ledRingIndex++;
     }
 }
 
@@ -935,17 +980,16 @@ static void applyLarsonScannerLayer(bool updateNow, timeUs_t *timer)
     }
 
     int scannerLedIndex = 0;
-    for (unsigned i = 0; i < ledCounts.count; i++) {
-
-        const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[i];
-
-        if (ledGetOverlayBit(ledConfig, LED_OVERLAY_LARSON_SCANNER)) {
-            hsvColor_t ledColor;
-            getLedHsv(i, &ledColor);
-            ledColor.v = brightnessForLarsonIndex(&larsonParameters, scannerLedIndex);
-            setLedHsv(i, &ledColor);
-            scannerLedIndex++;
-        }
+    uint32_t scannerLeds = ledStripPlan.overlayLeds[LED_OVERLAY_LARSON_SCANNER];
+    while (scannerLeds) {
+        const int i = __builtin_ctz(scannerLeds);
+        scannerLeds &= scannerLeds - 1;
+
+        hsvColor_t ledColor;
+        getLedHsv(i, &ledColor);
+        ledColor.v = brightnessForLarsonIndex(&larsonParameters, scannerLedIndex);
+        setLedHsv(i, &ledColor);
+        scannerLedIndex++;
     }
 }
 
@@ -965,13 +1009,7 @@ static void applyLedBlinkLayer(bool updateNow, timeUs_t *timer)
 
     bool ledOn = (blinkMask & 1);  // b_b_____...
     if (!ledOn) {
-        for (int i = 0; i < ledCounts.count; ++i) {
-            const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[i];
-
-            if (ledGetOverlayBit(ledConfig, LED_OVERLAY_BLINK)) {
-                setLedHsv(i, getSC(LED_SCOLOR_BLINKBACKGROUND));
-            }
-        }
+        applyLedHsv(ledStripPlan.overlayLeds[LED_OVERLAY_BLINK], getSC(LED_SCOLOR_BLINKBACKGROUND));
     }
 }
 
@@ -1023,13 +1061,7 @@ static applyLayerFn_timed* layerTable[] = {
 
 bool isOverlayTypeUsed(ledOverlayId_e overlayType)
 {
-    for (int ledIndex = 0; ledIndex < ledCounts.count; ledIndex++) {
-        const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[ledIndex];
-        if (ledGetOverlayBit(ledConfig, overlayType)) {
-            return true;
-        }
-    }
-    return false;
+    return ledStripPlan.overlayLeds[overlayType] != 0;
 }
 
 void updateRequiredOverlay(void)
@@ -171,6 +171,22 @@ typedef struct ledCounts_s {
     uint8_t ringSeqLen;
 } ledCounts_t;
 
+#define LED_NO_DIRECTION -1
+
+typedef struct ledPlanEntry_s {
+    uint8_t function;
+    uint8_t color;
+    uint8_t quadrant;
+    int8_t modeColorDirection;  // first direction set, selects the flight mode color
+} ledPlanEntry_t;
+
+// led configs decoded by reevaluateLedConfig()
+typedef struct ledStripPlan_s {
+    uint32_t functionLeds[LED_BASEFUNCTION_COUNT];  // bitmask of the leds using each base function
+    uint32_t overlayLeds[LED_OVERLAY_COUNT];        // bitmask of the leds using each overlay
+    ledPlanEntry_t leds[LED_MAX_STRIP_LENGTH];
+} ledStripPlan_t;
+
 typedef struct ledStripConfig_s {
     uint8_t ledstrip_visual_beeper;
     ioTag_t ioTag;
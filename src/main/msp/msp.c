@@ -40,6 +40,7 @@
 #include "common/bitarray.h"
 #include "common/color.h"
 #include "common/huffman.h"
+#include "common/lz.h"
 #include "common/maths.h"
 #include "common/streambuf.h"
 #include "common/utils.h"
@@ -71,6 +72,7 @@
 #include "fc/board_info.h"
 #include "fc/controlrate_profile.h"
 #include "fc/core.h"
+#include "fc/latency_trace.h"
 #include "fc/rc.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
@@ -106,6 +108,7 @@
 #include "msp/msp_protocol_v2_betaflight.h"
 #include "msp/msp_protocol_v2_common.h"
 #include "msp/msp_serial.h"
+#include "msp/msp_settings.h"
 
 #include "osd/osd.h"
 #include "osd/osd_elements.h"
@@ -460,10 +463,11 @@ static void serializeDataflashSummaryReply(sbuf_t *dst)
 #ifdef USE_FLASHFS
 enum compressionType_e {
     NO_COMPRESSION,
-    HUFFMAN
+    HUFFMAN,
+    LZ
 };
 
-static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uint16_t size, bool useLegacyFormat, bool allowCompression)
+static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uint16_t size, bool useLegacyFormat, uint8_t requestedCompression)
 {
     STATIC_ASSERT(MSP_PORT_DATAFLASH_INFO_SIZE >= 16, MSP_PORT_DATAFLASH_INFO_SIZE_invalid);
 
@@ -480,13 +484,24 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
     }
     sbufWriteU32(dst, address);
 
-    // legacy format does not support compression
+    // legacy format does not support compression, unsupported methods fall back to no compression
+    uint8_t compressionMethod = NO_COMPRESSION;
+    if (!useLegacyFormat) {
+        switch (requestedCompression) {
 #ifdef USE_HUFFMAN
-    const uint8_t compressionMethod = (!allowCompression || useLegacyFormat) ? NO_COMPRESSION : HUFFMAN;
-#else
-    const uint8_t compressionMethod = NO_COMPRESSION;
-    UNUSED(allowCompression);
+        case HUFFMAN:
+            compressionMethod = HUFFMAN;
+            break;
+#endif
+#ifdef USE_LZ
+        case LZ:
+            compressionMethod = LZ;
+            break;
 #endif
+        default:
+            break;
+        }
+    }
 
     if (compressionMethod == NO_COMPRESSION) {
 
@@ -512,8 +527,8 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
                 sbufWriteU8(dst, 0);
             }
         }
-    } else {
 #ifdef USE_HUFFMAN
+    } else if (compressionMethod == HUFFMAN) {
         // compress in 256-byte chunks
         const uint16_t READ_BUFFER_SIZE = 256;
         uint8_t readBuffer[READ_BUFFER_SIZE];
@@ -551,6 +566,41 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uin
         // payload
         sbufWriteU16(dst, bytesReadTotal);
         sbufAdvance(dst, state.bytesWritten);
+#endif
+#ifdef USE_LZ
+    } else if (compressionMethod == LZ) {
+        // compress in 256-byte blocks, each sized so that it fits even if it is incompressible
+        uint8_t readBuffer[LZ_MAX_BLOCK_SIZE];
+
+        lzState_t state = {
+            .bytesWritten = 0,
+            .outByte = sbufPtr(dst) + sizeof(uint16_t) + sizeof(uint8_t) + LZ_INFO_SIZE,
+            .outBufLen = readLen,
+        };
+
+        uint16_t bytesReadTotal = 0;
+        // read until output buffer is full, flash is exhausted or the uncompressed count would overflow
+        while (address + bytesReadTotal < flashfsSize) {
+            const int outBytesRemaining = state.outBufLen - state.bytesWritten - LZ_BLOCK_OVERHEAD;
+            const uint32_t readLimit = MIN(MIN(flashfsSize - address - bytesReadTotal, (uint32_t)(UINT16_MAX - bytesReadTotal)), sizeof(readBuffer));
+            if (outBytesRemaining <= 0 || readLimit == 0) {
+                break;
+            }
+
+            const int bytesRead = flashfsReadAbs(address + bytesReadTotal, readBuffer, MIN((uint32_t)outBytesRemaining, readLimit));
+            if (bytesRead <= 0 || lzEncodeBufStreaming(&state, readBuffer, bytesRead) == -1) {
+                break;
+            }
+
+            bytesReadTotal += bytesRead;
+        }
+
+        // header
+        sbufWriteU16(dst, LZ_INFO_SIZE + state.bytesWritten);
+        sbufWriteU8(dst, compressionMethod);
+        // payload
+        sbufWriteU16(dst, bytesReadTotal);
+        sbufAdvance(dst, state.bytesWritten);
 #endif
     }
 }
@@ -1883,6 +1933,24 @@ static bool mspProcessOutCommand(int16_t cmdMSP, sbuf_t *dst)
 
         break;
 #endif
+#ifdef USE_LATENCY_TRACE
+    case MSP2_BETAFLIGHT_LATENCY:
+        {
+            latencyTraceStats_t stats;
+            latencyTraceGetStats(&stats);
+            sbufWriteU16(dst, stats.sampleCount);
+            sbufWriteU16(dst, stats.minUs);
+            sbufWriteU16(dst, stats.avgUs);
+            sbufWriteU16(dst, stats.p99Us);
+            sbufWriteU16(dst, stats.maxUs);
+            sbufWriteU8(dst, LATENCY_STAGE_COUNT);
+            for (int i = 0; i < LATENCY_STAGE_COUNT; i++) {
+                sbufWriteU16(dst, stats.stageAvgUs[i]);
+            }
+        }
+
+        break;
+#endif
     default:
         unsupportedCommand = true;
     }
@@ -2046,6 +2114,14 @@ static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, int16_
         }
 
         break;
+#ifdef USE_MSP_SETTINGS
+    case MSP2_BETAFLIGHT_SETTINGS:
+        if (!mspSettingsSerialize(dst, src)) {
+            return MSP_RESULT_ERROR;
+        }
+
+        break;
+#endif
     default:
         return MSP_RESULT_CMD_UNKNOWN;
     }
@@ -2058,12 +2134,12 @@ static void mspFcDataFlashReadCommand(sbuf_t *dst, sbuf_t *src)
     const unsigned int dataSize = sbufBytesRemaining(src);
     const uint32_t readAddress = sbufReadU32(src);
     uint16_t readLength;
-    bool allowCompression = false;
+    uint8_t requestedCompression = NO_COMPRESSION;
     bool useLegacyFormat;
     if (dataSize >= sizeof(uint32_t) + sizeof(uint16_t)) {
         readLength = sbufReadU16(src);
         if (sbufBytesRemaining(src)) {
-            allowCompression = sbufReadU8(src);
+            requestedCompression = sbufReadU8(src);
         }
         useLegacyFormat = false;
     } else {
@@ -2071,7 +2147,7 @@ static void mspFcDataFlashReadCommand(sbuf_t *dst, sbuf_t *src)
         useLegacyFormat = true;
     }
 
-    serializeDataflashReadReply(dst, readAddress, readLength, useLegacyFormat, allowCompression);
+    serializeDataflashReadReply(dst, readAddress, readLength, useLegacyFormat, requestedCompression);
 }
 #endif
 
@@ -3247,6 +3323,14 @@ static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, int16_t cmdMSP,
 
         break;
 #endif
+#ifdef USE_MSP_SETTINGS
+    case MSP2_BETAFLIGHT_SET_SETTINGS:
+        if (ARMING_FLAG(ARMED) || !mspSettingsDeserialize(src)) {
+            return MSP_RESULT_ERROR;
+        }
+
+        break;
+#endif
     default:
         // we do not know how to handle the (valid) message, indicate error MSP $M!
         return MSP_RESULT_ERROR;
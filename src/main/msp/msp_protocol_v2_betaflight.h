@@ -19,3 +19,6 @@
  */
 
 #define MSP2_BETAFLIGHT_BIND            0x3000
+#define MSP2_BETAFLIGHT_SETTINGS        0x3001  // out message, settings in binary form, see msp_settings.h
+#define MSP2_BETAFLIGHT_SET_SETTINGS    0x3002  // in message, settings in binary form
+#define MSP2_BETAFLIGHT_LATENCY         0x3003  // out message, stick to motor latency statistics
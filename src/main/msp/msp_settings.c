@@ -0,0 +1,311 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_MSP_SETTINGS
+
+#include "cli/settings.h"
+
+#include "common/streambuf.h"
+
+#include "config/config.h"
+
+#include "fc/controlrate_profile.h"
+
+#include "flight/pid.h"
+
+#include "pg/pg.h"
+
+#include "msp_settings.h"
+
+#define MSP_SETTINGS_ENTRY_HEADER_SIZE 4
+
+static uint8_t settingElementSize(const clivalue_t *value)
+{
+    switch (value->type & VALUE_TYPE_MASK) {
+    case VAR_UINT16:
+    case VAR_INT16:
+        return sizeof(uint16_t);
+    case VAR_UINT32:
+        return sizeof(uint32_t);
+    default:
+        return sizeof(uint8_t);
+    }
+}
+
+static uint8_t *settingValuePointer(const clivalue_t *value, uint8_t pidProfileIndex, uint8_t rateProfileIndex)
+{
+    const pgRegistry_t *reg = pgFind(value->pgn);
+    if (!reg) {
+        return NULL;
+    }
+
+    switch (value->type & VALUE_SECTION_MASK) {
+    case PROFILE_VALUE:
+        return reg->address + value->offset + sizeof(pidProfile_t) * pidProfileIndex;
+    case PROFILE_RATE_VALUE:
+        return reg->address + value->offset + sizeof(controlRateConfig_t) * rateProfileIndex;
+    default:
+        return reg->address + value->offset;
+    }
+}
+
+static uint32_t readElement(const uint8_t *data, uint8_t size)
+{
+    uint32_t element = 0;
+    for (int i = 0; i < size; i++) {
+        element |= (uint32_t)data[i] << (8 * i);
+    }
+    return element;
+}
+
+static void writeElement(uint8_t *data, uint8_t size, uint32_t element)
+{
+    for (int i = 0; i < size; i++) {
+        data[i] = element >> (8 * i);
+    }
+}
+
+static uint8_t settingValueLength(const clivalue_t *value, const uint8_t *ptr)
+{
+    switch (value->type & VALUE_MODE_MASK) {
+    case MODE_ARRAY:
+        return value->config.array.length * settingElementSize(value);
+    case MODE_STRING:
+        return strnlen((const char *)ptr, value->config.string.maxlength);
+    case MODE_BITSET:
+        return 1;
+    default:
+        return settingElementSize(value);
+    }
+}
+
+static void serializeSetting(sbuf_t *dst, const clivalue_t *value, const uint8_t *ptr, uint8_t length)
+{
+    if ((value->type & VALUE_MODE_MASK) == MODE_BITSET) {
+        const uint32_t element = readElement(ptr, settingElementSize(value));
+        sbufWriteU8(dst, (element >> value->config.bitpos) & 1);
+    } else {
+        // values are stored little endian, as they are sent
+        sbufWriteData(dst, ptr, length);
+    }
+}
+
+static bool isSettingValueValid(const clivalue_t *value, uint32_t element)
+{
+    switch (value->type & VALUE_MODE_MASK) {
+    case MODE_LOOKUP:
+        return element < lookupTables[value->config.lookup.tableIndex].valueCount;
+    case MODE_BITSET:
+        return element <= 1;
+    default:
+        break;
+    }
+
+    switch (value->type & VALUE_TYPE_MASK) {
+    case VAR_UINT8:
+    case VAR_UINT16:
+        return element >= value->config.minmaxUnsigned.min && element <= value->config.minmaxUnsigned.max;
+    case VAR_INT8:
+        return (int8_t)element >= value->config.minmax.min && (int8_t)element <= value->config.minmax.max;
+    case VAR_INT16:
+        return (int16_t)element >= value->config.minmax.min && (int16_t)element <= value->config.minmax.max;
+    case VAR_UINT32:
+        return element <= value->config.u32Max;
+    default:
+        return false;
+    }
+}
+
+// checks a received value against the limits of the setting, and stores it if apply is set
+static bool deserializeSetting(const clivalue_t *value, uint8_t *ptr, const uint8_t *data, uint8_t length, bool apply)
+{
+    const uint8_t elementSize = settingElementSize(value);
+
+    switch (value->type & VALUE_MODE_MASK) {
+    case MODE_ARRAY:
+        if (length != value->config.array.length * elementSize) {
+            return false;
+        }
+        if (apply) {
+            memcpy(ptr, data, length);
+        }
+        return true;
+    case MODE_STRING: {
+        const uint8_t maxLength = value->config.string.maxlength;
+        if (length < value->config.string.minlength || length > maxLength) {
+            return false;
+        }
+        // write once strings can only be set if they are empty, or to the value they already have
+        if ((value->config.string.flags & STRING_FLAGS_WRITEONCE) && ptr[0]
+            && (strnlen((const char *)ptr, maxLength) != length || memcmp(ptr, data, length))) {
+            return false;
+        }
+        if (apply) {
+            memset(ptr, 0, maxLength);
+            memcpy(ptr, data, length);
+        }
+        return true;
+    }
+    case MODE_BITSET: {
+        if (length != 1 || !isSettingValueValid(value, data[0])) {
+            return false;
+        }
+        if (apply) {
+            const uint32_t mask = 1 << value->config.bitpos;
+            const uint32_t element = readElement(ptr, elementSize);
+            writeElement(ptr, elementSize, data[0] ? element | mask : element & ~mask);
+        }
+        return true;
+    }
+    default: {
+        if (length != elementSize) {
+            return false;
+        }
+        const uint32_t element = readElement(data, elementSize);
+        if (!isSettingValueValid(value, element)) {
+            return false;
+        }
+        if (apply) {
+            writeElement(ptr, elementSize, element);
+        }
+        return true;
+    }
+    }
+}
+
+static bool readProfileIndices(sbuf_t *src, uint8_t *pidProfileIndex, uint8_t *rateProfileIndex)
+{
+    *pidProfileIndex = sbufBytesRemaining(src) ? sbufReadU8(src) : MSP_SETTINGS_CURRENT_PROFILE;
+    *rateProfileIndex = sbufBytesRemaining(src) ? sbufReadU8(src) : MSP_SETTINGS_CURRENT_PROFILE;
+
+    if (*pidProfileIndex == MSP_SETTINGS_CURRENT_PROFILE) {
+        *pidProfileIndex = getCurrentPidProfileIndex();
+    }
+    if (*rateProfileIndex == MSP_SETTINGS_CURRENT_PROFILE) {
+        *rateProfileIndex = getCurrentControlRateProfileIndex();
+    }
+
+    return *pidProfileIndex < PID_PROFILE_COUNT && *rateProfileIndex < CONTROL_RATE_PROFILE_COUNT;
+}
+
+/*
+ * Request: [u16 index of the first setting] [u8 pid profile] [u8 rate profile]
+ * Reply:   u16 number of settings, u16 index of the first setting not in the reply, entries
+ *
+ * The reply holds as many settings as fit in the reply buffer, a backup is complete
+ * when the index of the next setting equals the number of settings.
+ */
+bool mspSettingsSerialize(sbuf_t *dst, sbuf_t *src)
+{
+    const uint16_t start = sbufBytesRemaining(src) >= 2 ? sbufReadU16(src) : 0;
+    uint8_t pidProfileIndex;
+    uint8_t rateProfileIndex;
+    if (start > valueTableEntryCount || !readProfileIndices(src, &pidProfileIndex, &rateProfileIndex)) {
+        return false;
+    }
+
+    sbufWriteU16(dst, valueTableEntryCount);
+    // the index of the next setting is only known once the reply is full
+    sbuf_t next = *dst;
+    sbufWriteU16(dst, 0);
+
+    uint16_t index;
+    for (index = start; index < valueTableEntryCount; index++) {
+        const clivalue_t *value = &valueTable[index];
+        const uint8_t *ptr = settingValuePointer(value, pidProfileIndex, rateProfileIndex);
+        if (!ptr) {
+            return false;
+        }
+
+        const uint8_t length = settingValueLength(value, ptr);
+        if (sbufBytesRemaining(dst) < MSP_SETTINGS_ENTRY_HEADER_SIZE + length) {
+            break;
+        }
+
+        sbufWriteU16(dst, index);
+        sbufWriteU8(dst, value->type);
+        sbufWriteU8(dst, length);
+        serializeSetting(dst, value, ptr, length);
+    }
+
+    sbufWriteU16(&next, index);
+
+    return true;
+}
+
+static bool processSettingEntries(sbuf_t *src, uint8_t pidProfileIndex, uint8_t rateProfileIndex, bool apply)
+{
+    while (sbufBytesRemaining(src)) {
+        if (sbufBytesRemaining(src) < MSP_SETTINGS_ENTRY_HEADER_SIZE) {
+            return false;
+        }
+
+        const uint16_t index = sbufReadU16(src);
+        const uint8_t type = sbufReadU8(src);
+        const uint8_t length = sbufReadU8(src);
+        // the type must match, so that values from a different firmware are not misinterpreted
+        if (index >= valueTableEntryCount || valueTable[index].type != type || sbufBytesRemaining(src) < length) {
+            return false;
+        }
+
+        const clivalue_t *value = &valueTable[index];
+        uint8_t *ptr = settingValuePointer(value, pidProfileIndex, rateProfileIndex);
+        if (!ptr || !deserializeSetting(value, ptr, sbufPtr(src), length, apply)) {
+            return false;
+        }
+        sbufAdvance(src, length);
+    }
+
+    return true;
+}
+
+/*
+ * Request: u8 pid profile, u8 rate profile, entries
+ *
+ * All entries are checked before any is applied, so that an invalid request leaves the settings unchanged.
+ */
+bool mspSettingsDeserialize(sbuf_t *src)
+{
+    if (sbufBytesRemaining(src) < 2) {
+        return false;
+    }
+
+    uint8_t pidProfileIndex;
+    uint8_t rateProfileIndex;
+    if (!readProfileIndices(src, &pidProfileIndex, &rateProfileIndex)) {
+        return false;
+    }
+
+    sbuf_t entries = *src;
+    if (!processSettingEntries(&entries, pidProfileIndex, rateProfileIndex, false)) {
+        return false;
+    }
+
+    return processSettingEntries(src, pidProfileIndex, rateProfileIndex, true);
+}
+
+#endif
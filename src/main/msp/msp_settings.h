@@ -0,0 +1,44 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+
+/*
+ * Binary transfer of the settings described by valueTable.
+ *
+ * Each setting is sent as an entry of:
+ *   u16 index into valueTable
+ *   u8  type of the setting, as in valueTable
+ *   u8  length of the value
+ *   the value, little endian. Arrays are sent element by element, strings without
+ *   the terminating zero and bitset settings as a single 0 or 1 byte.
+ *
+ * Profile settings refer to the pid and rate profiles given in the request,
+ * MSP_SETTINGS_CURRENT_PROFILE selects the profile in use.
+ */
+
+#define MSP_SETTINGS_CURRENT_PROFILE 0xFF
+
+struct sbuf_s;
+bool mspSettingsSerialize(struct sbuf_s *dst, struct sbuf_s *src);
+bool mspSettingsDeserialize(struct sbuf_s *src);
@@ -82,6 +82,8 @@
 
 #include "rx/rx.h"
 
+#include "scheduler/scheduler.h"
+
 #include "sensors/acceleration.h"
 #include "sensors/battery.h"
 #include "sensors/esc_sensor.h"
@@ -964,7 +966,24 @@ STATIC_UNIT_TESTED void osdRefresh(timeUs_t currentTimeUs)
 }
 
 /*
- * Called periodically by the scheduler
+ * A display that is paced to the video, like the MAX7456 drawing during vertical blanking, runs the task
+ * once per field as soon as its draw window opens, so that the window is not spent waiting for the task.
+ * Other displays run the task at a fixed rate.
+ */
+bool osdUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+{
+    timeUs_t windowStartUs;
+
+    if (displayGetDrawWindow(osdDisplayPort, currentTimeUs, &windowStartUs)) {
+        const timeDelta_t sinceWindowStartUs = cmpTimeUs(currentTimeUs, windowStartUs);
+        return sinceWindowStartUs >= 0 && currentDeltaTimeUs > sinceWindowStartUs;
+    }
+
+    return currentDeltaTimeUs >= TASK_PERIOD_HZ(OSD_TASK_FREQUENCY_HZ);
+}
+
+/*
+ * Called by the scheduler
  */
 void osdUpdate(timeUs_t currentTimeUs)
 {
@@ -998,6 +1017,11 @@ void osdUpdate(timeUs_t currentTimeUs)
 #endif
 
     if (counter % DRAW_FREQ_DENOM == 0) {
+        timeUs_t windowStartUs;
+        if (displayGetDrawWindow(osdDisplayPort, currentTimeUs, &windowStartUs)) {
+            // the frame rendered last is complete, send it while the window is open and render the next one after
+            displayDrawScreen(osdDisplayPort);
+        }
         osdRefresh(currentTimeUs);
         showVisualBeeper = false;
     } else {
@@ -33,6 +33,8 @@ extern const char * const osdTimerSourceNames[OSD_NUM_TIMER_TYPES];
 
 #define OSD_ELEMENT_BUFFER_LENGTH 32
 
+#define OSD_TASK_FREQUENCY_HZ 60    // when the display is not paced to the video fields
+
 #define OSD_PROFILE_NAME_LENGTH 16
 
 #ifdef USE_OSD_PROFILES
@@ -323,6 +325,7 @@ extern escSensorData_t *osdEscDataCombined;
 
 void osdInit(displayPort_t *osdDisplayPort, osdDisplayPortDevice_e displayPortDevice);
 bool osdInitialized(void);
+bool osdUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs);
 void osdUpdate(timeUs_t currentTimeUs);
 void osdStatSetState(uint8_t statIndex, bool enabled);
 bool osdStatGetState(uint8_t statIndex);
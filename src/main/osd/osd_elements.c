@@ -51,6 +51,15 @@
     Add the mapping for the element ID to the background drawing function to the
     osdElementBackgroundFunction array.
 
+    Limit how often the element is rendered.
+    ----------------------------------------
+    Elements that are costly to format or whose value rarely changes don't need to be
+    rendered on every refresh, their last output is redrawn instead. Add an entry to the
+    osdElementRefreshIntervalMs array for the minimum time between renders and/or create a
+    function named like "osdProbeSomething()" that returns a value which changes whenever the
+    rendered output would, and add it to the osdElementProbeFunction array. Only elements that
+    render into the element buffer (leave drawElement set) can be cached.
+
     Accelerometer reqirement:
     -------------------------
     If the new element utilizes the accelerometer, add it to the osdElementsNeedAccelerometer() function.
@@ -168,8 +177,28 @@ static const char compassBar[] = {
   SYM_HEADING_LINE, SYM_HEADING_DIVIDED_LINE, SYM_HEADING_LINE
 };
 
+// Last output of elements that aren't rendered on every refresh
+#define OSD_ELEMENT_CACHE_COUNT     16
+#define OSD_ELEMENT_NOT_CACHED      0xFF
+// Renders of scheduled elements per refresh, the rest are spread over the following refreshes
+#define OSD_ELEMENT_RENDER_BUDGET   4
+// Probed elements are rendered at least this often to pick up changes their probe can't see, like units
+#define OSD_ELEMENT_MAX_AGE_US      1000000
+
+typedef struct osdElementCache_s {
+    timeUs_t renderedAtUs;
+    uint32_t probeValue;
+    bool valid;
+    uint8_t attr;
+    char buff[OSD_ELEMENT_BUFFER_LENGTH];
+} osdElementCache_t;
+
 static unsigned activeOsdElementCount = 0;
 static uint8_t activeOsdElementArray[OSD_ITEM_COUNT];
+static uint8_t activeOsdElementCacheIndex[OSD_ITEM_COUNT];
+static osdElementCache_t osdElementCache[OSD_ELEMENT_CACHE_COUNT];
+static unsigned osdElementCacheCount = 0;
+static unsigned osdElementScheduleStart = 0;
 static bool backgroundLayerSupported = false;
 
 // Blink control
@@ -229,8 +258,7 @@ static void renderOsdEscRpmOrFreq(getEscRpmOrFreqFnPtr escFnPtr, osdElementParms
     for (int i=0; i < getMotorCount(); i++) {
         char rpmStr[6];
         const int rpm = MIN((*escFnPtr)(i),99999);
-        const int len = tfp_sprintf(rpmStr, "%d", rpm);
-        rpmStr[len] = '\0';
+        formatSigned(rpmStr, rpm, 0);
         osdDisplayWrite(element, x, y + i, DISPLAYPORT_ATTR_NONE, rpmStr);
     }
     element->drawElement = false;
@@ -258,7 +286,9 @@ static void osdFormatAltitudeString(char * buff, int32_t altitudeCm)
     if (alt < 0) {
         buff[pos++] = '-';
     }
-    tfp_sprintf(buff + pos, "%01d.%01d%c", abs(alt) / 10 , abs(alt) % 10, osdGetMetersToSelectedUnitSymbol());
+    char *p = formatFixedPoint(buff + pos, abs(alt), 1, 0);
+    *p++ = osdGetMetersToSelectedUnitSymbol();
+    *p = '\0';
 }
 
 #ifdef USE_GPS
@@ -275,7 +305,7 @@ static void osdFormatCoordinate(char *buff, char sym, int32_t val)
         buff[pos++] = '-';
         val = -val;
     }
-    tfp_sprintf(buff + pos, "%d.%07d", val / GPS_DEGREES_DIVIDER, val % GPS_DEGREES_DIVIDER);
+    formatFixedPoint(buff + pos, val, 7, 0);
 }
 #endif // USE_GPS
 
@@ -303,20 +333,31 @@ void osdFormatDistanceString(char *ptr, int distance, char leadingSymbol)
     }
 
     if (convertedDistance < unitTransition) {
-        tfp_sprintf(ptr, "%d%c", convertedDistance, unitSymbol);
+        ptr = formatSigned(ptr, convertedDistance, 0);
+        *ptr++ = unitSymbol;
     } else {
         const int displayDistance = convertedDistance * 100 / unitTransition;
         if (displayDistance >= 1000) { // >= 10 miles or km - 1 decimal place
-            tfp_sprintf(ptr, "%d.%d%c", displayDistance / 100, (displayDistance / 10) % 10, unitSymbolExtended);
+            ptr = formatFixedPoint(ptr, displayDistance / 10, 1, 0);
         } else {                     // < 10 miles or km - 2 decimal places
-            tfp_sprintf(ptr, "%d.%02d%c", displayDistance / 100, displayDistance % 100, unitSymbolExtended);
+            ptr = formatFixedPoint(ptr, displayDistance, 2, 0);
         }
+        *ptr++ = unitSymbolExtended;
     }
+    *ptr = '\0';
 }
 
 static void osdFormatPID(char * buff, const char * label, const pidf_t * pid)
 {
-    tfp_sprintf(buff, "%s %3d %3d %3d", label, pid->P, pid->I, pid->D);
+    const int labelLength = strlen(label);
+    memcpy(buff, label, labelLength);
+    buff += labelLength;
+    *buff++ = ' ';
+    buff = formatSigned(buff, pid->P, 3);
+    *buff++ = ' ';
+    buff = formatSigned(buff, pid->I, 3);
+    *buff++ = ' ';
+    formatSigned(buff, pid->D, 3);
 }
 
 #ifdef USE_RTC_TIME
@@ -337,25 +378,26 @@ bool osdFormatRtcDateTime(char *buffer)
 
 void osdFormatTime(char * buff, osd_timer_precision_e precision, timeUs_t time)
 {
-    int seconds = time / 1000000;
-    const int minutes = seconds / 60;
-    seconds = seconds % 60;
+    const int seconds = time / 1000000;
+
+    buff = formatMinutesSeconds(buff, seconds);
 
     switch (precision) {
     case OSD_TIMER_PREC_SECOND:
     default:
-        tfp_sprintf(buff, "%02d:%02d", minutes, seconds);
         break;
     case OSD_TIMER_PREC_HUNDREDTHS:
         {
             const int hundredths = (time / 10000) % 100;
-            tfp_sprintf(buff, "%02d:%02d.%02d", minutes, seconds, hundredths);
+            *buff++ = '.';
+            formatUnsigned(buff, hundredths, 2, '0');
             break;
         }
     case OSD_TIMER_PREC_TENTHS:
         {
             const int tenths = (time / 100000) % 10;
-            tfp_sprintf(buff, "%02d:%02d.%01d", minutes, seconds, tenths);
+            *buff++ = '.';
+            formatUnsigned(buff, tenths, 1, '0');
             break;
         }
     }
@@ -558,7 +600,11 @@ static void osdElementAltitude(osdElementParms_t *element)
 static void osdElementAngleRollPitch(osdElementParms_t *element)
 {
     const int angle = (element->item == OSD_PITCH_ANGLE) ? attitude.values.pitch : attitude.values.roll;
-    tfp_sprintf(element->buff, "%c%c%02d.%01d", (element->item == OSD_PITCH_ANGLE) ? SYM_PITCH : SYM_ROLL , angle < 0 ? '-' : ' ', abs(angle / 10), abs(angle % 10));
+    element->buff[0] = (element->item == OSD_PITCH_ANGLE) ? SYM_PITCH : SYM_ROLL;
+    element->buff[1] = angle < 0 ? '-' : ' ';
+    char *p = formatUnsigned(element->buff + 2, abs(angle / 10), 2, '0');
+    *p++ = '.';
+    formatUnsigned(p, abs(angle % 10), 1, '0');
 }
 #endif
 
@@ -600,7 +646,9 @@ static void osdElementAverageCellVoltage(osdElementParms_t *element)
 {
     const int cellV = getBatteryAverageCellVoltage();
     element->buff[0] = osdGetBatterySymbol(cellV);
-    tfp_sprintf(element->buff + 1, "%d.%02d%c", cellV / 100, cellV % 100, SYM_VOLT);
+    char *p = formatFixedPoint(element->buff + 1, cellV, 2, 0);
+    *p++ = SYM_VOLT;
+    *p = '\0';
 }
 
 static void osdElementCompassBar(osdElementParms_t *element)
@@ -612,7 +660,11 @@ static void osdElementCompassBar(osdElementParms_t *element)
 #ifdef USE_ADC_INTERNAL
 static void osdElementCoreTemperature(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "C%c%3d%c", SYM_TEMPERATURE, osdConvertTemperatureToSelectedUnit(getCoreTemperatureCelsius()), osdGetTemperatureSymbolForSelectedUnit());
+    element->buff[0] = 'C';
+    element->buff[1] = SYM_TEMPERATURE;
+    char *p = formatSigned(element->buff + 2, osdConvertTemperatureToSelectedUnit(getCoreTemperatureCelsius()), 3);
+    *p++ = osdGetTemperatureSymbolForSelectedUnit();
+    *p = '\0';
 }
 #endif // USE_ADC_INTERNAL
 
@@ -712,12 +764,20 @@ static void osdBackgroundCrosshairs(osdElementParms_t *element)
 static void osdElementCurrentDraw(osdElementParms_t *element)
 {
     const int32_t amperage = getAmperage();
-    tfp_sprintf(element->buff, "%3d.%02d%c", abs(amperage) / 100, abs(amperage) % 100, SYM_AMP);
+    char *p = formatFixedPoint(element->buff, abs(amperage), 2, 6);
+    *p++ = SYM_AMP;
+    *p = '\0';
 }
 
 static void osdElementDebug(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "DBG %5d %5d %5d %5d", debug[0], debug[1], debug[2], debug[3]);
+    char *p = element->buff;
+    memcpy(p, "DBG", 3);
+    p += 3;
+    for (int i = 0; i < DEBUG16_VALUE_COUNT; i++) {
+        *p++ = ' ';
+        p = formatSigned(p, debug[i], 5);
+    }
 }
 
 static void osdElementDisarmed(osdElementParms_t *element)
@@ -805,7 +865,11 @@ static void osdElementOsdProfileName(osdElementParms_t *element)
 static void osdElementEscTemperature(osdElementParms_t *element)
 {
     if (featureIsEnabled(FEATURE_ESC_SENSOR)) {
-        tfp_sprintf(element->buff, "E%c%3d%c", SYM_TEMPERATURE, osdConvertTemperatureToSelectedUnit(osdEscDataCombined->temperature), osdGetTemperatureSymbolForSelectedUnit());
+        element->buff[0] = 'E';
+        element->buff[1] = SYM_TEMPERATURE;
+        char *p = formatSigned(element->buff + 2, osdConvertTemperatureToSelectedUnit(osdEscDataCombined->temperature), 3);
+        *p++ = osdGetTemperatureSymbolForSelectedUnit();
+        *p = '\0';
     }
 }
 #endif // USE_ESC_SENSOR
@@ -854,7 +918,9 @@ static void osdElementFlymode(osdElementParms_t *element)
 static void osdElementGForce(osdElementParms_t *element)
 {
     const int gForce = lrintf(osdGForce * 10);
-    tfp_sprintf(element->buff, "%01d.%01dG", gForce / 10, gForce % 10);
+    char *p = formatFixedPoint(element->buff, gForce, 1, 0);
+    *p++ = 'G';
+    *p = '\0';
 }
 #endif // USE_ACC
 
@@ -911,16 +977,21 @@ static void osdElementGpsLongitude(osdElementParms_t *element)
 
 static void osdElementGpsSats(osdElementParms_t *element)
 {
+    element->buff[0] = SYM_SAT_L;
+    element->buff[1] = SYM_SAT_R;
+    char *p = formatSigned(element->buff + 2, gpsSol.numSat, 2);
     if (osdConfig()->gps_sats_show_hdop) {
-        tfp_sprintf(element->buff, "%c%c%2d %d.%d", SYM_SAT_L, SYM_SAT_R, gpsSol.numSat, gpsSol.hdop / 100, (gpsSol.hdop / 10) % 10);
-    } else {
-        tfp_sprintf(element->buff, "%c%c%2d", SYM_SAT_L, SYM_SAT_R, gpsSol.numSat);
+        *p++ = ' ';
+        formatFixedPoint(p, gpsSol.hdop / 10, 1, 0);
     }
 }
 
 static void osdElementGpsSpeed(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "%c%3d%c", SYM_SPEED, osdGetSpeedToSelectedUnit(gpsConfig()->gps_use_3d_speed ? gpsSol.speed3d : gpsSol.groundSpeed), osdGetSpeedToSelectedUnitSymbol());
+    element->buff[0] = SYM_SPEED;
+    char *p = formatSigned(element->buff + 1, osdGetSpeedToSelectedUnit(gpsConfig()->gps_use_3d_speed ? gpsSol.speed3d : gpsSol.groundSpeed), 3);
+    *p++ = osdGetSpeedToSelectedUnitSymbol();
+    *p = '\0';
 }
 #endif // USE_GPS
 
@@ -947,13 +1018,15 @@ static void osdElementLinkQuality(osdElementParms_t *element)
     uint16_t osdLinkQuality = 0;
     if (linkQualitySource == LQ_SOURCE_RX_PROTOCOL_CRSF) { // 0-300
         osdLinkQuality = rxGetLinkQuality()  / 3.41;
-        tfp_sprintf(element->buff, "%c%3d", SYM_LINK_QUALITY, osdLinkQuality);
+        element->buff[0] = SYM_LINK_QUALITY;
+        formatSigned(element->buff + 1, osdLinkQuality, 3);
     } else { // 0-9
         osdLinkQuality = rxGetLinkQuality() * 10 / LINK_QUALITY_MAX_VALUE;
         if (osdLinkQuality >= 10) {
             osdLinkQuality = 9;
         }
-        tfp_sprintf(element->buff, "%c%1d", SYM_LINK_QUALITY, osdLinkQuality);
+        element->buff[0] = SYM_LINK_QUALITY;
+        formatSigned(element->buff + 1, osdLinkQuality, 1);
     }
 }
 #endif // USE_RX_LINK_QUALITY_INFO
@@ -980,7 +1053,9 @@ static void osdElementLogStatus(osdElementParms_t *element)
 
 static void osdElementMahDrawn(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "%4d%c", getMAhDrawn(), SYM_MAH);
+    char *p = formatSigned(element->buff, getMAhDrawn(), 4);
+    *p++ = SYM_MAH;
+    *p = '\0';
 }
 
 static void osdElementMainBatteryUsage(osdElementParms_t *element)
@@ -1011,12 +1086,15 @@ static void osdElementMainBatteryVoltage(osdElementParms_t *element)
     int batteryVoltage = getBatteryVoltage();
 
     element->buff[0] = osdGetBatterySymbol(getBatteryAverageCellVoltage());
+    char *p;
     if (batteryVoltage >= 1000) {
         batteryVoltage = (batteryVoltage + 5) / 10;
-        tfp_sprintf(element->buff + 1, "%d.%d%c", batteryVoltage / 10, batteryVoltage % 10, SYM_VOLT);
+        p = formatFixedPoint(element->buff + 1, batteryVoltage, 1, 0);
     } else {
-        tfp_sprintf(element->buff + 1, "%d.%d%c", batteryVoltage / 100, batteryVoltage % 100, SYM_VOLT);
+        p = formatFixedPoint(element->buff + 1, batteryVoltage, 2, 0);
     }
+    *p++ = SYM_VOLT;
+    *p = '\0';
 }
 
 static void osdElementMotorDiagnostics(osdElementParms_t *element)
@@ -1036,7 +1114,8 @@ static void osdElementMotorDiagnostics(osdElementParms_t *element)
 static void osdElementNumericalHeading(osdElementParms_t *element)
 {
     const int heading = DECIDEGREES_TO_DEGREES(attitude.values.yaw);
-    tfp_sprintf(element->buff, "%c%03d", osdGetDirectionSymbolFromHeading(heading), heading);
+    element->buff[0] = osdGetDirectionSymbolFromHeading(heading);
+    formatUnsigned(element->buff + 1, heading, 3, '0');
 }
 
 #ifdef USE_VARIO
@@ -1053,7 +1132,10 @@ static void osdElementNumericalVario(osdElementParms_t *element)
     if (haveBaro || haveGps) {
         const int verticalSpeed = osdGetMetersToSelectedUnit(getEstimatedVario());
         const char directionSymbol = verticalSpeed < 0 ? SYM_ARROW_SMALL_DOWN : SYM_ARROW_SMALL_UP;
-        tfp_sprintf(element->buff, "%c%01d.%01d%c", directionSymbol, abs(verticalSpeed / 100), abs((verticalSpeed % 100) / 10), osdGetVarioToSelectedUnitSymbol());
+        element->buff[0] = directionSymbol;
+        char *p = formatFixedPoint(element->buff + 1, abs(verticalSpeed) / 10, 1, 0);
+        *p++ = osdGetVarioToSelectedUnitSymbol();
+        *p = '\0';
     } else {
         // We use this symbol when we don't have a valid measure
         element->buff[0] = SYM_HYPHEN;
@@ -1084,7 +1166,9 @@ static void osdElementPidsYaw(osdElementParms_t *element)
 
 static void osdElementPower(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "%4dW", getAmperage() * getBatteryVoltage() / 10000);
+    char *p = formatSigned(element->buff, getAmperage() * getBatteryVoltage() / 10000, 4);
+    *p++ = 'W';
+    *p = '\0';
 }
 
 static void osdElementRcChannels(osdElementParms_t *element)
@@ -1099,7 +1183,7 @@ static void osdElementRcChannels(osdElementParms_t *element)
             // Opt for the simplest formatting for now.
             // Decimal notation can be added when tfp_sprintf supports float among fancy options.
             char fmtbuf[6];
-            tfp_sprintf(fmtbuf, "%5d", data);
+            formatSigned(fmtbuf, data, 5);
             osdDisplayWrite(element, xpos, ypos + i, DISPLAYPORT_ATTR_NONE, fmtbuf);
         }
     }
@@ -1128,7 +1212,8 @@ static void osdElementRssi(osdElementParms_t *element)
         osdRssi = 99;
     }
 
-    tfp_sprintf(element->buff, "%c%2d", SYM_RSSI, osdRssi);
+    element->buff[0] = SYM_RSSI;
+    formatSigned(element->buff + 1, osdRssi, 2);
 }
 
 #ifdef USE_RTC_TIME
@@ -1141,7 +1226,8 @@ static void osdElementRtcTime(osdElementParms_t *element)
 #ifdef USE_RX_RSSI_DBM
 static void osdElementRssiDbm(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "%c%3d", SYM_RSSI, getRssiDbm() * -1);
+    element->buff[0] = SYM_RSSI;
+    formatSigned(element->buff + 1, getRssiDbm() * -1, 3);
 }
 #endif // USE_RX_RSSI_DBM
 
@@ -1196,7 +1282,8 @@ static void osdElementStickOverlay(osdElementParms_t *element)
 
 static void osdElementThrottlePosition(osdElementParms_t *element)
 {
-    tfp_sprintf(element->buff, "%c%3d", SYM_THR, calculateThrottlePercent());
+    element->buff[0] = SYM_THR;
+    formatSigned(element->buff + 1, calculateThrottlePercent(), 3);
 }
 
 static void osdElementTimer(osdElementParms_t *element)
@@ -1705,9 +1792,147 @@ const osdElementDrawFn osdElementBackgroundFunction[OSD_ITEM_COUNT] = {
     [OSD_DISPLAY_NAME]            = osdBackgroundDisplayName,
 };
 
+// Change probes, each returns a value that changes whenever the element's rendered output would
+
+static uint32_t osdProbeTimer(uint8_t item)
+{
+    const uint16_t timer = osdConfig()->timers[item - OSD_ITEM_TIMER_1];
+    uint32_t resolutionUs;
+
+    switch (OSD_TIMER_PRECISION(timer)) {
+    case OSD_TIMER_PREC_HUNDREDTHS:
+        resolutionUs = 10000;
+        break;
+    case OSD_TIMER_PREC_TENTHS:
+        resolutionUs = 100000;
+        break;
+    case OSD_TIMER_PREC_SECOND:
+    default:
+        resolutionUs = 1000000;
+        break;
+    }
+
+    // the symbol and the source of some timers follow the arming state
+    return (osdGetTimerValue(OSD_TIMER_SRC(timer)) / resolutionUs) << 1 | (ARMING_FLAG(ARMED) ? 1 : 0);
+}
+
+static uint32_t osdProbePids(uint8_t item)
+{
+    const pidf_t *pid = &currentPidProfile->pid[item == OSD_ROLL_PIDS ? PID_ROLL : item == OSD_PITCH_PIDS ? PID_PITCH : PID_YAW];
+
+    return pid->P | pid->I << 8 | pid->D << 16;
+}
+
+static uint32_t osdProbeProfileIndexes(uint8_t item)
+{
+    UNUSED(item);
+
+    uint32_t value = getCurrentPidProfileIndex() | getCurrentControlRateProfileIndex() << 8;
+#ifdef USE_OSD_PROFILES
+    value |= getCurrentOsdProfileIndex() << 16;
+#endif
+
+    return value;
+}
+
+#ifdef USE_GPS
+static uint32_t osdProbeGpsFixState(void)
+{
+    return (STATE(GPS_FIX) ? 1 : 0) | (STATE(GPS_FIX_HOME) ? 2 : 0);
+}
+
+static uint32_t osdProbeGpsFlightDistance(uint8_t item)
+{
+    UNUSED(item);
+
+    return (GPS_distanceFlownInCm / 100) << 2 | osdProbeGpsFixState();
+}
+
+static uint32_t osdProbeGpsHomeDistance(uint8_t item)
+{
+    UNUSED(item);
+
+    return GPS_distanceToHome << 2 | osdProbeGpsFixState();
+}
+
+static uint32_t osdProbeGpsCoordinate(uint8_t item)
+{
+    return item == OSD_GPS_LAT ? gpsSol.llh.lat : gpsSol.llh.lon;
+}
+
+static uint32_t osdProbeGpsSats(uint8_t item)
+{
+    UNUSED(item);
+
+    return gpsSol.numSat | gpsSol.hdop << 8;
+}
+#endif // USE_GPS
+
+#ifdef USE_RTC_TIME
+static uint32_t osdProbeRtcTime(uint8_t item)
+{
+    UNUSED(item);
+
+    rtcTime_t t;
+    if (!rtcGet(&t)) {
+        return 0;
+    }
+
+    return t / 1000;
+}
+#endif // USE_RTC_TIME
+
+// Define the elements that can be rendered less often than on every refresh. An element with a
+// probe is rendered when its probe value changes, an element with a refresh interval is rendered
+// at most once per interval. Elements with neither are rendered on every refresh.
+
+const osdElementProbeFn osdElementProbeFunction[OSD_ITEM_COUNT] = {
+    [OSD_ITEM_TIMER_1]            = osdProbeTimer,
+    [OSD_ITEM_TIMER_2]            = osdProbeTimer,
+    [OSD_ROLL_PIDS]               = osdProbePids,
+    [OSD_PITCH_PIDS]              = osdProbePids,
+    [OSD_YAW_PIDS]                = osdProbePids,
+    [OSD_PIDRATE_PROFILE]         = osdProbeProfileIndexes,
+#ifdef USE_GPS
+    [OSD_GPS_SATS]                = osdProbeGpsSats,
+    [OSD_GPS_LAT]                 = osdProbeGpsCoordinate,
+    [OSD_GPS_LON]                 = osdProbeGpsCoordinate,
+    [OSD_HOME_DIST]               = osdProbeGpsHomeDistance,
+    [OSD_FLIGHT_DIST]             = osdProbeGpsFlightDistance,
+#endif
+#ifdef USE_RTC_TIME
+    [OSD_RTC_DATETIME]            = osdProbeRtcTime,
+#endif
+#ifdef USE_PROFILE_NAMES
+    [OSD_RATE_PROFILE_NAME]       = osdProbeProfileIndexes,
+    [OSD_PID_PROFILE_NAME]        = osdProbeProfileIndexes,
+#endif
+#ifdef USE_OSD_PROFILES
+    [OSD_PROFILE_NAME]            = osdProbeProfileIndexes,
+#endif
+};
+
+const uint16_t osdElementRefreshIntervalMs[OSD_ITEM_COUNT] = {
+    [OSD_WARNINGS]                = 100,
+#ifdef USE_GPS
+    [OSD_GPS_LAT]                 = 200,
+    [OSD_GPS_LON]                 = 200,
+#endif
+#ifdef USE_VTX_COMMON
+    [OSD_VTX_CHANNEL]             = 200,
+#endif
+    [OSD_DEBUG]                   = 100,
+};
+
 static void osdAddActiveElement(osd_items_e element)
 {
     if (VISIBLE(osdElementConfig()->item_pos[element])) {
+        uint8_t cacheIndex = OSD_ELEMENT_NOT_CACHED;
+        if ((osdElementProbeFunction[element] || osdElementRefreshIntervalMs[element]) && osdElementCacheCount < OSD_ELEMENT_CACHE_COUNT) {
+            cacheIndex = osdElementCacheCount++;
+            osdElementCache[cacheIndex].valid = false;
+        }
+        activeOsdElementCacheIndex[activeOsdElementCount] = cacheIndex;
         activeOsdElementArray[activeOsdElementCount++] = element;
     }
 }
@@ -1718,6 +1943,7 @@ static void osdAddActiveElement(osd_items_e element)
 void osdAddActiveElements(void)
 {
     activeOsdElementCount = 0;
+    osdElementCacheCount = 0;
 
 #ifdef USE_ACC
     if (sensors(SENSOR_ACC)) {
@@ -1755,7 +1981,22 @@ void osdAddActiveElements(void)
 #endif
 }
 
-static void osdDrawSingleElement(displayPort_t *osdDisplayPort, uint8_t item)
+// Decides whether a cached element has to be rendered again, or its last output can be redrawn
+static bool osdElementRenderDue(uint8_t item, const osdElementCache_t *cache, timeUs_t currentTimeUs)
+{
+    const timeDelta_t ageUs = cmpTimeUs(currentTimeUs, cache->renderedAtUs);
+
+    if (ageUs < osdElementRefreshIntervalMs[item] * 1000) {
+        return false;
+    }
+    if (osdElementProbeFunction[item] && ageUs < OSD_ELEMENT_MAX_AGE_US) {
+        return osdElementProbeFunction[item](item) != cache->probeValue;
+    }
+
+    return true;
+}
+
+static void osdDrawSingleElement(displayPort_t *osdDisplayPort, uint8_t item, osdElementCache_t *cache, bool render, timeUs_t currentTimeUs)
 {
     if (!osdElementDrawFunction[item]) {
         // Element has no drawing function
@@ -1778,11 +2019,28 @@ static void osdDrawSingleElement(displayPort_t *osdDisplayPort, uint8_t item)
     element.drawElement = true;
     element.attr = DISPLAYPORT_ATTR_NONE;
 
+    if (cache && cache->valid && !render) {
+        // Nothing the element shows has changed, redraw its last output
+        osdDisplayWrite(&element, elemPosX, elemPosY, cache->attr, cache->buff);
+        return;
+    }
+
+    const uint32_t probeValue = osdElementProbeFunction[item] ? osdElementProbeFunction[item](item) : 0;
+
     // Call the element drawing function
     osdElementDrawFunction[item](&element);
     if (element.drawElement) {
         osdDisplayWrite(&element, elemPosX, elemPosY, element.attr, buff);
     }
+
+    if (cache) {
+        // Elements that draw themselves can't be cached and are rendered on every refresh
+        cache->valid = element.drawElement;
+        cache->renderedAtUs = currentTimeUs;
+        cache->probeValue = probeValue;
+        cache->attr = element.attr;
+        memcpy(cache->buff, buff, sizeof(cache->buff));
+    }
 }
 
 static void osdDrawSingleElementBackground(displayPort_t *osdDisplayPort, uint8_t item)
@@ -1826,13 +2084,37 @@ void osdDrawActiveElements(displayPort_t *osdDisplayPort, timeUs_t currentTimeUs
 
     blinkState = (currentTimeUs / 200000) % 2;
 
+    // Pick the cached elements to render on this refresh. Elements without a valid cache always
+    // render, the others share a budget so that elements which become due together are spread
+    // over consecutive refreshes. The scan starts where the last one ran out so none are starved.
+    bool render[OSD_ITEM_COUNT];
+    unsigned renderBudget = OSD_ELEMENT_RENDER_BUDGET;
+    unsigned nextScheduleStart = osdElementScheduleStart;
+    for (unsigned n = 0; n < activeOsdElementCount; n++) {
+        const unsigned i = (osdElementScheduleStart + n) % activeOsdElementCount;
+        const uint8_t cacheIndex = activeOsdElementCacheIndex[i];
+
+        if (cacheIndex == OSD_ELEMENT_NOT_CACHED || !osdElementCache[cacheIndex].valid) {
+            render[i] = true;
+        } else if (renderBudget && osdElementRenderDue(activeOsdElementArray[i], &osdElementCache[cacheIndex], currentTimeUs)) {
+            render[i] = true;
+            renderBudget--;
+            nextScheduleStart = i + 1;
+        } else {
+            render[i] = false;
+        }
+    }
+    osdElementScheduleStart = nextScheduleStart;
+
     for (unsigned i = 0; i < activeOsdElementCount; i++) {
         if (!backgroundLayerSupported) {
             // If the background layer isn't supported then we
             // have to draw the element's static layer as well.
             osdDrawSingleElementBackground(osdDisplayPort, activeOsdElementArray[i]);
         }
-        osdDrawSingleElement(osdDisplayPort, activeOsdElementArray[i]);
+        const uint8_t cacheIndex = activeOsdElementCacheIndex[i];
+        osdElementCache_t *cache = (cacheIndex == OSD_ELEMENT_NOT_CACHED) ? NULL : &osdElementCache[cacheIndex];
+        osdDrawSingleElement(osdDisplayPort, activeOsdElementArray[i], cache, render[i], currentTimeUs);
     }
 }
 
@@ -1852,6 +2134,7 @@ void osdElementsInit(bool backgroundLayerFlag)
 {
     backgroundLayerSupported = backgroundLayerFlag;
     activeOsdElementCount = 0;
+    osdElementCacheCount = 0;
 }
 
 void osdResetAlarms(void)
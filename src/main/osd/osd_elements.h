@@ -35,6 +35,7 @@ typedef struct osdElementParms_s {
 } osdElementParms_t;
 
 typedef void (*osdElementDrawFn)(osdElementParms_t *element);
+typedef uint32_t (*osdElementProbeFn)(uint8_t item);
 
 int osdConvertTemperatureToSelectedUnit(int tempInDegreesCelcius);
 void osdFormatDistanceString(char *result, int distance, char leadingSymbol);
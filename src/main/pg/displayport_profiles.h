@@ -38,6 +38,7 @@ typedef struct displayPortProfile_s {
     uint8_t vendorInitLength;  // Actual length of vendorInit byte string
     uint8_t vendorInit[253];   // Max 253 bytes of vendor specific initialization byte string
 #endif
+    uint8_t useSpanUpdates;    // Pack changed spans into MSP_DP_WRITE_SPANS frames, the device must support it
 } displayPortProfile_t;
 
 PG_DECLARE(displayPortProfile_t, displayPortProfileMsp);
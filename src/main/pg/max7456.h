@@ -28,6 +28,7 @@ typedef struct max7456Config_s {
     ioTag_t csTag;
     uint8_t spiDevice;
     bool preInitOPU;
+    ioTag_t vsyncTag;   // VSYNC output of the chip, to update the display during vertical blanking
 } max7456Config_t;
 
 // clockConfig values
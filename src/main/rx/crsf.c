@@ -70,6 +70,9 @@ static uint8_t telemetryBufLen = 0;
 
 static timeUs_t lastRcFrameTimeUs = 0;
 
+// Frame mode receive buffer, a line idle period may follow several back to back frames
+static uint8_t crsfRxFrameBuffer[CRSF_FRAME_SIZE_MAX * 2];
+
 /*
  * CRSF protocol
  *
@@ -227,6 +230,57 @@ STATIC_UNIT_TESTED uint8_t crsfFrameCRC(void)
     return crc;
 }
 
+// Handles the complete, CRC checked frame in crsfFrame
+static void crsfProcessFrame(timeUs_t frameTimeUs)
+{
+    switch (crsfFrame.frame.type)
+    {
+        case CRSF_FRAMETYPE_RC_CHANNELS_PACKED:
+            if (crsfFrame.frame.deviceAddress == CRSF_ADDRESS_FLIGHT_CONTROLLER) {
+                lastRcFrameTimeUs = frameTimeUs;
+                crsfFrameDone = true;
+                memcpy(&crsfChannelDataFrame, &crsfFrame, sizeof(crsfFrame));
+            }
+            break;
+
+#if defined(USE_TELEMETRY_CRSF) && defined(USE_MSP_OVER_TELEMETRY)
+        case CRSF_FRAMETYPE_MSP_REQ:
+        case CRSF_FRAMETYPE_MSP_WRITE: {
+            uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
+            if (bufferCrsfMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE)) {
+                crsfScheduleMspResponse();
+            }
+            break;
+        }
+#endif
+#if defined(USE_CRSF_CMS_TELEMETRY)
+        case CRSF_FRAMETYPE_DEVICE_PING:
+            crsfScheduleDeviceInfoResponse();
+            break;
+        case CRSF_FRAMETYPE_DISPLAYPORT_CMD: {
+            uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
+            crsfProcessDisplayPortCmd(frameStart);
+            break;
+        }
+#endif
+#if defined(USE_CRSF_LINK_STATISTICS)
+
+        case CRSF_FRAMETYPE_LINK_STATISTICS: {
+             // if to FC and 10 bytes + CRSF_FRAME_ORIGIN_DEST_SIZE
+             if ((rssiSource == RSSI_SOURCE_RX_PROTOCOL_CRSF) &&
+                 (crsfFrame.frame.deviceAddress == CRSF_ADDRESS_FLIGHT_CONTROLLER) &&
+                 (crsfFrame.frame.frameLength == CRSF_FRAME_ORIGIN_DEST_SIZE + CRSF_FRAME_LINK_STATISTICS_PAYLOAD_SIZE)) {
+                 const crsfLinkStatistics_t* statsFrame = (const crsfLinkStatistics_t*)&crsfFrame.frame.payload;
+                 handleCrsfLinkStatisticsFrame(statsFrame, frameTimeUs);
+             }
+            break;
+        }
+#endif
+        default:
+            break;
+    }
+}
+
 // Receive ISR callback, called back from serial port
 STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
 {
@@ -252,60 +306,42 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
     // full frame length includes the length of the address and framelength fields
     const int fullFrameLength = crsfFramePosition < 3 ? 5 : crsfFrame.frame.frameLength + CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_FRAMELENGTH;
 
-    if (crsfFramePosition < fullFrameLength) {
+    if (fullFrameLength > CRSF_FRAME_SIZE_MAX) {
+        // not a frame, it would run past the frame buffer
+        crsfFramePosition = 0;
+    } else if (crsfFramePosition < fullFrameLength) {
         crsfFrame.bytes[crsfFramePosition++] = (uint8_t)c;
         if (crsfFramePosition >= fullFrameLength) {
             crsfFramePosition = 0;
             const uint8_t crc = crsfFrameCRC();
             if (crc == crsfFrame.bytes[fullFrameLength - 1]) {
-                switch (crsfFrame.frame.type)
-                {
-                    case CRSF_FRAMETYPE_RC_CHANNELS_PACKED:
-                        if (crsfFrame.frame.deviceAddress == CRSF_ADDRESS_FLIGHT_CONTROLLER) {
-                            lastRcFrameTimeUs = currentTimeUs;
-                            crsfFrameDone = true;
-                            memcpy(&crsfChannelDataFrame, &crsfFrame, sizeof(crsfFrame));
-                        }
-                        break;
+                crsfProcessFrame(currentTimeUs);
+            }
+        }
+    }
+}
 
-#if defined(USE_TELEMETRY_CRSF) && defined(USE_MSP_OVER_TELEMETRY)
-                    case CRSF_FRAMETYPE_MSP_REQ:
-                    case CRSF_FRAMETYPE_MSP_WRITE: {
-                        uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
-                        if (bufferCrsfMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE)) {
-                            crsfScheduleMspResponse();
-                        }
-                        break;
-                    }
-#endif
-#if defined(USE_CRSF_CMS_TELEMETRY)
-                    case CRSF_FRAMETYPE_DEVICE_PING:
-                        crsfScheduleDeviceInfoResponse();
-                        break;
-                    case CRSF_FRAMETYPE_DISPLAYPORT_CMD: {
-                        uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
-                        crsfProcessDisplayPortCmd(frameStart);
-                        break;
-                    }
-#endif
-#if defined(USE_CRSF_LINK_STATISTICS)
+// Frame mode callback, called back from serial port with the bytes received before the line went idle
+STATIC_UNIT_TESTED void crsfDataReceiveFrame(const uint8_t *frame, uint16_t length, void *data)
+{
+    UNUSED(data);
 
-                    case CRSF_FRAMETYPE_LINK_STATISTICS: {
-                         // if to FC and 10 bytes + CRSF_FRAME_ORIGIN_DEST_SIZE
-                         if ((rssiSource == RSSI_SOURCE_RX_PROTOCOL_CRSF) &&
-                             (crsfFrame.frame.deviceAddress == CRSF_ADDRESS_FLIGHT_CONTROLLER) &&
-                             (crsfFrame.frame.frameLength == CRSF_FRAME_ORIGIN_DEST_SIZE + CRSF_FRAME_LINK_STATISTICS_PAYLOAD_SIZE)) {
-                             const crsfLinkStatistics_t* statsFrame = (const crsfLinkStatistics_t*)&crsfFrame.frame.payload;
-                             handleCrsfLinkStatisticsFrame(statsFrame, currentTimeUs);
-                         }
-                        break;
-                    }
-#endif
-                    default:
-                        break;
-                }
-            }
+    const timeUs_t currentTimeUs = microsISR();
+
+    unsigned position = 0;
+    while (position + CRSF_FRAME_LENGTH_NON_PAYLOAD <= length) {
+        const unsigned frameLength = frame[position + CRSF_FRAME_LENGTH_ADDRESS];
+        const unsigned fullFrameLength = frameLength + CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_FRAMELENGTH;
+        if (frameLength < CRSF_FRAME_LENGTH_TYPE_CRC || fullFrameLength > sizeof(crsfFrame) || position + fullFrameLength > length) {
+            // not a frame, drop the rest of the buffer
+            break;
         }
+
+        memcpy(crsfFrame.bytes, frame + position, fullFrameLength);
+        if (crsfFrameCRC() == crsfFrame.bytes[fullFrameLength - 1]) {
+            crsfProcessFrame(currentTimeUs);
+        }
+        position += fullFrameLength;
     }
 }
 
@@ -406,6 +442,11 @@ bool crsfRxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
         CRSF_PORT_OPTIONS | (rxConfig->serialrx_inverted ? SERIAL_INVERTED : 0)
         );
 
+    // Parse whole frames at line idle where the port supports it, otherwise byte by byte
+    if (serialPort) {
+        serialSetRxFrameCb(serialPort, crsfDataReceiveFrame, crsfRxFrameBuffer, sizeof(crsfRxFrameBuffer));
+    }
+
         if (rssiSource == RSSI_SOURCE_NONE) {
             rssiSource = RSSI_SOURCE_RX_PROTOCOL_CRSF;
         }
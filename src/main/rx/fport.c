@@ -130,6 +130,7 @@ static const smartPortPayload_t emptySmartPortFrame = { .frameId = 0, .valueId =
 typedef struct fportBuffer_s {
     uint8_t data[BUFFER_SIZE];
     uint8_t length;
+    timeUs_t frameTimeUs; // when the closing frame marker was received
 } fportBuffer_t;
 
 static fportBuffer_t rxBuffer[NUM_RX_BUFFERS];
@@ -144,6 +145,7 @@ static volatile uint8_t framePosition = 0;
 
 static smartPortPayload_t *mspPayload = NULL;
 static timeUs_t lastRcFrameReceivedMs = 0;
+static timeUs_t lastRcFrameTimeUs = 0;
 
 static serialPort_t *fportPort;
 #ifdef USE_TELEMETRY_SMARTPORT
@@ -169,7 +171,7 @@ static void fportDataReceive(uint16_t c, void *data)
     static timeUs_t lastFrameReceivedUs = 0;
     static bool telemetryFrame = false;
 
-    const timeUs_t currentTimeUs = micros();
+    const timeUs_t currentTimeUs = microsISR();
 
     clearToSend = false;
 
@@ -186,6 +188,7 @@ static void fportDataReceive(uint16_t c, void *data)
             const uint8_t nextWriteIndex = (rxBufferWriteIndex + 1) % NUM_RX_BUFFERS;
             if (nextWriteIndex != rxBufferReadIndex) {
                 rxBuffer[rxBufferWriteIndex].length = framePosition - 1;
+                rxBuffer[rxBufferWriteIndex].frameTimeUs = currentTimeUs;
                 rxBufferWriteIndex = nextWriteIndex;
             }
 
@@ -197,10 +200,10 @@ static void fportDataReceive(uint16_t c, void *data)
 
             DEBUG_SET(DEBUG_FPORT, DEBUG_FPORT_FRAME_INTERVAL, currentTimeUs - lastFrameReceivedUs);
             lastFrameReceivedUs = currentTimeUs;
-
-            escapedCharacter = false;
         }
 
+        // also after a frame that was dropped part way through an escape sequence
+        escapedCharacter = false;
         frameStartAt = currentTimeUs;
         framePosition = 1;
     } else if (framePosition > 0) {
@@ -282,6 +285,8 @@ static uint8_t fportFrameStatus(rxRuntimeState_t *rxRuntimeState)
                         reportFrameError(DEBUG_FPORT_ERROR_TYPE_SIZE);
                     } else {
                         result = sbusChannelsDecode(rxRuntimeState, &frame->data.controlData.channels);
+                        // Zero if it wasn't valid new channel data
+                        lastRcFrameTimeUs = result == RX_FRAME_COMPLETE ? rxBuffer[rxBufferReadIndex].frameTimeUs : 0;
 
                         setRssi(scaleRange(frame->data.controlData.rssi, 0, 100, 0, RSSI_MAX_VALUE), RSSI_SOURCE_RX_PROTOCOL);
 
@@ -390,6 +395,13 @@ static bool fportProcessFrame(const rxRuntimeState_t *rxRuntimeState)
     return true;
 }
 
+static timeUs_t fportFrameTimeUs(void)
+{
+    const timeUs_t result = lastRcFrameTimeUs;
+    lastRcFrameTimeUs = 0;
+    return result;
+}
+
 bool fportRxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 {
     static uint16_t sbusChannelData[SBUS_MAX_CHANNEL];
@@ -401,6 +413,7 @@ bool fportRxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 
     rxRuntimeState->rcFrameStatusFn = fportFrameStatus;
     rxRuntimeState->rcProcessFrameFn = fportProcessFrame;
+    rxRuntimeState->rcFrameTimeUsFn = fportFrameTimeUs;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
@@ -188,14 +188,17 @@ static void jetiExBusDataReceive(uint16_t c, void *data)
 
     // Check the header for the message length
     if (jetiExBusFramePosition == EXBUS_HEADER_LEN) {
+        const uint8_t frameLength = jetiExBusFrame[EXBUS_HEADER_MSG_LEN];
+        // a length shorter than the header and CRC would never complete and run past the buffer
+        const bool frameLengthValid = frameLength >= EXBUS_OVERHEAD;
 
-        if ((jetiExBusFrameState == EXBUS_STATE_IN_PROGRESS) && (jetiExBusFrame[EXBUS_HEADER_MSG_LEN] <= EXBUS_MAX_CHANNEL_FRAME_SIZE)) {
-            jetiExBusFrameLength = jetiExBusFrame[EXBUS_HEADER_MSG_LEN];
+        if ((jetiExBusFrameState == EXBUS_STATE_IN_PROGRESS) && frameLengthValid && (frameLength <= EXBUS_MAX_CHANNEL_FRAME_SIZE)) {
+            jetiExBusFrameLength = frameLength;
             return;
         }
 
-        if ((jetiExBusRequestState == EXBUS_STATE_IN_PROGRESS) && (jetiExBusFrame[EXBUS_HEADER_MSG_LEN] <= EXBUS_MAX_REQUEST_FRAME_SIZE)) {
-            jetiExBusFrameLength = jetiExBusFrame[EXBUS_HEADER_MSG_LEN];
+        if ((jetiExBusRequestState == EXBUS_STATE_IN_PROGRESS) && frameLengthValid && (frameLength <= EXBUS_MAX_REQUEST_FRAME_SIZE)) {
+            jetiExBusFrameLength = frameLength;
             return;
         }
 
@@ -207,10 +210,11 @@ static void jetiExBusDataReceive(uint16_t c, void *data)
 
     // Done?
     if (jetiExBusFrameLength == jetiExBusFramePosition) {
-        if (jetiExBusFrameState == EXBUS_STATE_IN_PROGRESS)
+        if (jetiExBusFrameState == EXBUS_STATE_IN_PROGRESS) {
+            lastRcFrameTimeUs = now;
             jetiExBusFrameState = EXBUS_STATE_RECEIVED;
+        }
         if (jetiExBusRequestState == EXBUS_STATE_IN_PROGRESS) {
-            lastRcFrameTimeUs = now;
             jetiExBusRequestState = EXBUS_STATE_RECEIVED;
             jetiTimeStampRequest = now;
         }
@@ -41,6 +41,7 @@
 #include "drivers/rx/rx_pwm.h"
 #include "drivers/time.h"
 
+#include "fc/latency_trace.h"
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
 
@@ -862,15 +863,19 @@ bool isRssiConfigured(void)
     return rssiSource != RSSI_SOURCE_NONE;
 }
 
+static timeUs_t previousFrameTimeUs = 0;
+
 bool rxGetFrameDelta(timeDelta_t *deltaUs)
 {
-    static timeUs_t previousFrameTimeUs = 0;
     bool result = false;
 
     *deltaUs = 0;
     if (rxRuntimeState.rcFrameTimeUsFn) {
         const timeUs_t frameTimeUs = rxRuntimeState.rcFrameTimeUsFn();
         if (frameTimeUs) {
+#ifdef USE_LATENCY_TRACE
+            latencyTraceFrame(frameTimeUs);
+#endif
             if (previousFrameTimeUs) {
                 *deltaUs = cmpTimeUs(frameTimeUs, previousFrameTimeUs);
                 result = true;
@@ -880,3 +885,9 @@ bool rxGetFrameDelta(timeDelta_t *deltaUs)
     }
     return result;  // No frame delta function available for protocol type or frames have stopped
 }
+
+// Timestamp of the last frame seen by rxGetFrameDelta(), 0 if the protocol doesn't supply one
+timeUs_t rxGetFrameTimeUs(void)
+{
+    return previousFrameTimeUs;
+}
@@ -208,3 +208,4 @@ void resumeRxPwmPpmSignal(void);
 uint16_t rxGetRefreshRate(void);
 
 bool rxGetFrameDelta(timeDelta_t *deltaUs);
+timeUs_t rxGetFrameTimeUs(void);
@@ -128,7 +128,7 @@ static uint8_t spektrumFrameStatus(rxRuntimeState_t *rxRuntimeState)
 #endif
 
         // Get the VTX control bytes in a frame
-        uint32_t vtxControl = ((spekFrame[SPEKTRUM_VTX_CONTROL_1] << 24) |
+        uint32_t vtxControl = (((uint32_t)spekFrame[SPEKTRUM_VTX_CONTROL_1] << 24) |
                             (spekFrame[SPEKTRUM_VTX_CONTROL_2] << 16) |
                             (spekFrame[SPEKTRUM_VTX_CONTROL_3] <<  8) |
                             (spekFrame[SPEKTRUM_VTX_CONTROL_4] <<  0) );
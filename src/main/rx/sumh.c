@@ -59,6 +59,7 @@ static uint32_t sumhChannels[SUMH_MAX_CHANNEL_COUNT];
 
 static serialPort_t *sumhPort;
 
+static timeUs_t lastRcFrameTimeUs = 0;
 
 // Receive ISR callback
 static void sumhDataReceive(uint16_t c, void *data)
@@ -69,7 +70,7 @@ static void sumhDataReceive(uint16_t c, void *data)
     static uint32_t sumhTimeLast, sumhTimeInterval;
     static uint8_t sumhFramePosition;
 
-    sumhTime = micros();
+    sumhTime = microsISR();
     sumhTimeInterval = sumhTime - sumhTimeLast;
     sumhTimeLast = sumhTime;
     if (sumhTimeInterval > 5000) {
@@ -79,6 +80,7 @@ static void sumhDataReceive(uint16_t c, void *data)
     sumhFrame[sumhFramePosition] = (uint8_t) c;
     if (sumhFramePosition == SUMH_FRAME_SIZE - 1) {
         // FIXME at this point the value of 'c' is unused and un tested, what should it be, is it important?
+        lastRcFrameTimeUs = sumhTime;
         sumhFrameDone = true;
     } else {
         sumhFramePosition++;
@@ -98,6 +100,7 @@ static uint8_t sumhFrameStatus(rxRuntimeState_t *rxRuntimeState)
     sumhFrameDone = false;
 
     if (!((sumhFrame[0] == 0xA8) && (sumhFrame[SUMH_FRAME_SIZE - 2] == 0))) {
+        lastRcFrameTimeUs = 0;  // We received a frame but it wasn't valid new channel data
         return RX_FRAME_PENDING;
     }
 
@@ -119,6 +122,13 @@ static uint16_t sumhReadRawRC(const rxRuntimeState_t *rxRuntimeState, uint8_t ch
     return sumhChannels[chan];
 }
 
+static timeUs_t sumhFrameTimeUs(void)
+{
+    const timeUs_t result = lastRcFrameTimeUs;
+    lastRcFrameTimeUs = 0;
+    return result;
+}
+
 bool sumhInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 {
     UNUSED(rxConfig);
@@ -128,6 +138,7 @@ bool sumhInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 
     rxRuntimeState->rcReadRawFn = sumhReadRawRC;
     rxRuntimeState->rcFrameStatusFn = sumhFrameStatus;
+    rxRuntimeState->rcFrameTimeUsFn = sumhFrameTimeUs;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
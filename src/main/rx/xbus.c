@@ -91,6 +91,7 @@ static uint8_t xBusProvider;
 // Use max values for ram areas
 static volatile uint8_t xBusFrame[XBUS_FRAME_SIZE_A2];  //size 35 for 16 channels in xbus_Mode_B
 static uint16_t xBusChannelData[XBUS_RJ01_CHANNEL_COUNT];
+static timeUs_t lastRcFrameTimeUs = 0;
 
 // Full RJ01 message CRC calculations
 static uint8_t xBusRj01CRC8(uint8_t inData, uint8_t seed)
@@ -113,7 +114,7 @@ static uint8_t xBusRj01CRC8(uint8_t inData, uint8_t seed)
 }
 
 
-static void xBusUnpackModeBFrame(uint8_t offsetBytes)
+static void xBusUnpackModeBFrame(uint8_t offsetBytes, timeUs_t frameTimeUs)
 {
     // Calculate the CRC of the incoming frame
     // Calculate on all bytes except the final two CRC bytes
@@ -134,11 +135,12 @@ static void xBusUnpackModeBFrame(uint8_t offsetBytes)
             xBusChannelData[i] = XBUS_CONVERT_TO_USEC(value);
         }
 
+        lastRcFrameTimeUs = frameTimeUs;
         xBusFrameReceived = true;
     }
 }
 
-static void xBusUnpackRJ01Frame(void)
+static void xBusUnpackRJ01Frame(timeUs_t frameTimeUs)
 {
     // Calculate the CRC of the incoming frame
     uint8_t outerCrc = 0;
@@ -182,7 +184,7 @@ static void xBusUnpackRJ01Frame(void)
     }
 
     // Now unpack the "embedded MODE B frame"
-    xBusUnpackModeBFrame(XBUS_RJ01_OFFSET_BYTES);
+    xBusUnpackModeBFrame(XBUS_RJ01_OFFSET_BYTES, frameTimeUs);
 }
 
 // Receive ISR callback
@@ -190,11 +192,11 @@ static void xBusDataReceive(uint16_t c, void *data)
 {
     UNUSED(data);
 
-    uint32_t now;
+    timeUs_t now;
     static uint32_t xBusTimeLast, xBusTimeInterval;
 
     // Check if we shall reset frame position due to time
-    now = micros();
+    now = microsISR();
     xBusTimeInterval = now - xBusTimeLast;
     xBusTimeLast = now;
     if (xBusTimeInterval > XBUS_MAX_FRAME_TIME) {
@@ -224,10 +226,10 @@ static void xBusDataReceive(uint16_t c, void *data)
     if (xBusFramePosition == xBusFrameLength) {
         switch (xBusProvider) {
         case SERIALRX_XBUS_MODE_B:
-            xBusUnpackModeBFrame(0);
+            xBusUnpackModeBFrame(0, now);
             FALLTHROUGH; //!!TODO - check this fall through is correct
         case SERIALRX_XBUS_MODE_B_RJ01:
-            xBusUnpackRJ01Frame();
+            xBusUnpackRJ01Frame(now);
         }
         xBusDataIncoming = false;
         xBusFramePosition = 0;
@@ -262,6 +264,13 @@ static uint16_t xBusReadRawRC(const rxRuntimeState_t *rxRuntimeState, uint8_t ch
     return data;
 }
 
+static timeUs_t xBusFrameTimeUs(void)
+{
+    const timeUs_t result = lastRcFrameTimeUs;
+    lastRcFrameTimeUs = 0;
+    return result;
+}
+
 bool xBusInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 {
     uint32_t baudRate;
@@ -296,6 +305,7 @@ bool xBusInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
 
     rxRuntimeState->rcReadRawFn = xBusReadRawRC;
     rxRuntimeState->rcFrameStatusFn = xBusFrameStatus;
+    rxRuntimeState->rcFrameTimeUsFn = xBusFrameTimeUs;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
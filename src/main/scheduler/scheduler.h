@@ -82,6 +82,9 @@ typedef enum {
 #ifdef USE_BEEPER
     TASK_BEEPER,
 #endif
+#ifdef USE_BLACKBOX
+    TASK_BLACKBOX,
+#endif
 #ifdef USE_GPS
     TASK_GPS,
 #endif
@@ -47,6 +47,7 @@ const timerHardware_t timerHardware[1]; // unused
 
 #include "config/feature.h"
 #include "config/config.h"
+#include "config/config_streamer.h"
 #include "scheduler/scheduler.h"
 
 #include "pg/rx.h"
@@ -565,8 +566,10 @@ void FLASH_Lock(void) {
 }
 
 FLASH_Status FLASH_ErasePage(uintptr_t Page_Address) {
-    UNUSED(Page_Address);
-//    printf("[FLASH_ErasePage]%x\n", Page_Address);
+    if ((Page_Address >= (uintptr_t)eepromData) && (Page_Address < (uintptr_t)ARRAYEND(eepromData))) {
+        memset((void *)Page_Address, 0xFF, MIN((uintptr_t)FLASH_PAGE_SIZE, (uintptr_t)ARRAYEND(eepromData) - Page_Address));
+//        printf("[FLASH_ErasePage]%p\n", (void*)Page_Address);
+    }
     return FLASH_COMPLETE;
 }
 
@@ -44,6 +44,10 @@
 #ifndef MAX7456_SPI_INSTANCE
 #define MAX7456_SPI_INSTANCE            NULL
 #endif
+
+#ifndef MAX7456_VSYNC_PIN
+#define MAX7456_VSYNC_PIN               NONE
+#endif
 #endif
 
 // pg/flash
@@ -51,6 +51,7 @@
 #define USE_SRAM2
 #if defined(STM32F40_41xxx)
 #define USE_FAST_RAM
+#define USE_CLI_SETTING_NAME_INDEX
 #endif
 #define USE_DSHOT
 #define USE_DSHOT_BITBANG
@@ -102,6 +103,9 @@
 #define USE_TIMER_MGMT
 #define USE_PERSISTENT_OBJECTS
 #define USE_CUSTOM_DEFAULTS_ADDRESS
+#if !defined(STM32F722xx)
+#define USE_CLI_SETTING_NAME_INDEX
+#endif
 // Re-enable this after 4.0 has been released, and remove the define from STM32F4DISCOVERY
 //#define USE_SPI_TRANSACTION
 #endif // STM32F7
@@ -121,6 +125,7 @@
 #define USE_TIMER_MGMT
 #define USE_PERSISTENT_OBJECTS
 #define USE_DMA_RAM
+#define USE_CLI_SETTING_NAME_INDEX
 #endif
 
 #if defined(STM32F4) || defined(STM32F7) || defined(STM32H7)
@@ -286,6 +291,7 @@
 
 #if ((TARGET_FLASH_SIZE > 256) || (FEATURE_CUT_LEVEL < 4))
 #define USE_HUFFMAN
+#define USE_LZ
 #define USE_PINIO
 #define USE_PINIOBOX
 #endif
@@ -313,6 +319,7 @@
 
 #if ((TARGET_FLASH_SIZE > 256) || (FEATURE_CUT_LEVEL < 1))
 #define USE_BOARD_INFO
+#define USE_MSP_SETTINGS
 #define USE_EXTENDED_CMS_MENUS
 #define USE_RTC_TIME
 #define USE_RX_MSP
@@ -355,6 +362,7 @@
 #define USE_OSD_PROFILES
 #define USE_OSD_STICK_OVERLAY
 #define USE_ESCSERIAL_SIMONK
+#define USE_LATENCY_TRACE
 #define USE_SERIAL_4WAY_SK_BOOTLOADER
 #define USE_CMS_FAILSAFE_MENU
 #define USE_CMS_GPS_RESCUE_MENU
@@ -75,6 +75,7 @@ extern "C" {
     acc_t acc = {};
     bool mockIsUpright = false;
     uint8_t activePidLoopDenom = 1;
+    gyro_t gyro;
 }
 
 uint32_t simulationFeatureFlags = 0;
@@ -1072,6 +1073,7 @@ extern "C" {
     void processRcCommand(void) {}
     void updateGpsStateForHomeAndHoldMode(void) {}
     void blackboxUpdate(timeUs_t) {}
+    void blackboxCaptureGyroRaw(timeUs_t, const int16_t *) {}
     void transponderUpdate(timeUs_t) {}
     void GPS_reset_home_position(void) {}
     void accStartCalibration(void) {}
@@ -240,6 +240,49 @@ TEST(BlackboxTest, TestWriteTag2_3SVariable_BITS887)
     EXPECT_EQ(0, buf[3]); // ensure next byte has not been written
     buf += 3;
 }
+
+TEST(BlackboxEncodingTest, TestWriteRice)
+{
+    serialTestResetBuffers();
+    uint32_t magnitudeSum = 0;
+
+    // k stays 0 for small values: 0 -> 0, -1 -> 10, 1 -> 110, padded to a byte
+    blackboxWriteRice(0, &magnitudeSum);
+    blackboxWriteRice(-1, &magnitudeSum);
+    blackboxWriteRice(1, &magnitudeSum);
+    EXPECT_EQ(0, serialWritePos);
+    blackboxFlushBits();
+    EXPECT_EQ(1, serialWritePos);
+    EXPECT_EQ(0x58, serialWriteBuffer[0]); // 0101 1000
+    EXPECT_EQ(3U, magnitudeSum);
+
+    // flushing again writes nothing
+    blackboxFlushBits();
+    EXPECT_EQ(1, serialWritePos);
+}
+
+TEST(BlackboxEncodingTest, TestWriteRiceEscape)
+{
+    serialTestResetBuffers();
+    uint32_t magnitudeSum = 0;
+
+    // 100 -> 200 is too large for k = 0, so 12 ones, the length less one in 5 bits and 8 bits of value
+    blackboxWriteRice(100, &magnitudeSum);
+    blackboxFlushBits();
+    EXPECT_EQ(4, serialWritePos);
+    EXPECT_EQ(0xFF, serialWriteBuffer[0]); // 1111 1111
+    EXPECT_EQ(0xF3, serialWriteBuffer[1]); // 1111 0011
+    EXPECT_EQ(0xE4, serialWriteBuffer[2]); // 1110 0100
+    EXPECT_EQ(0x00, serialWriteBuffer[3]); // 0 and padding
+    EXPECT_EQ(200U, magnitudeSum);
+
+    // which makes k = 5, 10 -> 20 is then a zero and 5 bits of remainder
+    blackboxWriteRice(10, &magnitudeSum);
+    blackboxFlushBits();
+    EXPECT_EQ(5, serialWritePos);
+    EXPECT_EQ(0x50, serialWriteBuffer[4]); // 0101 00 and padding
+}
+
 // STUBS
 extern "C" {
 PG_REGISTER(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 0);
@@ -14,8 +14,11 @@
  * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <math.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 extern "C" {
     #include "platform.h"
@@ -23,6 +26,7 @@ extern "C" {
     #include "build/debug.h"
 
     #include "blackbox/blackbox.h"
+    #include "blackbox/blackbox_fielddefs.h"
     #include "common/utils.h"
 
     #include "pg/pg.h"
@@ -40,19 +44,31 @@ extern "C" {
 
     #include "fc/rc_controls.h"
     #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/servos.h"
 
     #include "io/gps.h"
     #include "io/serial.h"
 
     #include "rx/rx.h"
 
+    #include "sensors/acceleration.h"
+    #include "sensors/barometer.h"
     #include "sensors/battery.h"
+    #include "sensors/compass.h"
     #include "sensors/gyro.h"
+    #include "sensors/sensors.h"
 
     extern int16_t blackboxIInterval;
     extern int16_t blackboxPInterval;
+    extern pidProfile_t *currentPidProfile;
 }
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include "unittest_macros.h"
 #include "gtest/gtest.h"
 
@@ -328,6 +344,821 @@ TEST(BlackboxTest, Test_CalculateRates)
 }
 
 
+// The simulated flight controller, every logged value is a function of the loop iteration
+static uint32_t simulationMillis;
+static uint32_t simulationSensors;
+static uint32_t simulationIteration;
+static int32_t simulationAmperage;
+static uint16_t simulationRssi;
+static uint16_t simulationVbat;
+// smooth gyro, motor and RC signals, as the high order predictors are meant for
+static bool simulationSmooth;
+// gyro samples per PID loop iteration, for R frames
+static uint32_t simulationGyroSamples;
+// PID loop iterations between runs of the blackbox task
+static uint32_t simulationEncodeInterval = 1;
+
+static uint8_t logBuffer[65536];
+static unsigned logLength;
+
+static serialPort_t blackboxTestPort;
+static serialPortConfig_t blackboxTestPortConfig;
+
+static pidProfile_t testPidProfile;
+
+static void simulateIteration(uint32_t t)
+{
+    simulationIteration = t;
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        pidData[i].P = (int)((t * 7 + i * 13) % 200) - 100;
+        pidData[i].I = t / 4 + i;
+        pidData[i].D = (int)((t * 5) % 60) - 30 + i;
+        pidData[i].F = (int)((t * 3) % 90) - 45;
+        gyro.gyroADCf[i] = (int)((t * 37 + i * 11) % 400) - 200;
+        acc.accADC[i] = 2048 + (int)(t % 16) - 8 + i;
+        mag.magADC[i] = 300 + i * 10 + t / 50;
+        rcCommand[i] = (int)(t % 100) - 50 + i;
+    }
+    rcCommand[THROTTLE] = 1000 + t % 500;
+    for (int i = 0; i < DEBUG16_VALUE_COUNT; i++) {
+        debug[i] = (t * (i + 1)) % 1000;
+    }
+    for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+        motor[i] = 1100 + (t * 3 + i * 50) % 800;
+    }
+    simulationVbat = 1680 - t / 100;
+    simulationAmperage = 1500 + t % 300;
+    simulationRssi = 1000 - t % 50;
+    baro.BaroAlt = 100 * t;
+    servo[5] = 1500 + (int)(t % 40) - 20;
+
+    if (simulationSmooth) {
+        for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+            // a little noise in the last bit or two, as a filtered gyro has
+            const int noise = ((t * 2654435761U + i * 40503U) >> 30) - 1;
+            gyro.gyroADCf[i] = lrintf(800 * sinf(t * 0.05f + i) + 100 * sinf(t * 0.3f + i)) + noise;
+            rcCommand[i] = lrintf(150 * sinf(t * 0.004f + i));
+            pidData[i].P = lrintf(60 * sinf(t * 0.05f + i));
+            pidData[i].D = lrintf(20 * sinf(t * 0.3f + i));
+            pidData[i].F = lrintf(40 * sinf(t * 0.004f + i));
+        }
+        for (int i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
+            motor[i] = 1400 + lrintf(300 * sinf(t * 0.05f + i) + 60 * sinf(t * 0.3f + i));
+        }
+    }
+}
+
+static timeUs_t simulationTimeUs(uint32_t t)
+{
+    return 1000 * t + t % 3;
+}
+
+// The raw gyro sample n, taken at 4 * n us
+static void simulateGyroSample(uint32_t n, int16_t *gyroADCRaw)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroADCRaw[axis] = (int)((n * 97 + axis * 1000) % 4000) - 2000;
+    }
+}
+
+// The values the log must contain for iteration t, by header field name
+static std::map<std::string, int32_t> expectedFields(uint32_t t)
+{
+    simulateIteration(t);
+
+    std::map<std::string, int32_t> fields;
+    fields["time"] = simulationTimeUs(t);
+    for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+        const std::string index = "[" + std::to_string(i) + "]";
+        fields["axisP" + index] = pidData[i].P;
+        fields["axisI" + index] = pidData[i].I;
+        fields["axisD" + index] = pidData[i].D;
+        fields["axisF" + index] = pidData[i].F;
+        fields["gyroADC" + index] = gyro.gyroADCf[i];
+        fields["accSmooth" + index] = acc.accADC[i];
+        fields["magADC" + index] = mag.magADC[i];
+        fields["rcCommand" + index] = rcCommand[i];
+        fields["setpoint" + index] = rcCommand[i] * 3;
+    }
+    fields["rcCommand[3]"] = rcCommand[THROTTLE];
+    fields["setpoint[3]"] = t % 1000;
+    for (int i = 0; i < DEBUG16_VALUE_COUNT; i++) {
+        fields["debug[" + std::to_string(i) + "]"] = debug[i];
+    }
+    for (int i = 0; i < getMotorCount(); i++) {
+        fields["motor[" + std::to_string(i) + "]"] = motor[i];
+    }
+    fields["vbatLatest"] = simulationVbat;
+    fields["amperageLatest"] = simulationAmperage;
+    fields["BaroAlt"] = baro.BaroAlt;
+    fields["rssi"] = simulationRssi;
+    fields["servo[5]"] = servo[5];
+
+    return fields;
+}
+
+/*
+ * Reference decoder, as used by the log viewer.
+ *
+ * It knows nothing about the fields the firmware logs, it decodes the frames using only the field definitions
+ * written in the log header.
+ */
+typedef struct logFrameDef_s {
+    std::vector<std::string> names;
+    std::vector<int> isSigned;
+    std::vector<int> predictor;
+    std::vector<int> encoding;
+} logFrameDef_t;
+
+class LogDecoder {
+public:
+    LogDecoder(const uint8_t *log, unsigned length, int32_t vbatReference, int32_t minMotor)
+        : pos(log), end(log + length), vbatReference(vbatReference), minMotor(minMotor) {}
+
+    bool readHeader(void);
+    bool readFrame(char *frameType, std::map<std::string, int32_t> *fields);
+    unsigned bytesLeft(void) const { return end - pos; }
+
+    logFrameDef_t frameDefs[256];
+    // sum of the magnitudes of the P-frame residuals, by field name
+    std::map<std::string, uint64_t> pFrameResiduals;
+
+private:
+    const uint8_t *pos;
+    const uint8_t *end;
+    const int32_t vbatReference;
+    const int32_t minMotor;
+    std::vector<int32_t> previous[3];
+    // R frames are predicted from the previous R frame since the last I-frame
+    std::vector<int32_t> gyroRawPrevious[3];
+    std::vector<int32_t> adaptiveWeights[2];
+    std::vector<uint32_t> riceSums;
+    uint64_t bitBuffer = 0;
+    int bitCount = 0;
+
+    uint32_t readUnsignedVB(void);
+    int32_t readSignedVB(void);
+    void readTag2_3S32(int32_t *values);
+    void readTag8_4S16(int32_t *values);
+    void readTag8_8SVB(int32_t *values, int valueCount);
+    uint32_t readBits(int count);
+    int32_t readRice(uint32_t *magnitudeSum);
+    void readValues(const std::vector<int> &encoding, std::vector<int32_t> *values);
+    int32_t predict(const logFrameDef_t &def, int predictor, unsigned field, const std::vector<int32_t> &current, const std::vector<int32_t> *history);
+    void adapt(unsigned field, int32_t residual);
+};
+
+static int32_t signExtend(uint32_t value, int bits)
+{
+    return (int32_t)(value << (32 - bits)) >> (32 - bits);
+}
+
+static std::vector<std::string> splitHeaderValues(const std::string &values)
+{
+    std::vector<std::string> items;
+    size_t start = 0;
+    for (size_t comma; (comma = values.find(',', start)) != std::string::npos; start = comma + 1) {
+        items.push_back(values.substr(start, comma - start));
+    }
+    items.push_back(values.substr(start));
+    return items;
+}
+
+bool LogDecoder::readHeader(void)
+{
+    while (end - pos > 2 && pos[0] == 'H' && pos[1] == ' ') {
+        const uint8_t *lineEnd = (const uint8_t *)memchr(pos, '\n', end - pos);
+        if (!lineEnd) {
+            return false;
+        }
+        const std::string line((const char *)pos + 2, lineEnd - pos - 2);
+        pos = lineEnd + 1;
+
+        // H Field <frame type> <header name>:<value>,<value>...
+        if (line.compare(0, 6, "Field ") != 0) {
+            continue;
+        }
+        const size_t colon = line.find(':');
+        logFrameDef_t *def = &frameDefs[(uint8_t)line[6]];
+        const std::string name = line.substr(8, colon - 8);
+        const std::vector<std::string> values = splitHeaderValues(line.substr(colon + 1));
+
+        if (name == "name") {
+            def->names = values;
+        } else {
+            std::vector<int> *numbers = name == "signed" ? &def->isSigned : name == "predictor" ? &def->predictor : &def->encoding;
+            numbers->clear();
+            for (const std::string &value : values) {
+                numbers->push_back(atoi(value.c_str()));
+            }
+        }
+    }
+
+    // the P frame uses the field names of the I frame
+    frameDefs['P'].names = frameDefs['I'].names;
+    frameDefs['P'].isSigned = frameDefs['I'].isSigned;
+
+    return pos < end;
+}
+
+uint32_t LogDecoder::readUnsignedVB(void)
+{
+    uint32_t value = 0;
+    for (int shift = 0; pos < end && shift < 32; shift += 7) {
+        const uint8_t c = *pos++;
+        value |= (uint32_t)(c & 0x7F) << shift;
+        if (!(c & 0x80)) {
+            break;
+        }
+    }
+    return value;
+}
+
+int32_t LogDecoder::readSignedVB(void)
+{
+    const uint32_t value = readUnsignedVB();
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+void LogDecoder::readTag2_3S32(int32_t *values)
+{
+    uint8_t leadByte = *pos++;
+
+    switch (leadByte >> 6) {
+    case 0:
+        values[0] = signExtend((leadByte >> 4) & 0x03, 2);
+        values[1] = signExtend((leadByte >> 2) & 0x03, 2);
+        values[2] = signExtend(leadByte & 0x03, 2);
+        break;
+    case 1:
+        values[0] = signExtend(leadByte & 0x0F, 4);
+        values[1] = signExtend(*pos >> 4, 4);
+        values[2] = signExtend(*pos++ & 0x0F, 4);
+        break;
+    case 2:
+        values[0] = signExtend(leadByte & 0x3F, 6);
+        values[1] = signExtend(*pos++ & 0x3F, 6);
+        values[2] = signExtend(*pos++ & 0x3F, 6);
+        break;
+    case 3:
+        for (int i = 0; i < 3; i++, leadByte >>= 2) {
+            const int bytes = (leadByte & 0x03) + 1;
+            uint32_t value = 0;
+            for (int b = 0; b < bytes; b++) {
+                value |= (uint32_t)*pos++ << (8 * b);
+            }
+            values[i] = signExtend(value, 8 * bytes);
+        }
+        break;
+    }
+}
+
+void LogDecoder::readTag8_4S16(int32_t *values)
+{
+    uint8_t selector = *pos++;
+    bool haveNibble = false;
+    uint8_t buffer = 0;
+
+    for (int i = 0; i < 4; i++, selector >>= 2) {
+        switch (selector & 0x03) {
+        case 0:
+            values[i] = 0;
+            break;
+        case 1:
+            if (!haveNibble) {
+                buffer = *pos++;
+                values[i] = signExtend(buffer >> 4, 4);
+            } else {
+                values[i] = signExtend(buffer & 0x0F, 4);
+            }
+            haveNibble = !haveNibble;
+            break;
+        case 2:
+            if (!haveNibble) {
+                values[i] = (int8_t)*pos++;
+            } else {
+                const uint8_t high = buffer << 4;
+                buffer = *pos++;
+                values[i] = (int8_t)(high | (buffer >> 4));
+            }
+            break;
+        case 3:
+            if (!haveNibble) {
+                values[i] = (int16_t)((pos[0] << 8) | pos[1]);
+                pos += 2;
+            } else {
+                values[i] = (int16_t)((buffer << 12) | (pos[0] << 4) | (pos[1] >> 4));
+                buffer = pos[1];
+                pos += 2;
+            }
+            break;
+        }
+    }
+}
+
+void LogDecoder::readTag8_8SVB(int32_t *values, int valueCount)
+{
+    if (valueCount == 1) {
+        values[0] = readSignedVB();
+        return;
+    }
+    uint8_t header = *pos++;
+    for (int i = 0; i < valueCount; i++, header >>= 1) {
+        values[i] = (header & 0x01) ? readSignedVB() : 0;
+    }
+}
+
+uint32_t LogDecoder::readBits(int count)
+{
+    while (bitCount < count && pos < end) {
+        bitBuffer = (bitBuffer << 8) | *pos++;
+        bitCount += 8;
+    }
+    bitCount -= count;
+    return (bitBuffer >> bitCount) & ((1ULL << count) - 1);
+}
+
+int32_t LogDecoder::readRice(uint32_t *magnitudeSum)
+{
+    const uint32_t mean = *magnitudeSum >> (FLIGHT_LOG_RICE_MEAN_SHIFT + 1);
+    const int k = std::min(mean ? 32 - __builtin_clz(mean) : 0, FLIGHT_LOG_RICE_MAX_K);
+
+    uint32_t quotient = 0;
+    while (quotient < FLIGHT_LOG_RICE_ESCAPE && readBits(1)) {
+        quotient++;
+    }
+    uint32_t u;
+    if (quotient < FLIGHT_LOG_RICE_ESCAPE) {
+        u = (quotient << k) | readBits(k);
+    } else {
+        const int length = readBits(5) + 1;
+        u = length > 16 ? (readBits(length - 16) << 16) | readBits(16) : readBits(length);
+    }
+
+    *magnitudeSum += std::min(u, 0xFFFFU) - (*magnitudeSum >> FLIGHT_LOG_RICE_MEAN_SHIFT);
+    return (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+}
+
+void LogDecoder::readValues(const std::vector<int> &encoding, std::vector<int32_t> *values)
+{
+    const unsigned count = encoding.size();
+    values->assign(count + 4, 0);
+
+    for (unsigned i = 0; i < count; ) {
+        if (encoding[i] != FLIGHT_LOG_FIELD_ENCODING_RICE && encoding[i] != FLIGHT_LOG_FIELD_ENCODING_NULL) {
+            // skip the padding of the bits before a byte aligned field
+            bitCount = 0;
+        }
+        switch (encoding[i]) {
+        case FLIGHT_LOG_FIELD_ENCODING_SIGNED_VB:
+            (*values)[i++] = readSignedVB();
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_UNSIGNED_VB:
+            (*values)[i++] = readUnsignedVB();
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_NEG_14BIT:
+            (*values)[i++] = -signExtend(readUnsignedVB(), 14);
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG2_3S32:
+            readTag2_3S32(&(*values)[i]);
+            i += 3;
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG8_4S16:
+            readTag8_4S16(&(*values)[i]);
+            i += 4;
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_TAG8_8SVB: {
+            // consecutive fields with this encoding are written as a group of up to 8
+            unsigned groupCount = 1;
+            while (i + groupCount < count && groupCount < 8 && encoding[i + groupCount] == FLIGHT_LOG_FIELD_ENCODING_TAG8_8SVB) {
+                groupCount++;
+            }
+            readTag8_8SVB(&(*values)[i], groupCount);
+            i += groupCount;
+            break;
+        }
+        case FLIGHT_LOG_FIELD_ENCODING_RICE:
+            (*values)[i] = readRice(&riceSums[i]);
+            i++;
+            break;
+        case FLIGHT_LOG_FIELD_ENCODING_NULL:
+        default:
+            (*values)[i++] = 0;
+            break;
+        }
+    }
+    values->resize(count);
+    bitCount = 0;
+}
+
+int32_t LogDecoder::predict(const logFrameDef_t &def, int predictor, unsigned field, const std::vector<int32_t> &current, const std::vector<int32_t> *previous)
+{
+    switch (predictor) {
+    case FLIGHT_LOG_FIELD_PREDICTOR_PREVIOUS:
+        return previous[0][field];
+    case FLIGHT_LOG_FIELD_PREDICTOR_STRAIGHT_LINE:
+        return 2 * previous[0][field] - previous[1][field];
+    case FLIGHT_LOG_FIELD_PREDICTOR_AVERAGE_2:
+        return (previous[0][field] + previous[1][field]) / 2;
+    case FLIGHT_LOG_FIELD_PREDICTOR_QUADRATIC:
+        return 3 * (previous[0][field] - previous[1][field]) + previous[2][field];
+    case FLIGHT_LOG_FIELD_PREDICTOR_ADAPTIVE:
+        return previous[0][field] + ((adaptiveWeights[0][field] * (previous[0][field] - previous[1][field])
+            + adaptiveWeights[1][field] * (previous[1][field] - previous[2][field])) >> FLIGHT_LOG_ADAPTIVE_WEIGHT_SHIFT);
+    case FLIGHT_LOG_FIELD_PREDICTOR_MINMOTOR:
+        return minMotor;
+    case FLIGHT_LOG_FIELD_PREDICTOR_MOTOR_0:
+        for (unsigned i = 0; i < def.names.size(); i++) {
+            if (def.names[i] == "motor[0]") {
+                return current[i];
+            }
+        }
+        return 0;
+    case FLIGHT_LOG_FIELD_PREDICTOR_INC:
+        return previous[0][field] + 1;
+    case FLIGHT_LOG_FIELD_PREDICTOR_1500:
+        return 1500;
+    case FLIGHT_LOG_FIELD_PREDICTOR_VBATREF:
+        return vbatReference;
+    case FLIGHT_LOG_FIELD_PREDICTOR_0:
+    default:
+        return 0;
+    }
+}
+
+static int sign(int32_t value)
+{
+    return (value > 0) - (value < 0);
+}
+
+void LogDecoder::adapt(unsigned field, int32_t residual)
+{
+    const int32_t delta[2] = { previous[0][field] - previous[1][field], previous[1][field] - previous[2][field] };
+
+    for (int i = 0; i < 2; i++) {
+        adaptiveWeights[i][field] += sign(residual) * sign(delta[i]) * FLIGHT_LOG_ADAPTIVE_STEP;
+        adaptiveWeights[i][field] = std::max(-FLIGHT_LOG_ADAPTIVE_WEIGHT_LIMIT, std::min(FLIGHT_LOG_ADAPTIVE_WEIGHT_LIMIT, adaptiveWeights[i][field]));
+    }
+}
+
+bool LogDecoder::readFrame(char *frameType, std::map<std::string, int32_t> *fields)
+{
+    if (pos >= end) {
+        return false;
+    }
+    *frameType = *pos++;
+    const logFrameDef_t &def = frameDefs[(uint8_t)*frameType];
+    if (def.encoding.empty() || ((*frameType == 'P' || *frameType == 'R') && previous[0].empty())) {
+        return false;
+    }
+    std::vector<int32_t> *history = *frameType == 'R' ? gyroRawPrevious : previous;
+
+    std::vector<int32_t> values;
+    readValues(def.encoding, &values);
+    for (unsigned i = 0; i < values.size(); i++) {
+        const int32_t residual = values[i];
+        if (*frameType == 'P') {
+            pFrameResiduals[def.names[i]] += abs(residual);
+        }
+        values[i] += predict(def, def.predictor[i], i, values, history);
+        if (def.predictor[i] == FLIGHT_LOG_FIELD_PREDICTOR_ADAPTIVE) {
+            adapt(i, residual);
+        }
+    }
+
+    fields->clear();
+    for (unsigned i = 0; i < values.size(); i++) {
+        (*fields)[def.names[i]] = values[i];
+    }
+
+    if (*frameType == 'I') {
+        previous[0] = values;
+        previous[1] = values;
+        previous[2] = values;
+        adaptiveWeights[0].assign(values.size(), 0);
+        adaptiveWeights[1].assign(values.size(), 0);
+        riceSums.assign(values.size(), 0);
+        for (int i = 0; i < 3; i++) {
+            gyroRawPrevious[i].assign(frameDefs['R'].encoding.size(), 0);
+        }
+    } else if (*frameType == 'P' || *frameType == 'R') {
+        history[2] = history[1];
+        history[1] = history[0];
+        history[0] = values;
+    }
+
+    return pos <= end;
+}
+
+static void logFlight(uint32_t iterations)
+{
+    logLength = 0;
+    blackboxConfigMutable()->device = BLACKBOX_DEVICE_SERIAL;
+    blackboxConfigMutable()->p_ratio = 32;
+    blackboxTestPortConfig.blackbox_baudrateIndex = BAUD_2000000;
+    targetPidLooptime = 1000;
+    motorOutputLow = 1000;
+    currentPidProfile = &testPidProfile;
+
+    blackboxInit();
+    ENABLE_ARMING_FLAG(ARMED);
+
+    for (uint32_t t = 0; t < iterations; t++) {
+        simulationMillis = t;
+        for (uint32_t s = 0; s < simulationGyroSamples; s++) {
+            const uint32_t n = t * simulationGyroSamples + s;
+            int16_t gyroADCRaw[XYZ_AXIS_COUNT];
+            simulateGyroSample(n, gyroADCRaw);
+            blackboxCaptureGyroRaw(n * 1000 / simulationGyroSamples, gyroADCRaw);
+        }
+        simulateIteration(t);
+        blackboxUpdate(simulationTimeUs(t));
+        if ((t + 1) % simulationEncodeInterval == 0) {
+            blackboxEncode(simulationTimeUs(t));
+        }
+    }
+    blackboxEncode(simulationTimeUs(iterations));
+
+    DISABLE_ARMING_FLAG(ARMED);
+}
+
+static int gyroRawFrames;
+
+// Decodes the log of a flight, checks every logged value and returns the number of main frames
+static int checkFlightLog(const std::vector<std::string> &expectedNames, unsigned *pFrameBytes = nullptr, uint64_t *smoothResiduals = nullptr)
+{
+    // the reference voltage is the voltage at the start of the log
+    simulateIteration(0);
+    LogDecoder decoder(logBuffer, logLength, simulationVbat, motorOutputLow);
+
+    EXPECT_TRUE(decoder.readHeader());
+    EXPECT_EQ(expectedNames, decoder.frameDefs['I'].names);
+
+    int mainFrames = 0;
+    gyroRawFrames = 0;
+    char frameType;
+    std::map<std::string, int32_t> fields;
+    for (unsigned bytesLeft = decoder.bytesLeft(); decoder.readFrame(&frameType, &fields); bytesLeft = decoder.bytesLeft()) {
+        if (frameType == 'R') {
+            const uint32_t n = fields["time"] * simulationGyroSamples / 1000;
+            int16_t gyroADCRaw[XYZ_AXIS_COUNT];
+            simulateGyroSample(n, gyroADCRaw);
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                EXPECT_EQ(gyroADCRaw[axis], fields["gyroRaw[" + std::to_string(axis) + "]"]) << "R frame " << n;
+            }
+            gyroRawFrames++;
+            continue;
+        }
+        if (frameType != 'I' && frameType != 'P') {
+            continue;
+        }
+        if (frameType == 'P' && pFrameBytes) {
+            *pFrameBytes += bytesLeft - decoder.bytesLeft();
+        }
+        const uint32_t t = fields["loopIteration"];
+        // the iteration count runs from the start of logging, but the time identifies the simulated iteration
+        const std::map<std::string, int32_t> expected = expectedFields(fields["time"] / 1000);
+        for (const auto &field : fields) {
+            if (field.first != "loopIteration") {
+                EXPECT_EQ(expected.at(field.first), field.second) << field.first << " in " << frameType << " frame " << t;
+            }
+        }
+        mainFrames++;
+    }
+    if (smoothResiduals) {
+        for (const auto &residual : decoder.pFrameResiduals) {
+            if (residual.first.compare(0, 7, "gyroADC") == 0 || residual.first.compare(0, 5, "motor") == 0 || residual.first.compare(0, 8, "setpoint") == 0) {
+                *smoothResiduals += residual.second;
+            }
+        }
+    }
+    return mainFrames;
+}
+
+TEST(BlackboxTest, TestLogDecodesWithAllFields)
+{
+    simulationSensors = SENSOR_ACC | SENSOR_MAG | SENSOR_BARO;
+    blackboxConfigMutable()->record_acc = 1;
+    batteryConfigMutable()->voltageMeterSource = VOLTAGE_METER_ADC;
+    batteryConfigMutable()->currentMeterSource = CURRENT_METER_ADC;
+    debugMode = DEBUG_GYRO_SCALED;
+    mixerConfigMutable()->mixerMode = MIXER_TRI;
+    testPidProfile.pid[PID_ROLL].D = 30;
+    testPidProfile.pid[PID_PITCH].D = 32;
+    testPidProfile.pid[PID_YAW].D = 0;
+
+    logFlight(1000);
+
+    const std::vector<std::string> names = {
+        "loopIteration", "time", "axisP[0]", "axisP[1]", "axisP[2]", "axisI[0]", "axisI[1]", "axisI[2]",
+        "axisD[0]", "axisD[1]", "axisF[0]", "axisF[1]", "axisF[2]",
+        "rcCommand[0]", "rcCommand[1]", "rcCommand[2]", "rcCommand[3]", "setpoint[0]", "setpoint[1]", "setpoint[2]", "setpoint[3]",
+        "vbatLatest", "amperageLatest", "magADC[0]", "magADC[1]", "magADC[2]", "BaroAlt", "rssi",
+        "gyroADC[0]", "gyroADC[1]", "gyroADC[2]", "accSmooth[0]", "accSmooth[1]", "accSmooth[2]",
+        "debug[0]", "debug[1]", "debug[2]", "debug[3]", "motor[0]", "motor[1]", "motor[2]", "motor[3]", "servo[5]"
+    };
+    EXPECT_LT(500, checkFlightLog(names));
+
+    // and with all the P-frame fields bit packed
+    blackboxConfigMutable()->encoding = BLACKBOX_ENCODING_RICE;
+    blackboxConfigMutable()->predictor = BLACKBOX_PREDICTOR_ADAPTIVE;
+    logFlight(1000);
+    EXPECT_LT(500, checkFlightLog(names));
+    blackboxConfigMutable()->encoding = BLACKBOX_ENCODING_STANDARD;
+    blackboxConfigMutable()->predictor = BLACKBOX_PREDICTOR_STANDARD;
+}
+
+TEST(BlackboxTest, TestLogDecodesWithRequiredFields)
+{
+    simulationSensors = 0;
+    batteryConfigMutable()->voltageMeterSource = VOLTAGE_METER_NONE;
+    batteryConfigMutable()->currentMeterSource = CURRENT_METER_NONE;
+    debugMode = DEBUG_NONE;
+    mixerConfigMutable()->mixerMode = MIXER_QUADX;
+    testPidProfile.pid[PID_ROLL].D = 0;
+    testPidProfile.pid[PID_PITCH].D = 0;
+
+    logFlight(1000);
+
+    const std::vector<std::string> names = {
+        "loopIteration", "time", "axisP[0]", "axisP[1]", "axisP[2]", "axisI[0]", "axisI[1]", "axisI[2]",
+        "axisF[0]", "axisF[1]", "axisF[2]",
+        "rcCommand[0]", "rcCommand[1]", "rcCommand[2]", "rcCommand[3]", "setpoint[0]", "setpoint[1]", "setpoint[2]", "setpoint[3]",
+        "rssi", "gyroADC[0]", "gyroADC[1]", "gyroADC[2]", "motor[0]", "motor[1]", "motor[2]", "motor[3]"
+    };
+    EXPECT_LT(500, checkFlightLog(names));
+}
+
+TEST(BlackboxTest, TestLogGyroRawFrames)
+{
+    blackboxConfigMutable()->gyro_raw = 1;
+    simulationGyroSamples = 4;
+
+    logFlight(1000);
+
+    const std::vector<std::string> names = {
+        "loopIteration", "time", "axisP[0]", "axisP[1]", "axisP[2]", "axisI[0]", "axisI[1]", "axisI[2]",
+        "axisF[0]", "axisF[1]", "axisF[2]",
+        "rcCommand[0]", "rcCommand[1]", "rcCommand[2]", "rcCommand[3]", "setpoint[0]", "setpoint[1]", "setpoint[2]", "setpoint[3]",
+        "rssi", "gyroADC[0]", "gyroADC[1]", "gyroADC[2]", "motor[0]", "motor[1]", "motor[2]", "motor[3]"
+    };
+    const int mainFrames = checkFlightLog(names);
+    EXPECT_LT(500, mainFrames);
+    // every gyro sample while logging, at four times the rate of the main frames
+    EXPECT_EQ(4 * mainFrames, gyroRawFrames);
+
+    blackboxConfigMutable()->gyro_raw = 0;
+    simulationGyroSamples = 0;
+}
+
+TEST(BlackboxTest, TestGyroRawFramesWrittenBeforeLogEnd)
+{
+    blackboxConfigMutable()->gyro_raw = 1;
+    simulationGyroSamples = 4;
+
+    logFlight(1000);
+
+    // gyro samples captured after the blackbox task last ran are written before the end of log event
+    for (uint32_t n = 4000; n < 4004; n++) {
+        int16_t gyroADCRaw[XYZ_AXIS_COUNT];
+        simulateGyroSample(n, gyroADCRaw);
+        blackboxCaptureGyroRaw(n * 1000 / simulationGyroSamples, gyroADCRaw);
+    }
+    blackboxFinish();
+
+    const std::vector<std::string> names = {
+        "loopIteration", "time", "axisP[0]", "axisP[1]", "axisP[2]", "axisI[0]", "axisI[1]", "axisI[2]",
+        "axisF[0]", "axisF[1]", "axisF[2]",
+        "rcCommand[0]", "rcCommand[1]", "rcCommand[2]", "rcCommand[3]", "setpoint[0]", "setpoint[1]", "setpoint[2]", "setpoint[3]",
+        "rssi", "gyroADC[0]", "gyroADC[1]", "gyroADC[2]", "motor[0]", "motor[1]", "motor[2]", "motor[3]"
+    };
+    // the decoder stops at the event frame, so only R frames written before it are counted
+    const int mainFrames = checkFlightLog(names);
+    EXPECT_EQ(4 * mainFrames + 4, gyroRawFrames);
+    const char logEnd[] = "End of log";
+    ASSERT_LT(sizeof(logEnd), logLength);
+    EXPECT_EQ(0, memcmp(logBuffer + logLength - sizeof(logEnd), logEnd, sizeof(logEnd)));
+
+    blackboxConfigMutable()->gyro_raw = 0;
+    simulationGyroSamples = 0;
+}
+
+TEST(BlackboxTest, TestFramesEncodedByBlackboxTask)
+{
+    const std::vector<std::string> names = {
+        "loopIteration", "time", "axisP[0]", "axisP[1]", "axisP[2]", "axisI[0]", "axisI[1]", "axisI[2]",
+        "axisF[0]", "axisF[1]", "axisF[2]",
+        "rcCommand[0]", "rcCommand[1]", "rcCommand[2]", "rcCommand[3]", "setpoint[0]", "setpoint[1]", "setpoint[2]", "setpoint[3]",
+        "rssi", "gyroADC[0]", "gyroADC[1]", "gyroADC[2]", "motor[0]", "motor[1]", "motor[2]", "motor[3]"
+    };
+
+    logFlight(1000);
+    const int mainFrames = checkFlightLog(names);
+    EXPECT_LT(500, mainFrames);
+
+    // the PID loop only captures the main frames, the blackbox task encodes several at a time
+    simulationEncodeInterval = 8;
+    logFlight(1000);
+    EXPECT_EQ(mainFrames, checkFlightLog(names));
+
+    // if the blackbox task falls behind so far that the ring fills up no frames are lost
+    simulationEncodeInterval = 100;
+    logFlight(1000);
+    EXPECT_EQ(mainFrames, checkFlightLog(names));
+
+    // nothing is written until the blackbox task runs
+    simulationEncodeInterval = 1;
+    logFlight(500);
+    const unsigned length = logLength;
+    EXPECT_LT(0U, length);
+    blackboxUpdate(simulationTimeUs(500));
+    blackboxUpdate(simulationTimeUs(501));
+    EXPECT_EQ(length, logLength);
+    blackboxEncode(simulationTimeUs(501));
+    EXPECT_LT(length, logLength);
+}
+
+TEST(BlackboxTest, TestPredictorBytesPerFrame)
+{
+    // benchmark of the P-frame predictors, on the smooth signals of a gyro sampled at the loop rate
+    static const char * const predictorNames[] = { "STANDARD", "QUADRATIC", "ADAPTIVE" };
+    float bytesPerFrame[ARRAYLEN(predictorNames)];
+    uint64_t smoothResiduals[ARRAYLEN(predictorNames)] = { 0 };
+
+    simulationSmooth = true;
+    for (unsigned predictor = 0; predictor < ARRAYLEN(predictorNames); predictor++) {
+        blackboxConfigMutable()->predictor = predictor;
+        logFlight(1000);
+
+        unsigned pFrameBytes = 0;
+        const std::vector<std::string> names = {
+            "loopIteration", "time", "axisP[0]", "axisP[1]", "axisP[2]", "axisI[0]", "axisI[1]", "axisI[2]",
+            "axisF[0]", "axisF[1]", "axisF[2]",
+            "rcCommand[0]", "rcCommand[1]", "rcCommand[2]", "rcCommand[3]", "setpoint[0]", "setpoint[1]", "setpoint[2]", "setpoint[3]",
+            "rssi", "gyroADC[0]", "gyroADC[1]", "gyroADC[2]", "motor[0]", "motor[1]", "motor[2]", "motor[3]"
+        };
+        const int mainFrames = checkFlightLog(names, &pFrameBytes, &smoothResiduals[predictor]);
+        EXPECT_LT(500, mainFrames);
+
+        // every 32nd frame is an I-frame
+        const int pFrames = mainFrames - (mainFrames + 31) / 32;
+        bytesPerFrame[predictor] = (float)pFrameBytes / pFrames;
+        printf("blackbox_predictor %-9s %5.2f bytes per P-frame, mean gyro/motor/setpoint residual %5.2f\n",
+            predictorNames[predictor], (double)bytesPerFrame[predictor], (double)smoothResiduals[predictor] / (pFrames * 11)); // 3 gyros, 4 motors, 4 setpoints
+    }
+    simulationSmooth = false;
+    blackboxConfigMutable()->predictor = BLACKBOX_PREDICTOR_STANDARD;
+
+    EXPECT_GT(bytesPerFrame[BLACKBOX_PREDICTOR_STANDARD], bytesPerFrame[BLACKBOX_PREDICTOR_QUADRATIC]);
+    EXPECT_GT(bytesPerFrame[BLACKBOX_PREDICTOR_STANDARD], bytesPerFrame[BLACKBOX_PREDICTOR_ADAPTIVE]);
+    EXPECT_GT(smoothResiduals[BLACKBOX_PREDICTOR_STANDARD] / 2, smoothResiduals[BLACKBOX_PREDICTOR_QUADRATIC]);
+    EXPECT_GT(smoothResiduals[BLACKBOX_PREDICTOR_STANDARD] / 2, smoothResiduals[BLACKBOX_PREDICTOR_ADAPTIVE]);
+}
+
+TEST(BlackboxTest, TestEncodingBytesPerFrame)
+{
+    // benchmark of the P-frame encodings with the standard and adaptive predictors, on the smooth flight
+    static const char * const encodingNames[] = { "STANDARD", "RICE" };
+    static const uint8_t predictors[] = { BLACKBOX_PREDICTOR_STANDARD, BLACKBOX_PREDICTOR_ADAPTIVE };
+    float bytesPerFrame[ARRAYLEN(encodingNames)][ARRAYLEN(predictors)];
+
+    simulationSmooth = true;
+    for (unsigned encoding = 0; encoding < ARRAYLEN(encodingNames); encoding++) {
+        for (unsigned predictor = 0; predictor < ARRAYLEN(predictors); predictor++) {
+            blackboxConfigMutable()->encoding = encoding;
+            blackboxConfigMutable()->predictor = predictors[predictor];
+
+            const clock_t start = clock();
+            logFlight(1000);
+            const clock_t elapsed = clock() - start;
+
+            unsigned pFrameBytes = 0;
+            const std::vector<std::string> names = {
+                "loopIteration", "time", "axisP[0]", "axisP[1]", "axisP[2]", "axisI[0]", "axisI[1]", "axisI[2]",
+                "axisF[0]", "axisF[1]", "axisF[2]",
+                "rcCommand[0]", "rcCommand[1]", "rcCommand[2]", "rcCommand[3]", "setpoint[0]", "setpoint[1]", "setpoint[2]", "setpoint[3]",
+                "rssi", "gyroADC[0]", "gyroADC[1]", "gyroADC[2]", "motor[0]", "motor[1]", "motor[2]", "motor[3]"
+            };
+            const int mainFrames = checkFlightLog(names, &pFrameBytes);
+            EXPECT_LT(500, mainFrames);
+
+            bytesPerFrame[encoding][predictor] = (float)pFrameBytes / (mainFrames - (mainFrames + 31) / 32);
+            printf("blackbox_encoding %-8s predictor %-8s %5.2f bytes per P-frame, log %5u bytes, %4.2f us per iteration\n",
+                encodingNames[encoding], predictor ? "ADAPTIVE" : "STANDARD", (double)bytesPerFrame[encoding][predictor],
+                logLength, 1e6 * elapsed / CLOCKS_PER_SEC / 1000);
+        }
+    }
+    simulationSmooth = false;
+    blackboxConfigMutable()->encoding = BLACKBOX_ENCODING_STANDARD;
+    blackboxConfigMutable()->predictor = BLACKBOX_PREDICTOR_STANDARD;
+
+    // at least 30% smaller
+    for (unsigned predictor = 0; predictor < ARRAYLEN(predictors); predictor++) {
+        EXPECT_GT(0.7f * bytesPerFrame[BLACKBOX_ENCODING_STANDARD][predictor], bytesPerFrame[BLACKBOX_ENCODING_RICE][predictor]);
+    }
+}
+
+
 // STUBS
 extern "C" {
 
@@ -351,35 +1182,50 @@ int32_t GPS_home[2];
 gyro_t gyro;
 
 float motorOutputHigh, motorOutputLow;
+float motor[MAX_SUPPORTED_MOTORS];
 float motor_disarmed[MAX_SUPPORTED_MOTORS];
-struct pidProfile_s;
-struct pidProfile_s *currentPidProfile;
+int16_t servo[MAX_SUPPORTED_SERVOS];
+pidAxisData_t pidData[3];
+float rcCommand[4];
+acc_t acc;
+mag_t mag;
+baro_t baro;
+pidProfile_t *currentPidProfile;
 uint32_t targetPidLooptime;
 
 boxBitmask_t rcModeActivationMask;
 
 void mspSerialAllocatePorts(void) {}
 uint32_t getArmingBeepTimeMicros(void) {return 0;}
-uint16_t getBatteryVoltageLatest(void) {return 0;}
+uint16_t getBatteryVoltageLatest(void) {return simulationVbat;}
 uint8_t getMotorCount(void) {return 4;}
 bool areMotorsRunning(void) { return false; }
 bool IS_RC_MODE_ACTIVE(boxId_e) {return false;}
 bool isModeActivationConditionPresent(boxId_e) {return false;}
-uint32_t millis(void) {return 0;}
-bool sensors(uint32_t) {return false;}
-void serialWrite(serialPort_t *, uint8_t) {}
-uint32_t serialTxBytesFree(const serialPort_t *) {return 0;}
-bool isSerialTransmitBufferEmpty(const serialPort_t *) {return false;}
+uint32_t millis(void) {return simulationMillis;}
+bool sensors(uint32_t mask) {return simulationSensors & mask;}
+void serialWrite(serialPort_t *, uint8_t ch)
+{
+    if (logLength < sizeof(logBuffer)) {
+        logBuffer[logLength++] = ch;
+    }
+}
+uint32_t serialTxBytesFree(const serialPort_t *) {return 256;}
+bool isSerialTransmitBufferEmpty(const serialPort_t *) {return true;}
 bool featureIsEnabled(uint32_t) {return false;}
 void mspSerialReleasePortIfAllocated(serialPort_t *) {}
-const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e ) {return NULL;}
+const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e ) {return &blackboxTestPortConfig;}
 serialPort_t *findSharedSerialPort(uint16_t , serialPortFunction_e ) {return NULL;}
-serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) {return NULL;}
+serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) {return &blackboxTestPort;}
 void closeSerialPort(serialPort_t *) {}
 portSharing_e determinePortSharing(const serialPortConfig_t *, serialPortFunction_e ) {return PORTSHARING_UNUSED;}
 failsafePhase_e failsafePhase(void) {return FAILSAFE_IDLE;}
 bool rxAreFlightChannelsValid(void) {return false;}
 bool rxIsReceivingSignal(void) {return false;}
-bool isRssiConfigured(void) {return false;}
+bool isRssiConfigured(void) {return true;}
+uint16_t getRssi(void) {return simulationRssi;}
+int32_t getAmperageLatest(void) {return simulationAmperage;}
+float pidGetPreviousSetpoint(int axis) {return rcCommand[axis] * 3;}
+float mixerGetThrottle(void) {return (simulationIteration % 1000) / 1000.0f;}
 
 }
@@ -21,6 +21,9 @@
 #include <limits.h>
 
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 extern "C" {
     #include "platform.h"
@@ -56,6 +59,8 @@ extern "C" {
     void cliSet(char *cmdline);
     void cliGet(char *cmdline);
     int cliGetSettingIndex(char *name, uint8_t length);
+    void cliBuildSettingNameIndex(const clivalue_t *table, uint16_t count, uint16_t *nameIndex);
+    uint16_t cliFindSettingByName(const clivalue_t *table, uint16_t count, const uint16_t *nameIndex, const char *name, uint8_t length);
     void *cliGetValuePointer(const clivalue_t *value);
     
     const clivalue_t valueTable[] = {
@@ -64,6 +69,7 @@ extern "C" {
         { "wos_unit_test",     VAR_UINT8 | MODE_STRING | MASTER_VALUE, .config.string = { 0, 16, STRING_FLAGS_WRITEONCE }, PG_RESERVED_FOR_TESTING_1, 0 },
     };
     const uint16_t valueTableEntryCount = ARRAYLEN(valueTable);
+    uint16_t valueTableNameIndex[ARRAYLEN(valueTable)];
     const lookupTableEntry_t lookupTables[] = {};
     const char * const lookupTableOsdDisplayPortDevice[] = {};
 
@@ -192,6 +198,75 @@ TEST(CLIUnittest, TestCliSetStringWriteOnce)
     printf("\n");
 }
 
+TEST(CLIUnittest, TestCliGetSettingIndex)
+{
+    EXPECT_EQ(1, cliGetSettingIndex((char *)"str_unit_test", 13));
+    EXPECT_EQ(0, cliGetSettingIndex((char *)"ARRAY_unit_test", 15));
+
+    // only the given length is part of the name
+    EXPECT_EQ(2, cliGetSettingIndex((char *)"wos_unit_test = 1", 13));
+
+    // names must match exactly
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex((char *)"str_unit", 8));
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex((char *)"str_unit_test2", 14));
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex((char *)"aaa", 3));
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex((char *)"zzz", 3));
+}
+
+#define BENCHMARK_SETTING_COUNT 1000
+#define BENCHMARK_PASSES 50
+
+static uint16_t findSettingLinear(const clivalue_t *table, uint16_t count, const char *name, uint8_t length)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        if (strncasecmp(name, table[i].name, strlen(table[i].name)) == 0 && length == strlen(table[i].name)) {
+            return i;
+        }
+    }
+    return count;
+}
+
+TEST(CLIUnittest, TestCliSettingNameIndexThroughput)
+{
+    // a table about the size of a full target, in no particular order and with shared prefixes
+    static char names[BENCHMARK_SETTING_COUNT][24];
+    clivalue_t *table = (clivalue_t *)calloc(BENCHMARK_SETTING_COUNT, sizeof(clivalue_t));
+    static uint16_t nameIndex[BENCHMARK_SETTING_COUNT];
+    for (int i = 0; i < BENCHMARK_SETTING_COUNT; i++) {
+        const int n = (i * 617) % BENCHMARK_SETTING_COUNT;
+        snprintf(names[i], sizeof(names[i]), "%s_%d_%s", (n & 1) ? "osd" : "gyro", n / 2, (n % 3) ? "pos" : "hz");
+        table[i].name = names[i];
+    }
+
+    cliBuildSettingNameIndex(table, BENCHMARK_SETTING_COUNT, nameIndex);
+    for (int i = 1; i < BENCHMARK_SETTING_COUNT; i++) {
+        EXPECT_GT(0, strcasecmp(table[nameIndex[i - 1]].name, table[nameIndex[i]].name));
+    }
+
+    // resolve every name, like pasting a diff of all settings
+    clock_t start = clock();
+    for (int pass = 0; pass < BENCHMARK_PASSES; pass++) {
+        for (int i = 0; i < BENCHMARK_SETTING_COUNT; i++) {
+            EXPECT_EQ(i, findSettingLinear(table, BENCHMARK_SETTING_COUNT, names[i], strlen(names[i])));
+        }
+    }
+    const double linearSeconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int pass = 0; pass < BENCHMARK_PASSES; pass++) {
+        for (int i = 0; i < BENCHMARK_SETTING_COUNT; i++) {
+            EXPECT_EQ(i, cliFindSettingByName(table, BENCHMARK_SETTING_COUNT, nameIndex, names[i], strlen(names[i])));
+        }
+    }
+    const double indexedSeconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    const int lookups = BENCHMARK_PASSES * BENCHMARK_SETTING_COUNT;
+    printf("setting lookups: linear %.0f/s, indexed %.0f/s\n",
+        lookups / (linearSeconds > 0 ? linearSeconds : 1e-9), lookups / (indexedSeconds > 0 ? indexedSeconds : 1e-9));
+
+    free(table);
+}
+
 // STUBS
 extern "C" {
 
@@ -36,6 +36,8 @@ extern "C" {
     const void *cmsMenuBack(displayPort_t *pDisplay);
     uint16_t cmsHandleKey(displayPort_t *pDisplay, uint8_t key);
     extern CMS_Menu *currentMenu;    // Points to top entry of the current page
+    extern CMS_Menu cmsx_menuMain;
+    extern int16_t rcData[18];
 }
 
 #include "unittest_macros.h"
@@ -115,6 +117,115 @@ TEST(CMSUnittest, TestCmsMenuKey)
     uint16_t result = cmsHandleKey(displayPort, KEY_ESC);
     EXPECT_EQ(BUTTON_PAUSE, result);
 }
+
+static int testWriteCount;
+static int testWriteChars;
+
+static int displayPortCountingWriteString(displayPort_t *displayPort, uint8_t x, uint8_t y, uint8_t attr, const char *s)
+{
+    testWriteCount++;
+    testWriteChars += strlen(s);
+    return displayPortTestWriteString(displayPort, x, y, attr, s);
+}
+
+static uint32_t displayPortUnlimitedTxBytesFree(const displayPort_t *displayPort)
+{
+    UNUSED(displayPort);
+    return UINT32_MAX;
+}
+
+static displayPortVTable_t countingDisplayPortVTable;
+
+static uint16_t testDynamicValue;
+static uint8_t testStaticValue = 7;
+static OSD_UINT16_t testDynamicEntry = { &testDynamicValue, 0, 1000, 0 };
+static OSD_UINT8_t testStaticEntry = { &testStaticValue, 0, 100, 1 };
+
+static OSD_Entry testMenuEntries[] =
+{
+    {"-- TEST --", OME_Label, NULL, NULL, 0},
+    {"DYNAMIC", OME_UINT16, NULL, &testDynamicEntry, DYNAMIC},
+    {"STATIC", OME_UINT8, NULL, &testStaticEntry, 0},
+    {"STATIC AGAIN", OME_UINT8, NULL, &testStaticEntry, 0},
+    {NULL, OME_END, NULL, NULL, 0}
+};
+
+static CMS_Menu testMenu = {
+#ifdef CMS_MENU_DEBUG
+    .GUARD_text = "MENUTEST",
+    .GUARD_type = OME_MENU,
+#endif
+    .onEnter = NULL,
+    .onExit = NULL,
+    .onDisplayUpdate = NULL,
+    .entries = testMenuEntries,
+};
+
+static void testCmsUpdate(timeUs_t *currentTimeUs)
+{
+    testWriteCount = 0;
+    testWriteChars = 0;
+    *currentTimeUs += 200000;
+    cmsHandler(*currentTimeUs);
+}
+
+TEST(CMSUnittest, TestCmsPartialRedraw)
+{
+    // given
+    for (unsigned i = 0; i < ARRAYLEN(rcData); i++) {
+        rcData[i] = 1500;
+    }
+    cmsInit();
+    displayPort_t *displayPort = displayPortTestInit();
+    countingDisplayPortVTable = testDisplayPortVTable;
+    countingDisplayPortVTable.writeString = displayPortCountingWriteString;
+    countingDisplayPortVTable.txBytesFree = displayPortUnlimitedTxBytesFree;
+    displayPort->vTable = &countingDisplayPortVTable;
+    cmsDisplayPortRegister(displayPort);
+    cmsMenuExit(displayPort, (void*)0);
+    cmsMenuOpen();
+    cmsMenuChange(displayPort, &testMenu);
+    timeUs_t currentTimeUs = 0;
+
+    // when
+    testCmsUpdate(&currentTimeUs);
+
+    // then - cursor, labels and values
+    EXPECT_EQ(8, testWriteCount);
+
+    // when - the dynamic value is polled again
+    testCmsUpdate(&currentTimeUs);
+
+    // then - it is unchanged so nothing is written
+    EXPECT_EQ(0, testWriteCount);
+
+    // when
+    testDynamicValue = 123;
+    testCmsUpdate(&currentTimeUs);
+
+    // then - only the changed value is written
+    EXPECT_EQ(1, testWriteCount);
+    displayPortTestBufferSubstring(25, 7, "123");
+
+    // when - the display has a per update budget
+    displayPort->maxCmsCharsPerUpdate = 15;
+    cmsMenuChange(displayPort, &cmsx_menuMain);
+    cmsMenuChange(displayPort, &testMenu);
+    int updates = 0;
+    int totalWrites = 0;
+    do {
+        testCmsUpdate(&currentTimeUs);
+        EXPECT_GE(15 + (int)strlen("STATIC AGAIN") - 1, testWriteChars);
+        totalWrites += testWriteCount;
+        updates++;
+    } while (testWriteCount && updates < 10);
+
+    // then - the page is completed over several updates
+    EXPECT_LT(2, updates);
+    EXPECT_EQ(8, totalWrites);
+    displayPortTestBufferSubstring(3, 9, "STATIC AGAIN");
+    displayPortTestBufferSubstring(27, 9, "7");
+}
 // STUBS
 
 extern "C" {
@@ -0,0 +1,415 @@
+/*
+ * This file is part of Betaflight.
+ *
+ * Betaflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Betaflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Betaflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/crc.h"
+    #include "common/utils.h"
+
+    #include "config/config_eeprom.h"
+    #include "config/config_streamer.h"
+
+    #include "drivers/system.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    typedef struct testConfigA_s {
+        uint8_t value[60];
+    } testConfigA_t;
+
+    typedef struct testConfigB_s {
+        uint8_t value[100];
+    } testConfigB_t;
+
+    typedef struct testConfigC_s {
+        uint8_t value[200];
+    } testConfigC_t;
+
+    PG_DECLARE(testConfigA_t, testConfigA);
+    PG_DECLARE(testConfigB_t, testConfigB);
+    PG_DECLARE(testConfigC_t, testConfigC);
+
+    PG_REGISTER(testConfigA_t, testConfigA, PG_RESERVED_FOR_TESTING_1, 0);
+    PG_REGISTER(testConfigB_t, testConfigB, PG_RESERVED_FOR_TESTING_2, 0);
+    PG_REGISTER(testConfigC_t, testConfigC, PG_RESERVED_FOR_TESTING_3, 0);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define CONFIG_HEADER_SIZE  2
+#define UPDATE_HEADER_SIZE  2
+#define RECORD_HEADER_SIZE  6
+#define CONFIG_TAIL_SIZE    4   // footer and CRC
+
+// a full config, the header and every PG
+#define CONFIG_FULL_SIZE    (CONFIG_HEADER_SIZE + 3 * RECORD_HEADER_SIZE + sizeof(testConfigA_t) + sizeof(testConfigB_t) + sizeof(testConfigC_t) + CONFIG_TAIL_SIZE)
+
+/*
+ * Fake config streamer, storing the config in flash that is erased in pages and can only be
+ * written where erased
+ */
+
+// erased in pages like the embedded flash
+uint8_t eepromData[EEPROM_SIZE] __attribute__((aligned(FLASH_PAGE_SIZE)));
+
+static int configPageErases;   // erases of the page the config starts in, i.e. full rewrites
+static int flashWriteErrors;   // words written without erasing them first
+static int failureModes;
+
+static void eraseFlash(void)
+{
+    memset(eepromData, 0xFF, sizeof(eepromData));
+}
+
+void config_streamer_init(config_streamer_t *c)
+{
+    memset(c, 0, sizeof(*c));
+}
+
+void config_streamer_start(config_streamer_t *c, uintptr_t base, int size)
+{
+    c->address = base;
+    c->size = size;
+    c->unlocked = true;
+    c->err = 0;
+}
+
+static int writeFlashWord(config_streamer_t *c)
+{
+    if (c->err != 0) {
+        return c->err;
+    }
+    if (c->address < (uintptr_t)eepromData || c->address + CONFIG_STREAMER_BUFFER_SIZE > (uintptr_t)ARRAYEND(eepromData)) {
+        return -3;
+    }
+    if (c->address % FLASH_PAGE_SIZE == 0) {
+        memset((uint8_t *)c->address, 0xFF, FLASH_PAGE_SIZE);
+        if (c->address == (uintptr_t)eepromData) {
+            configPageErases++;
+        }
+    }
+    uint8_t *word = (uint8_t *)c->address;
+    for (int i = 0; i < CONFIG_STREAMER_BUFFER_SIZE; i++) {
+        if (word[i] != 0xFF) {
+            flashWriteErrors++;
+            return -2;
+        }
+        word[i] = c->buffer.b[i];
+    }
+    c->address += CONFIG_STREAMER_BUFFER_SIZE;
+    return 0;
+}
+
+int config_streamer_write(config_streamer_t *c, const uint8_t *p, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        c->buffer.b[c->at++] = p[i];
+        if (c->at == sizeof(c->buffer)) {
+            c->err = writeFlashWord(c);
+            c->at = 0;
+        }
+    }
+    return c->err;
+}
+
+int config_streamer_status(config_streamer_t *c)
+{
+    return c->err;
+}
+
+int config_streamer_flush(config_streamer_t *c)
+{
+    if (c->at != 0) {
+        memset(c->buffer.b + c->at, 0, sizeof(c->buffer) - c->at);
+        c->err = writeFlashWord(c);
+        c->at = 0;
+    }
+    return c->err;
+}
+
+int config_streamer_finish(config_streamer_t *c)
+{
+    c->unlocked = false;
+    return c->err;
+}
+
+/*
+ * Helpers
+ */
+
+static uint16_t alignToWrite(uint16_t offset)
+{
+    return (offset + CONFIG_STREAMER_BUFFER_SIZE - 1) / CONFIG_STREAMER_BUFFER_SIZE * CONFIG_STREAMER_BUFFER_SIZE;
+}
+
+// where the update after a config of the given size starts, past the padding written at a page boundary
+static uint16_t nextUpdate(uint16_t configSize)
+{
+    const uint16_t offset = alignToWrite(configSize);
+    return offset % FLASH_PAGE_SIZE == 0 ? offset + CONFIG_STREAMER_BUFFER_SIZE : offset;
+}
+
+static void setTestConfigA(uint8_t seed)
+{
+    for (unsigned i = 0; i < sizeof(testConfigA_t); i++) {
+        testConfigAMutable()->value[i] = seed + i;
+    }
+}
+
+static void setTestConfigB(uint8_t seed)
+{
+    for (unsigned i = 0; i < sizeof(testConfigB_t); i++) {
+        testConfigBMutable()->value[i] = seed ^ i;
+    }
+}
+
+static void setTestConfigC(uint8_t seed)
+{
+    for (unsigned i = 0; i < sizeof(testConfigC_t); i++) {
+        testConfigCMutable()->value[i] = seed * i;
+    }
+}
+
+// recalculates the CRC of the update at offset after it was changed
+static void sealUpdate(uint16_t offset)
+{
+    const uint8_t *p = &eepromData[offset + UPDATE_HEADER_SIZE];
+    while (p[0] | p[1]) {
+        p += p[0] | (p[1] << 8);
+    }
+    p += CONFIG_TAIL_SIZE - sizeof(uint16_t);
+
+    const uint16_t crc = crc16_ccitt_update(0xFFFF, &eepromData[offset], p - &eepromData[offset]);
+    // stored inverted and big endian, as writeEEPROMFooter()
+    eepromData[p - eepromData] = ~(crc >> 8);
+    eepromData[p - eepromData + 1] = ~crc;
+}
+
+// loads the stored config over scrambled PGs and checks every PG holds the expected values
+static void expectStoredConfig(uint8_t seedA, uint8_t seedB, uint8_t seedC)
+{
+    memset(testConfigAMutable(), 0x55, sizeof(testConfigA_t));
+    memset(testConfigBMutable(), 0x55, sizeof(testConfigB_t));
+    memset(testConfigCMutable(), 0x55, sizeof(testConfigC_t));
+
+    EXPECT_TRUE(isEEPROMVersionValid());
+    EXPECT_TRUE(isEEPROMStructureValid());
+    EXPECT_TRUE(loadEEPROM());
+
+    testConfigA_t expectedA;
+    testConfigB_t expectedB;
+    testConfigC_t expectedC;
+    for (unsigned i = 0; i < sizeof(expectedA); i++) {
+        expectedA.value[i] = seedA + i;
+    }
+    for (unsigned i = 0; i < sizeof(expectedB); i++) {
+        expectedB.value[i] = seedB ^ i;
+    }
+    for (unsigned i = 0; i < sizeof(expectedC); i++) {
+        expectedC.value[i] = seedC * i;
+    }
+    EXPECT_EQ(0, memcmp(&expectedA, testConfigA(), sizeof(expectedA))) << "seed " << (int)seedA;
+    EXPECT_EQ(0, memcmp(&expectedB, testConfigB(), sizeof(expectedB))) << "seed " << (int)seedB;
+    EXPECT_EQ(0, memcmp(&expectedC, testConfigC(), sizeof(expectedC))) << "seed " << (int)seedC;
+}
+
+// writes the initial config in full on erased flash
+static void writeInitialConfig(void)
+{
+    eraseFlash();
+    configPageErases = 0;
+    flashWriteErrors = 0;
+    failureModes = 0;
+
+    setTestConfigA(1);
+    setTestConfigB(2);
+    setTestConfigC(3);
+    writeConfigToEEPROM();
+    EXPECT_EQ((int)CONFIG_FULL_SIZE, getEEPROMConfigSize());
+    expectStoredConfig(1, 2, 3);
+}
+
+/*
+ * Tests
+ */
+
+TEST(ConfigEepromTest, TestAppendChangedPG)
+{
+    writeInitialConfig();
+    uint8_t fullConfig[CONFIG_FULL_SIZE];
+    memcpy(fullConfig, eepromData, sizeof(fullConfig));
+    const int erases = configPageErases;
+
+    // only the changed PG is appended after the full config, without erasing the flash
+    setTestConfigA(10);
+    writeConfigToEEPROM();
+    EXPECT_EQ(erases, configPageErases);
+    EXPECT_EQ(0, memcmp(fullConfig, eepromData, sizeof(fullConfig)));
+    const uint16_t update = alignToWrite(CONFIG_FULL_SIZE);
+    EXPECT_EQ(0xC5, eepromData[update]);
+    EXPECT_EQ(1, eepromData[update + 1]);
+    EXPECT_EQ(update + UPDATE_HEADER_SIZE + RECORD_HEADER_SIZE + sizeof(testConfigA_t) + CONFIG_TAIL_SIZE, getEEPROMConfigSize());
+
+    // the newest copy of the PG is loaded
+    expectStoredConfig(10, 2, 3);
+
+    // nothing is written when nothing changed
+    const uint16_t configSize = getEEPROMConfigSize();
+    writeConfigToEEPROM();
+    EXPECT_EQ(configSize, getEEPROMConfigSize());
+    expectStoredConfig(10, 2, 3);
+
+    EXPECT_EQ(0, flashWriteErrors);
+    EXPECT_EQ(0, failureModes);
+}
+
+TEST(ConfigEepromTest, TestAppendSequence)
+{
+    writeInitialConfig();
+    const int erases = configPageErases;
+
+    // each update starts at the next write after the previous one, with the next sequence number
+    const struct {
+        uint8_t seedA, seedB, seedC;
+    } saves[] = {
+        { 11, 2, 3 },
+        { 11, 22, 3 },
+        { 12, 22, 3 },
+        { 13, 23, 33 },
+        { 14, 23, 33 },
+    };
+    uint16_t updates[ARRAYLEN(saves)];
+    uint16_t update = alignToWrite(CONFIG_FULL_SIZE);
+    for (unsigned i = 0; i < ARRAYLEN(saves); i++) {
+        updates[i] = update;
+        setTestConfigA(saves[i].seedA);
+        setTestConfigB(saves[i].seedB);
+        setTestConfigC(saves[i].seedC);
+        writeConfigToEEPROM();
+
+        EXPECT_EQ(0xC5, eepromData[update]) << "update " << i;
+        EXPECT_EQ(i + 1, eepromData[update + 1]) << "update " << i;
+        update = nextUpdate(getEEPROMConfigSize());
+
+        // later updates of a PG replace the earlier ones
+        expectStoredConfig(saves[i].seedA, saves[i].seedB, saves[i].seedC);
+    }
+    EXPECT_EQ(erases, configPageErases);
+
+    // an update out of sequence ends the config even with a valid CRC, the updates before it are used
+    eepromData[updates[3] + 1] = 5;
+    sealUpdate(updates[3]);
+    expectStoredConfig(12, 22, 3);
+
+    EXPECT_EQ(0, flashWriteErrors);
+    EXPECT_EQ(0, failureModes);
+}
+
+TEST(ConfigEepromTest, TestCompactionWhenFull)
+{
+    writeInitialConfig();
+    int erases = configPageErases;
+
+    // the updates fill the flash until the config has to be written in full again
+    bool compacted = false;
+    int appends = 0;
+    for (int seed = 100; seed < 200 && !compacted; seed++) {
+        const uint16_t configSize = getEEPROMConfigSize();
+        setTestConfigA(seed);
+        writeConfigToEEPROM();
+        expectStoredConfig(seed, 2, 3);
+
+        if (getEEPROMConfigSize() > configSize) {
+            // appended without erasing
+            EXPECT_EQ(erases, configPageErases);
+            appends++;
+        } else {
+            // written in full, holding only the latest copy of each PG
+            EXPECT_EQ((int)CONFIG_FULL_SIZE, getEEPROMConfigSize());
+            EXPECT_LT(erases, configPageErases);
+            // only once the update and the erased word after it no longer fit
+            EXPECT_LT(EEPROM_SIZE, nextUpdate(configSize) + UPDATE_HEADER_SIZE + RECORD_HEADER_SIZE + sizeof(testConfigA_t) + CONFIG_TAIL_SIZE + CONFIG_STREAMER_BUFFER_SIZE);
+            compacted = true;
+        }
+    }
+    EXPECT_TRUE(compacted);
+    EXPECT_LT(10, appends);
+
+    // and updates are appended to the compacted config again
+    erases = configPageErases;
+    setTestConfigC(44);
+    writeConfigToEEPROM();
+    EXPECT_EQ(erases, configPageErases);
+    EXPECT_EQ(0xC5, eepromData[alignToWrite(CONFIG_FULL_SIZE)]);
+    EXPECT_EQ(1, eepromData[alignToWrite(CONFIG_FULL_SIZE) + 1]);
+    EXPECT_EQ(0xFF, eepromData[EEPROM_SIZE - 1]);
+
+    EXPECT_EQ(0, flashWriteErrors);
+    EXPECT_EQ(0, failureModes);
+}
+
+TEST(ConfigEepromTest, TestBadLastUpdateIgnored)
+{
+    writeInitialConfig();
+    setTestConfigA(20);
+    writeConfigToEEPROM();
+    const uint16_t update = alignToWrite(getEEPROMConfigSize());
+    setTestConfigB(30);
+    writeConfigToEEPROM();
+    const uint16_t updateEnd = getEEPROMConfigSize();
+    expectStoredConfig(20, 30, 3);
+
+    uint8_t saved[EEPROM_SIZE];
+    memcpy(saved, eepromData, sizeof(saved));
+
+    // power lost while the last update was written, the rest of it reads as erased
+    memset(&eepromData[update + (updateEnd - update) / 2], 0xFF, updateEnd - update - (updateEnd - update) / 2);
+    expectStoredConfig(20, 2, 3);
+    EXPECT_EQ(update, alignToWrite(getEEPROMConfigSize()));
+
+    // a bad CRC, a bit changed in the record
+    memcpy(eepromData, saved, sizeof(saved));
+    eepromData[update + UPDATE_HEADER_SIZE + RECORD_HEADER_SIZE + 10] ^= 0x04;
+    expectStoredConfig(20, 2, 3);
+
+    // the next save can't append over the bad update, so the config is written in full
+    const int erases = configPageErases;
+    setTestConfigC(40);
+    writeConfigToEEPROM();
+    EXPECT_LT(erases, configPageErases);
+    EXPECT_EQ((int)CONFIG_FULL_SIZE, getEEPROMConfigSize());
+    expectStoredConfig(20, 2, 40);
+
+    EXPECT_EQ(0, flashWriteErrors);
+    EXPECT_EQ(0, failureModes);
+}
+
+// STUBS
+
+extern "C" {
+    void failureMode(failureMode_e)
+    {
+        failureModes++;
+    }
+}
@@ -0,0 +1,274 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/display.h"
+    #include "io/displayport_msp.h"
+    #include "msp/msp_protocol.h"
+    #include "msp/msp_serial.h"
+    #include "pg/displayport_profiles.h"
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define MSP_V1_FRAME_OVERHEAD 6
+
+// emulated display device, applies the MSP_DISPLAYPORT commands it is sent
+static uint8_t deviceChars[DISPLAYPORT_MSP_ROWS][DISPLAYPORT_MSP_COLS];
+static uint8_t deviceAttrs[DISPLAYPORT_MSP_ROWS][DISPLAYPORT_MSP_COLS];
+static int deviceFrames;
+static int deviceBytes;
+static int deviceDraws;
+static int deviceFramesUntilFull;
+
+static void deviceReset(void)
+{
+    memset(deviceChars, ' ', sizeof(deviceChars));
+    memset(deviceAttrs, 0, sizeof(deviceAttrs));
+    deviceFrames = 0;
+    deviceBytes = 0;
+    deviceDraws = 0;
+    deviceFramesUntilFull = -1;
+}
+
+static void deviceWrite(uint8_t row, uint8_t col, uint8_t attr, const uint8_t *chars, int len)
+{
+    EXPECT_LT(row, DISPLAYPORT_MSP_ROWS);
+    EXPECT_LE(col + len, DISPLAYPORT_MSP_COLS);
+    memcpy(&deviceChars[row][col], chars, len);
+    memset(&deviceAttrs[row][col], attr, len);
+}
+
+static void resetDisplayPort(displayPort_t *displayPort, bool spans)
+{
+    displayPortProfile_t *profile = displayPortProfileMspMutable();
+    for (int ii = 0; ii < 4; ii++) {
+        profile->attrValues[ii] = ii;
+    }
+    profile->useSpanUpdates = spans;
+    deviceReset();
+    displayResync(displayPort);
+    deviceReset();
+}
+
+static void expectDeviceShows(int row, int col, const char *text, uint8_t attr)
+{
+    EXPECT_EQ(0, memcmp(&deviceChars[row][col], text, strlen(text)));
+    for (unsigned ii = 0; ii < strlen(text); ii++) {
+        EXPECT_EQ(attr, deviceAttrs[row][col + ii]);
+    }
+}
+
+TEST(DisplayPortMspTest, TestUnchangedCellsNotResent)
+{
+    displayPort_t *displayPort = displayPortMspInit();
+    resetDisplayPort(displayPort, false);
+
+    displayWrite(displayPort, 2, 3, DISPLAYPORT_ATTR_NONE, "HELLO");
+    displayWrite(displayPort, 20, 3, DISPLAYPORT_ATTR_WARNING, "WARN");
+    displayDrawScreen(displayPort);
+
+    expectDeviceShows(3, 2, "HELLO", 0);
+    expectDeviceShows(3, 20, "WARN", 2);
+    EXPECT_EQ(1, deviceDraws);
+
+    // the same content again only sends the row being periodically refreshed
+    for (int ii = 0; ii < DISPLAYPORT_MSP_ROWS; ii++) {
+        displayClearScreen(displayPort);
+        displayWrite(displayPort, 2, 3, DISPLAYPORT_ATTR_NONE, "HELLO");
+        displayWrite(displayPort, 20, 3, DISPLAYPORT_ATTR_WARNING, "WARN");
+        deviceBytes = 0;
+        displayDrawScreen(displayPort);
+        // at most three spans, one per attribute change, plus the draw
+        EXPECT_GE(3 * (4 + 1 + MSP_V1_FRAME_OVERHEAD) + DISPLAYPORT_MSP_COLS + 1 + MSP_V1_FRAME_OVERHEAD, deviceBytes);
+        EXPECT_TRUE(displayIsSynced(displayPort));
+    }
+
+    // a single changed character is sent by itself
+    displayWrite(displayPort, 3, 3, DISPLAYPORT_ATTR_NONE, "A");
+    deviceFrames = 0;
+    displayDrawScreen(displayPort);
+    expectDeviceShows(3, 2, "HALLO", 0);
+    EXPECT_GE(4, deviceFrames);
+}
+
+TEST(DisplayPortMspTest, TestClearedCellsBlanked)
+{
+    displayPort_t *displayPort = displayPortMspInit();
+    resetDisplayPort(displayPort, true);
+
+    displayWrite(displayPort, 0, 0, DISPLAYPORT_ATTR_NONE, "ABCDEFGH");
+    displayDrawScreen(displayPort);
+    expectDeviceShows(0, 0, "ABCDEFGH", 0);
+
+    displayClearScreen(displayPort);
+    displayWrite(displayPort, 2, 0, DISPLAYPORT_ATTR_NONE, "CD");
+    displayDrawScreen(displayPort);
+    expectDeviceShows(0, 0, "  CD    ", 0);
+}
+
+TEST(DisplayPortMspTest, TestPackedSpansMatchScreen)
+{
+    displayPort_t *displayPort = displayPortMspInit();
+    resetDisplayPort(displayPort, true);
+
+    // a full screen of text with mixed attributes
+    char line[DISPLAYPORT_MSP_COLS + 1];
+    for (int row = 0; row < displayPort->rows; row++) {
+        for (int col = 0; col < displayPort->cols; col++) {
+            line[col] = 'A' + (row + col) % 26;
+        }
+        line[displayPort->cols] = 0;
+        displayWrite(displayPort, 0, row, DISPLAYPORT_ATTR_NONE, line);
+        displayWrite(displayPort, row, row, DISPLAYPORT_ATTR_CRITICAL | DISPLAYPORT_ATTR_BLINK, "!");
+    }
+    displayDrawScreen(displayPort);
+
+    for (int row = 0; row < displayPort->rows; row++) {
+        for (int col = 0; col < displayPort->cols; col++) {
+            if (col == row) {
+                EXPECT_EQ('!', deviceChars[row][col]);
+                EXPECT_EQ(3 | DISPLAYPORT_MSP_ATTR_BLINK, deviceAttrs[row][col]);
+            } else {
+                EXPECT_EQ('A' + (row + col) % 26, deviceChars[row][col]);
+                EXPECT_EQ(0, deviceAttrs[row][col]);
+            }
+        }
+    }
+
+    // many spans share a frame, far fewer than one frame per span
+    EXPECT_GT(8, deviceFrames);
+    EXPECT_TRUE(displayIsSynced(displayPort));
+}
+
+TEST(DisplayPortMspTest, TestDroppedFramesResentLater)
+{
+    displayPort_t *displayPort = displayPortMspInit();
+    resetDisplayPort(displayPort, false);
+
+    displayWrite(displayPort, 0, 1, DISPLAYPORT_ATTR_NONE, "FIRST");
+    displayWrite(displayPort, 0, 5, DISPLAYPORT_ATTR_NONE, "SECOND");
+    displayWrite(displayPort, 0, 9, DISPLAYPORT_ATTR_NONE, "THIRD");
+
+    // the TX buffer fills after the first frame
+    deviceFramesUntilFull = 1;
+    displayDrawScreen(displayPort);
+    expectDeviceShows(1, 0, "FIRST", 0);
+    expectDeviceShows(5, 0, "      ", 0);
+    EXPECT_FALSE(displayIsSynced(displayPort));
+
+    deviceFramesUntilFull = -1;
+    displayDrawScreen(displayPort);
+    expectDeviceShows(5, 0, "SECOND", 0);
+    expectDeviceShows(9, 0, "THIRD", 0);
+    EXPECT_TRUE(displayIsSynced(displayPort));
+}
+
+TEST(DisplayPortMspTest, TestBackgroundLayerComposited)
+{
+    displayPort_t *displayPort = displayPortMspInit();
+    resetDisplayPort(displayPort, true);
+
+    EXPECT_TRUE(displayLayerSupported(displayPort, DISPLAYPORT_LAYER_BACKGROUND));
+
+    // static artwork is drawn once into the background layer
+    displayLayerSelect(displayPort, DISPLAYPORT_LAYER_BACKGROUND);
+    displayClearScreen(displayPort);
+    displayWrite(displayPort, 4, 6, DISPLAYPORT_ATTR_NONE, "CRAFT");
+    displayWriteChar(displayPort, 14, 6, DISPLAYPORT_ATTR_NONE, '+');
+    displayLayerSelect(displayPort, DISPLAYPORT_LAYER_FOREGROUND);
+
+    displayDrawScreen(displayPort);
+    expectDeviceShows(6, 4, "          ", 0);
+
+    for (int frame = 0; frame < 3; frame++) {
+        const char value[2] = { (char)('0' + frame), 0 };
+
+        displayLayerCopy(displayPort, DISPLAYPORT_LAYER_FOREGROUND, DISPLAYPORT_LAYER_BACKGROUND);
+        displayWrite(displayPort, 10, 6, DISPLAYPORT_ATTR_NONE, value);
+        deviceBytes = 0;
+        displayDrawScreen(displayPort);
+
+        expectDeviceShows(6, 4, "CRAFT", 0);
+        expectDeviceShows(6, 10, value, 0);
+        expectDeviceShows(6, 14, "+", 0);
+        if (frame) {
+            // the background isn't sent again, only the changed value and the row being refreshed
+            EXPECT_GT(2 * DISPLAYPORT_MSP_COLS, deviceBytes);
+        }
+    }
+}
+
+// STUBS
+
+extern "C" {
+    PG_REGISTER(displayPortProfile_t, displayPortProfileMsp, PG_DISPLAY_PORT_MSP_CONFIG, 1);
+
+    uint8_t cliMode = 0;
+
+    int mspSerialPush(serialPortIdentifier_e, uint8_t cmd, uint8_t *data, int datalen, mspDirection_e)
+    {
+        EXPECT_EQ(MSP_DISPLAYPORT, cmd);
+        EXPECT_GE(DISPLAYPORT_MSP_MAX_SPANS_LENGTH, datalen);
+
+        if (deviceFramesUntilFull == 0) {
+            return 0;
+        }
+        if (deviceFramesUntilFull > 0) {
+            deviceFramesUntilFull--;
+        }
+
+        switch (data[0]) {
+        case MSP_DP_CLEAR_SCREEN:
+            memset(deviceChars, ' ', sizeof(deviceChars));
+            memset(deviceAttrs, 0, sizeof(deviceAttrs));
+            break;
+        case MSP_DP_WRITE_STRING:
+            deviceWrite(data[1], data[2], data[3], &data[4], datalen - 4);
+            break;
+        case MSP_DP_DRAW_SCREEN:
+            deviceDraws++;
+            break;
+        case MSP_DP_WRITE_SPANS:
+            for (int pos = 1; pos < datalen; pos += 4 + data[pos + 3]) {
+                EXPECT_GE(datalen, pos + 4 + data[pos + 3]);
+                deviceWrite(data[pos], data[pos + 1], data[pos + 2], &data[pos + 4], data[pos + 3]);
+            }
+            break;
+        default:
+            break;
+        }
+
+        deviceFrames++;
+        deviceBytes += datalen + MSP_V1_FRAME_OVERHEAD;
+        return datalen + MSP_V1_FRAME_OVERHEAD;
+    }
+
+    uint32_t mspSerialTxBytesFree(void)
+    {
+        return UINT32_MAX;
+    }
+}
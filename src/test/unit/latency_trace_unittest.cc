@@ -0,0 +1,150 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "fc/latency_trace.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static timeUs_t currentTimeUs;
+
+// traces a frame arriving at frameTimeUs, with each stage taking stageUs
+static void traceFrame(timeUs_t frameTimeUs, timeUs_t stageUs)
+{
+    latencyTraceFrame(frameTimeUs);
+    currentTimeUs = frameTimeUs;
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+        currentTimeUs += stageUs;
+        LATENCY_TRACE_STAGE((latencyStage_e)stage);
+    }
+}
+
+TEST(LatencyTraceUnittest, TestStagesInOrder)
+{
+    latencyTraceReset();
+
+    latencyTraceFrame(1000);
+
+    // stages are only recorded in order, after the frame arrived
+    currentTimeUs = 1100;
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_PID);
+    EXPECT_EQ(LATENCY_STAGE_RX, latencyTraceNextStage);
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_RX);
+    EXPECT_EQ(LATENCY_STAGE_RC_COMMAND, latencyTraceNextStage);
+    currentTimeUs = 1200;
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_RC_COMMAND);
+    currentTimeUs = 1500;
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_RC_SMOOTHING);
+    currentTimeUs = 1600;
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_PID);
+    currentTimeUs = 1700;
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_MIXER);
+
+    // not complete until the motors are written
+    latencyTraceStats_t stats;
+    latencyTraceGetStats(&stats);
+    EXPECT_EQ(0, stats.sampleCount);
+    EXPECT_EQ(0, latencyTraceLastUs(LATENCY_STAGE_MOTOR));
+
+    currentTimeUs = 1750;
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_MOTOR);
+    EXPECT_EQ(LATENCY_STAGE_COUNT, latencyTraceNextStage);
+    EXPECT_EQ(200, latencyTraceLastUs(LATENCY_STAGE_RC_COMMAND));
+    EXPECT_EQ(750, latencyTraceLastUs(LATENCY_STAGE_MOTOR));
+
+    // later PID loops are not part of the trace
+    currentTimeUs = 1875;
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_MOTOR);
+    EXPECT_EQ(750, latencyTraceLastUs(LATENCY_STAGE_MOTOR));
+
+    latencyTraceGetStats(&stats);
+    EXPECT_EQ(1, stats.sampleCount);
+    EXPECT_EQ(750, stats.minUs);
+    EXPECT_EQ(750, stats.avgUs);
+    EXPECT_EQ(750, stats.p99Us);
+    EXPECT_EQ(750, stats.maxUs);
+    EXPECT_EQ(100, stats.stageAvgUs[LATENCY_STAGE_RX]);
+    EXPECT_EQ(500, stats.stageAvgUs[LATENCY_STAGE_RC_SMOOTHING]);
+}
+
+TEST(LatencyTraceUnittest, TestNewFrameRestartsTrace)
+{
+    latencyTraceReset();
+
+    latencyTraceFrame(1000);
+    currentTimeUs = 1100;
+    LATENCY_TRACE_STAGE(LATENCY_STAGE_RX);
+
+    // the next frame arrives before the first reached the motors
+    traceFrame(5000, 10);
+
+    latencyTraceStats_t stats;
+    latencyTraceGetStats(&stats);
+    EXPECT_EQ(1, stats.sampleCount);
+    EXPECT_EQ(60, stats.maxUs);
+}
+
+TEST(LatencyTraceUnittest, TestStatistics)
+{
+    latencyTraceReset();
+
+    // 99 fast frames and one slow one, the p99 is still a fast one
+    for (int i = 0; i < 99; i++) {
+        traceFrame(10000 * (i + 1), 100 + i);
+    }
+    traceFrame(2000000, 1000);
+
+    latencyTraceStats_t stats;
+    latencyTraceGetStats(&stats);
+    EXPECT_EQ(100, stats.sampleCount);
+    EXPECT_EQ(600, stats.minUs);
+    EXPECT_EQ(6 * 198, stats.p99Us);
+    EXPECT_EQ(6000, stats.maxUs);
+    EXPECT_EQ((6 * (99 * 100 + 99 * 98 / 2) + 6000) / 100, stats.avgUs);
+    EXPECT_EQ(stats.avgUs, stats.stageAvgUs[LATENCY_STAGE_MOTOR]);
+    const uint16_t motorStageAvgUs = stats.stageAvgUs[LATENCY_STAGE_MOTOR];
+
+    // the window only keeps the latest frames
+    for (int i = 0; i < LATENCY_TRACE_WINDOW; i++) {
+        traceFrame(3000000 + 10000 * i, 50);
+    }
+    latencyTraceGetStats(&stats);
+    EXPECT_EQ(LATENCY_TRACE_WINDOW, stats.sampleCount);
+    EXPECT_EQ(300, stats.minUs);
+    EXPECT_EQ(300, stats.p99Us);
+    EXPECT_EQ(300, stats.maxUs);
+    // the stage averages follow the recent frames
+    EXPECT_LE(300, stats.stageAvgUs[LATENCY_STAGE_MOTOR]);
+    EXPECT_GT(motorStageAvgUs / 2, stats.stageAvgUs[LATENCY_STAGE_MOTOR]);
+
+    latencyTraceReset();
+    latencyTraceGetStats(&stats);
+    EXPECT_EQ(0, stats.sampleCount);
+}
+
+// STUBS
+
+extern "C" {
+timeUs_t micros(void) { return currentTimeUs; }
+}
@@ -64,6 +64,7 @@ extern "C" {
     extern uint8_t ledGridRows;
 
     extern ledCounts_t ledCounts;
+    extern ledStripPlan_t ledStripPlan;
 
     void reevaluateLedConfig();
 
@@ -189,6 +190,24 @@ TEST(LedStripTest, parseLedStripConfig)
     EXPECT_EQ(7, lowestXValueForEast);
     EXPECT_EQ(5, highestYValueForNorth);
     EXPECT_EQ(6, lowestYValueForSouth);
+
+    // then
+    EXPECT_EQ(0x3C000000, ledStripPlan.functionLeds[LED_FUNCTION_THRUST_RING]);
+    EXPECT_EQ(0x00003000, ledStripPlan.functionLeds[LED_FUNCTION_COLOR]);
+    EXPECT_EQ(0x0000000C | 0x00000180 | 0x00060000 | 0x00C00000, ledStripPlan.functionLeds[LED_FUNCTION_ARM_STATE]);
+    EXPECT_EQ(0x00000003 | 0x00007800 | 0x03000000, ledStripPlan.overlayLeds[LED_OVERLAY_WARNING]);
+    EXPECT_EQ(ledStripPlan.functionLeds[LED_FUNCTION_ARM_STATE], ledStripPlan.overlayLeds[LED_OVERLAY_INDICATOR]);
+    EXPECT_EQ(0, ledStripPlan.overlayLeds[LED_OVERLAY_BLINK]);
+
+    // and
+    EXPECT_EQ(15, ledStripPlan.leds[27].color);
+    EXPECT_EQ(LED_NO_DIRECTION, ledStripPlan.leds[27].modeColorDirection);
+    EXPECT_EQ(LED_DIRECTION_EAST, ledStripPlan.leds[3].modeColorDirection);
+
+    // and - 11,11 is south east, 12,2 north east, 0,3 north west
+    EXPECT_EQ(0x6, ledStripPlan.leds[2].quadrant);
+    EXPECT_EQ(0x5, ledStripPlan.leds[8].quadrant);
+    EXPECT_EQ(0x9, ledStripPlan.leds[18].quadrant);
 }
 
 TEST(LedStripTest, smallestGridWithCenter)
@@ -0,0 +1,224 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "common/lz.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define OUTBUF_LEN 1024
+static uint8_t outBuf[OUTBUF_LEN];
+static uint8_t decodeBuf[OUTBUF_LEN];
+
+static int lzReadExtraLength(const uint8_t **in, const uint8_t *end)
+{
+    int length = 0;
+    uint8_t value;
+    do {
+        if (*in >= end) {
+            return -1;
+        }
+        value = *(*in)++;
+        length += value;
+    } while (value == 255);
+    return length;
+}
+
+/*
+ * Reference decoder, as used by the configurator.
+ */
+static int lzDecodeBuf(uint8_t *out, int outBufLen, const uint8_t *in, int inLen)
+{
+    const uint8_t *end = in + inLen;
+    int outCount = 0;
+
+    while (in < end) {
+        const uint8_t token = *in++;
+
+        int literalCount = token >> 4;
+        if (literalCount == 15) {
+            const int extra = lzReadExtraLength(&in, end);
+            if (extra < 0) {
+                return -1;
+            }
+            literalCount += extra;
+        }
+        if (in + literalCount > end || outCount + literalCount > outBufLen) {
+            return -1;
+        }
+        memcpy(out + outCount, in, literalCount);
+        in += literalCount;
+        outCount += literalCount;
+
+        int matchCode = token & 0x0F;
+        if (matchCode == 0) {
+            continue;
+        }
+        if (in >= end) {
+            return -1;
+        }
+        const int offset = *in++;
+        if (matchCode == 15) {
+            const int extra = lzReadExtraLength(&in, end);
+            if (extra < 0) {
+                return -1;
+            }
+            matchCode += extra;
+        }
+        const int matchLength = matchCode - 1 + LZ_MIN_MATCH;
+        if (offset == 0 || offset > outCount || outCount + matchLength > outBufLen) {
+            return -1;
+        }
+        // byte by byte, the match may overlap the bytes being written
+        for (int ii = 0; ii < matchLength; ++ii) {
+            out[outCount] = out[outCount - offset];
+            ++outCount;
+        }
+    }
+    return outCount;
+}
+
+static int encodeBlocks(lzState_t *state, const uint8_t *inBuf, int inLen, int blockSize)
+{
+    for (int pos = 0; pos < inLen; pos += blockSize) {
+        const int len = (inLen - pos < blockSize) ? inLen - pos : blockSize;
+        const int status = lzEncodeBufStreaming(state, inBuf + pos, len);
+        if (status != 0) {
+            return status;
+        }
+    }
+    return 0;
+}
+
+TEST(LzUnittest, TestLzEncodeLiterals)
+{
+    const uint8_t inBuf[] = {0, 1, 2, 3, 4, 5, 6, 7};
+    lzState_t state = {
+        .bytesWritten = 0,
+        .outByte = outBuf,
+        .outBufLen = OUTBUF_LEN,
+    };
+    EXPECT_EQ(0, lzEncodeBufStreaming(&state, inBuf, sizeof(inBuf)));
+
+    // one literal only sequence
+    EXPECT_EQ(1 + (int)sizeof(inBuf), state.bytesWritten);
+    EXPECT_EQ(0x80, outBuf[0]);
+    EXPECT_EQ(0, memcmp(outBuf + 1, inBuf, sizeof(inBuf)));
+}
+
+TEST(LzUnittest, TestLzEncodeMatch)
+{
+    const uint8_t inBuf[] = {1, 2, 3, 4, 1, 2, 3, 4, 1, 2, 3, 4, 9};
+    lzState_t state = {
+        .bytesWritten = 0,
+        .outByte = outBuf,
+        .outBufLen = OUTBUF_LEN,
+    };
+    EXPECT_EQ(0, lzEncodeBufStreaming(&state, inBuf, sizeof(inBuf)));
+
+    // 4 literals with an overlapping 8 byte match at offset 4, then a trailing literal
+    EXPECT_EQ(8, state.bytesWritten);
+    EXPECT_EQ(0x45, outBuf[0]);
+    EXPECT_EQ(0, memcmp(outBuf + 1, inBuf, 4));
+    EXPECT_EQ(4, outBuf[5]);
+    EXPECT_EQ(0x10, outBuf[6]);
+    EXPECT_EQ(9, outBuf[7]);
+
+    EXPECT_EQ((int)sizeof(inBuf), lzDecodeBuf(decodeBuf, OUTBUF_LEN, outBuf, state.bytesWritten));
+    EXPECT_EQ(0, memcmp(decodeBuf, inBuf, sizeof(inBuf)));
+}
+
+TEST(LzUnittest, TestLzEncodeLongRuns)
+{
+    // long runs need extended literal and match lengths
+    uint8_t inBuf[LZ_MAX_BLOCK_SIZE];
+    for (int ii = 0; ii < 40; ++ii) {
+        inBuf[ii] = ii * 7;
+    }
+    memset(inBuf + 40, 0xFF, sizeof(inBuf) - 40);
+
+    lzState_t state = {
+        .bytesWritten = 0,
+        .outByte = outBuf,
+        .outBufLen = OUTBUF_LEN,
+    };
+    EXPECT_EQ(0, lzEncodeBufStreaming(&state, inBuf, sizeof(inBuf)));
+    EXPECT_GT(60, state.bytesWritten);
+
+    EXPECT_EQ((int)sizeof(inBuf), lzDecodeBuf(decodeBuf, OUTBUF_LEN, outBuf, state.bytesWritten));
+    EXPECT_EQ(0, memcmp(decodeBuf, inBuf, sizeof(inBuf)));
+}
+
+TEST(LzUnittest, TestLzEncodeStreaming)
+{
+    // repetitive frames, similar to blackbox P-frames
+    uint8_t inBuf[600];
+    for (unsigned ii = 0; ii < sizeof(inBuf); ++ii) {
+        inBuf[ii] = (ii % 23 == 0) ? 'P' : (ii % 23) + ((ii / 230) & 1);
+    }
+
+    lzState_t state = {
+        .bytesWritten = 0,
+        .outByte = outBuf,
+        .outBufLen = OUTBUF_LEN,
+    };
+    EXPECT_EQ(0, encodeBlocks(&state, inBuf, sizeof(inBuf), 100));
+    EXPECT_GT((int)sizeof(inBuf) / 2, state.bytesWritten);
+    EXPECT_EQ(outBuf + state.bytesWritten, state.outByte);
+
+    EXPECT_EQ((int)sizeof(inBuf), lzDecodeBuf(decodeBuf, OUTBUF_LEN, outBuf, state.bytesWritten));
+    EXPECT_EQ(0, memcmp(decodeBuf, inBuf, sizeof(inBuf)));
+}
+
+TEST(LzUnittest, TestLzEncodeIncompressible)
+{
+    uint8_t inBuf[LZ_MAX_BLOCK_SIZE];
+    uint32_t seed = 12345;
+    for (unsigned ii = 0; ii < sizeof(inBuf); ++ii) {
+        seed = seed * 1103515245 + 12345;
+        inBuf[ii] = seed >> 16;
+    }
+
+    // a block with exactly the worst case space fits
+    lzState_t state = {
+        .bytesWritten = 0,
+        .outByte = outBuf,
+        .outBufLen = LZ_MAX_BLOCK_SIZE + LZ_BLOCK_OVERHEAD,
+    };
+    EXPECT_EQ(0, lzEncodeBufStreaming(&state, inBuf, sizeof(inBuf)));
+    EXPECT_GE(LZ_MAX_BLOCK_SIZE + LZ_BLOCK_OVERHEAD, state.bytesWritten);
+    EXPECT_EQ((int)sizeof(inBuf), lzDecodeBuf(decodeBuf, OUTBUF_LEN, outBuf, state.bytesWritten));
+    EXPECT_EQ(0, memcmp(decodeBuf, inBuf, sizeof(inBuf)));
+
+    // and is refused without touching the output when it may not
+    const uint16_t bytesWritten = state.bytesWritten;
+    EXPECT_EQ(-1, lzEncodeBufStreaming(&state, inBuf, 1));
+    EXPECT_EQ(bytesWritten, state.bytesWritten);
+
+    // blocks larger than the match window are refused
+    lzState_t state2 = {
+        .bytesWritten = 0,
+        .outByte = outBuf,
+        .outBufLen = OUTBUF_LEN,
+    };
+    EXPECT_EQ(-1, lzEncodeBufStreaming(&state2, inBuf, LZ_MAX_BLOCK_SIZE + 1));
+}
@@ -0,0 +1,360 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "drivers/bus_spi.h"
+    #include "drivers/exti.h"
+    #include "drivers/io.h"
+    #include "drivers/max7456.h"
+    #include "drivers/osd.h"
+
+    #include "pg/max7456.h"
+    #include "pg/vcd.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Simulated MAX7456, the display memory and the registers used to write it
+
+#define SIM_FIELD_US        20000   // PAL
+#define SIM_VBLANK_US       (25 * 64)
+#define SIM_VSYNC_PULSE_US  (3 * 64)
+#define SIM_FIELD_OFFSET_US 1234    // first field start, not aligned to anything in the driver
+
+#define REG_READ    0x80
+#define REG_VM0     0x00
+#define REG_DMM     0x04
+#define REG_DMAH    0x05
+#define REG_DMAL    0x06
+#define REG_DMDI    0x07
+#define REG_CMAL    0x0a
+#define REG_OSDM    0x0c
+#define REG_STAT    0xa0
+
+static struct {
+    uint8_t memory[VIDEO_BUFFER_CHARS_PAL];
+    uint16_t address;
+    bool autoIncrement;
+    uint8_t vm0;
+    int16_t pendingRegister;
+    bool vsyncOutput;           // the chip shows VSYNC in its status register
+    int memoryWrites;
+    int memoryWritesOutsideBlanking;
+} sim;
+
+static timeUs_t simTimeUs;
+static extiCallbackRec_t *vsyncCallback;
+
+static timeDelta_t simFieldPhaseUs(void)
+{
+    return (simTimeUs - SIM_FIELD_OFFSET_US) % SIM_FIELD_US;
+}
+
+static timeUs_t simFieldStartUs(void)
+{
+    return simTimeUs - simFieldPhaseUs();
+}
+
+static uint8_t simRegisterAccess(uint8_t reg, uint8_t data)
+{
+    switch (reg) {
+    case REG_OSDM | REG_READ:
+        return 0x1b;
+    case REG_VM0 | REG_READ:
+        return sim.vm0;
+    case REG_CMAL | REG_READ:
+        return 0;
+    case REG_STAT: {
+        const bool inVsync = sim.vsyncOutput && simFieldPhaseUs() < SIM_VSYNC_PULSE_US;
+        return 0x01 | (inVsync ? 0 : 0x10);
+    }
+    case REG_VM0:
+        sim.vm0 = (data & 0x02) ? 0 : data;
+        break;
+    case REG_DMM:
+        sim.autoIncrement = data & 0x01;
+        if (data & 0x04) {
+            memset(sim.memory, 0, sizeof(sim.memory));
+        }
+        break;
+    case REG_DMAH:
+        sim.address = (sim.address & 0xff) | ((data & 0x01) << 8);
+        break;
+    case REG_DMAL:
+        sim.address = (sim.address & 0x100) | data;
+        break;
+    case REG_DMDI:
+        if (sim.autoIncrement && data == 0xff) {
+            // END_STRING leaves auto-increment mode
+            sim.autoIncrement = false;
+            break;
+        }
+        if (sim.address < sizeof(sim.memory)) {
+            sim.memory[sim.address] = data;
+        }
+        sim.memoryWrites++;
+        if (simFieldPhaseUs() >= SIM_VBLANK_US) {
+            sim.memoryWritesOutsideBlanking++;
+        }
+        if (sim.autoIncrement) {
+            sim.address++;
+        }
+        break;
+    }
+    return 0;
+}
+
+static void simReset(bool vsyncOutput)
+{
+    memset(&sim, 0, sizeof(sim));
+    sim.pendingRegister = -1;
+    sim.vsyncOutput = vsyncOutput;
+    vsyncCallback = NULL;
+    simTimeUs = 10000000;
+}
+
+static void initDriver(bool useVsyncPin)
+{
+    max7456Config_t config;
+    memset(&config, 0, sizeof(config));
+    config.csTag = 1;
+    config.spiDevice = 1;
+    config.vsyncTag = useVsyncPin ? 2 : 0;
+
+    vcdProfile_t vcdProfile;
+    memset(&vcdProfile, 0, sizeof(vcdProfile));
+    vcdProfile.video_system = VIDEO_SYSTEM_PAL;
+
+    EXPECT_TRUE(max7456Init(&config, &vcdProfile, false));
+    // as the displayport does on init, this also sets the video mode
+    max7456RefreshAll();
+    EXPECT_EQ(VIDEO_LINES_PAL, max7456GetRowsCount());
+
+    // the initial full redraw is not paced
+    sim.memoryWrites = 0;
+    sim.memoryWritesOutsideBlanking = 0;
+}
+
+static void fillScreen(char c)
+{
+    char line[31];
+    memset(line, c, 30);
+    line[30] = 0;
+    for (int row = 0; row < VIDEO_LINES_PAL; row++) {
+        max7456Write(0, row, line);
+    }
+}
+
+static bool simShows(char c)
+{
+    for (unsigned i = 0; i < sizeof(sim.memory); i++) {
+        if (sim.memory[i] != c) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(Max7456Test, UnpacedUpdate)
+{
+    simReset(false);
+    initDriver(false);
+
+    EXPECT_EQ(MAX7456_VSYNC_ESTIMATED, max7456GetVsyncSource());
+    EXPECT_TRUE(simShows(' '));
+
+    // without a VSYNC pulse there is no field timing and changes are sent whenever drawn
+    timeUs_t windowStartUs;
+    max7456Write(3, 2, "HELLO");
+    max7456DrawScreen();
+    EXPECT_FALSE(max7456GetDrawWindow(simTimeUs, &windowStartUs));
+    EXPECT_EQ(0, memcmp(&sim.memory[2 * 30 + 3], "HELLO", 5));
+    EXPECT_TRUE(max7456BuffersSynced());
+
+    // a full screen takes several draws of a limited size
+    fillScreen('A');
+    int draws = 0;
+    while (!max7456BuffersSynced() && draws < 100) {
+        max7456DrawScreen();
+        draws++;
+    }
+    EXPECT_LT(1, draws);
+    EXPECT_TRUE(simShows('A'));
+}
+
+TEST(Max7456Test, EstimatedVsync)
+{
+    simReset(true);
+    initDriver(false);
+
+    timeUs_t windowStartUs;
+    EXPECT_FALSE(max7456GetDrawWindow(simTimeUs, &windowStartUs));
+
+    // the driver is called often, as when not paced, until it sees the VSYNC pulse
+    while (!max7456GetDrawWindow(simTimeUs, &windowStartUs)) {
+        simTimeUs += 100;
+        max7456DrawScreen();
+    }
+
+    // it then predicts the following fields, within the length of the VSYNC pulse
+    fillScreen('B');
+    for (int field = 0; field < 5; field++) {
+        EXPECT_TRUE(max7456GetDrawWindow(simTimeUs, &windowStartUs));
+        const timeUs_t expectedUs = simFieldStartUs() + (simFieldPhaseUs() >= SIM_VBLANK_US - SIM_VSYNC_PULSE_US ? SIM_FIELD_US : 0);
+        EXPECT_LE(expectedUs, windowStartUs);
+        EXPECT_GT(expectedUs + SIM_VSYNC_PULSE_US, windowStartUs);
+
+        simTimeUs = windowStartUs;
+        max7456DrawScreen();
+        simTimeUs += SIM_FIELD_US / 2;
+        max7456DrawScreen();
+    }
+
+    // and only writes the display memory during vertical blanking
+    for (int i = 0; i < 2000 && !max7456BuffersSynced(); i++) {
+        simTimeUs += 250;
+        max7456DrawScreen();
+    }
+    EXPECT_TRUE(max7456BuffersSynced());
+    EXPECT_TRUE(simShows('B'));
+    EXPECT_LT(0, sim.memoryWrites);
+    EXPECT_EQ(0, sim.memoryWritesOutsideBlanking);
+
+    // without VSYNC pulses it goes back to drawing unpaced
+    sim.vsyncOutput = false;
+    for (int field = 0; field < 5; field++) {
+        if (max7456GetDrawWindow(simTimeUs, &windowStartUs)) {
+            simTimeUs = windowStartUs;
+        }
+        max7456DrawScreen();
+        simTimeUs += SIM_FIELD_US / 2;
+    }
+    EXPECT_FALSE(max7456GetDrawWindow(simTimeUs, &windowStartUs));
+}
+
+TEST(Max7456Test, VsyncInterrupt)
+{
+    simReset(true);
+    initDriver(true);
+
+    EXPECT_EQ(MAX7456_VSYNC_EXTI, max7456GetVsyncSource());
+    ASSERT_NE((extiCallbackRec_t *)NULL, vsyncCallback);
+
+    timeUs_t windowStartUs;
+    EXPECT_FALSE(max7456GetDrawWindow(simTimeUs, &windowStartUs));
+
+    // field starts from the interrupt
+    simTimeUs = simFieldStartUs() + SIM_FIELD_US;
+    vsyncCallback->fn(vsyncCallback);
+    EXPECT_TRUE(max7456GetDrawWindow(simTimeUs + 100, &windowStartUs));
+    EXPECT_EQ(simTimeUs, windowStartUs);
+    EXPECT_TRUE(max7456GetDrawWindow(simTimeUs + SIM_VBLANK_US, &windowStartUs));
+    EXPECT_EQ(simTimeUs + SIM_FIELD_US, windowStartUs);
+
+    // nothing is sent outside the window
+    fillScreen('C');
+    simTimeUs += SIM_VBLANK_US;
+    max7456DrawScreen();
+    EXPECT_EQ(0, sim.memoryWrites);
+
+    // close to its end only what fits in the rest of the window
+    simTimeUs = simFieldStartUs() + SIM_FIELD_US;
+    vsyncCallback->fn(vsyncCallback);
+    simTimeUs += SIM_VBLANK_US - 100;
+    max7456DrawScreen();
+    EXPECT_LT(0, sim.memoryWrites);
+    EXPECT_GE(100 / 2, sim.memoryWrites);
+
+    // once per field at the start of the window, as the OSD task is scheduled
+    for (int field = 0; field < 10 && !max7456BuffersSynced(); field++) {
+        simTimeUs = simFieldStartUs() + SIM_FIELD_US;
+        vsyncCallback->fn(vsyncCallback);
+        max7456DrawScreen();
+    }
+    EXPECT_TRUE(max7456BuffersSynced());
+    EXPECT_TRUE(simShows('C'));
+    EXPECT_EQ(0, sim.memoryWritesOutsideBlanking);
+
+    // the timing is dropped when the interrupts stop
+    simTimeUs += 4 * SIM_FIELD_US;
+    EXPECT_FALSE(max7456GetDrawWindow(simTimeUs, &windowStartUs));
+}
+
+// STUBS
+
+extern "C" {
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint8_t debugMode;
+
+    uint32_t micros(void) { return simTimeUs; }
+    uint32_t microsISR(void) { return simTimeUs; }
+    uint32_t millis(void) { return simTimeUs / 1000; }
+    void delay(uint32_t) {}
+
+    IO_t IOGetByTag(ioTag_t tag) { return (IO_t)(uintptr_t)tag; }
+    bool IOIsFreeOrPreinit(IO_t) { return true; }
+    void IOInit(IO_t, resourceOwner_e, uint8_t) {}
+    void IOConfigGPIO(IO_t, ioConfig_t) {}
+    void IOHi(IO_t) {}
+    void IOLo(IO_t) {}
+
+    void EXTIHandlerInit(extiCallbackRec_t *cb, extiHandlerCallback *fn)
+    {
+        cb->fn = fn;
+        vsyncCallback = cb;
+    }
+    void EXTIConfig(IO_t, extiCallbackRec_t *, int, ioConfig_t, extiTrigger_t) {}
+    void EXTIEnable(IO_t, bool) {}
+
+    void spiPreinitRegister(ioTag_t, uint8_t, uint8_t) {}
+    SPI_TypeDef *spiInstanceByDevice(SPIDevice) { return NULL; }
+    void spiBusSetInstance(busDevice_t *, SPI_TypeDef *) {}
+    void spiSetDivisor(SPI_TypeDef *, uint16_t) {}
+    void spiBusSetDivisor(busDevice_t *, SPIClockDivider_e) {}
+
+    // registers are written as address and data byte pairs, one byte takes 1us
+    uint8_t spiTransferByte(SPI_TypeDef *, uint8_t data)
+    {
+        simTimeUs++;
+        if (sim.pendingRegister < 0) {
+            sim.pendingRegister = data;
+            return 0;
+        }
+        const uint8_t reg = sim.pendingRegister;
+        sim.pendingRegister = -1;
+        return simRegisterAccess(reg, data);
+    }
+
+    bool spiTransfer(SPI_TypeDef *instance, const uint8_t *txData, uint8_t *rxData, int len)
+    {
+        for (int i = 0; i < len; i++) {
+            const uint8_t value = spiTransferByte(instance, txData[i]);
+            if (rxData) {
+                rxData[i] = value;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,228 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "cli/settings.h"
+    #include "common/streambuf.h"
+    #include "common/utils.h"
+    #include "msp/msp_settings.h"
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    typedef struct testConfig_s {
+        uint8_t u8;
+        int16_t i16;
+        uint32_t u32;
+        uint8_t lookup;
+        uint16_t bits;
+        int8_t array[3];
+        char str[9];
+    } testConfig_t;
+
+    PG_DECLARE(testConfig_t, testConfig);
+    PG_REGISTER(testConfig_t, testConfig, PG_RESERVED_FOR_TESTING_1, 0);
+
+    const char * const lookupTableTest[] = { "A", "B", "C" };
+
+    const lookupTableEntry_t lookupTables[] = {
+        { lookupTableTest, 3 },
+    };
+
+    const clivalue_t valueTable[] = {
+        { "u8",     VAR_UINT8  | MASTER_VALUE | MODE_DIRECT, { .minmaxUnsigned = { 10, 200 } }, PG_RESERVED_FOR_TESTING_1, offsetof(testConfig_t, u8) },
+        { "i16",    VAR_INT16  | MASTER_VALUE | MODE_DIRECT, { .minmax = { -1000, 1000 } }, PG_RESERVED_FOR_TESTING_1, offsetof(testConfig_t, i16) },
+        { "u32",    VAR_UINT32 | MASTER_VALUE | MODE_DIRECT, { .u32Max = 100000 }, PG_RESERVED_FOR_TESTING_1, offsetof(testConfig_t, u32) },
+        { "lookup", VAR_UINT8  | MASTER_VALUE | MODE_LOOKUP, { .lookup = { (lookupTableIndex_e)0 } }, PG_RESERVED_FOR_TESTING_1, offsetof(testConfig_t, lookup) },
+        { "bit3",   VAR_UINT16 | MASTER_VALUE | MODE_BITSET, { .bitpos = 3 }, PG_RESERVED_FOR_TESTING_1, offsetof(testConfig_t, bits) },
+        { "bit9",   VAR_UINT16 | MASTER_VALUE | MODE_BITSET, { .bitpos = 9 }, PG_RESERVED_FOR_TESTING_1, offsetof(testConfig_t, bits) },
+        { "array",  VAR_INT8   | MASTER_VALUE | MODE_ARRAY,  { .array = { 3 } }, PG_RESERVED_FOR_TESTING_1, offsetof(testConfig_t, array) },
+        { "str",    VAR_UINT8  | MASTER_VALUE | MODE_STRING, { .string = { 0, 8, STRING_FLAGS_NONE } }, PG_RESERVED_FOR_TESTING_1, offsetof(testConfig_t, str) },
+    };
+    const uint16_t valueTableEntryCount = ARRAYLEN(valueTable);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_SETTING_COUNT 8
+
+static uint8_t replyBuf[256];
+static uint8_t requestBuf[256];
+
+static void setTestConfig(void)
+{
+    testConfig_t *config = testConfigMutable();
+    memset(config, 0, sizeof(*config));
+    config->u8 = 100;
+    config->i16 = -500;
+    config->u32 = 70000;
+    config->lookup = 2;
+    config->bits = 1 << 3;
+    config->array[0] = -1;
+    config->array[1] = 2;
+    config->array[2] = -3;
+    strcpy(config->str, "QUAD");
+}
+
+// reads settings starting at the given index, returns the number of reply bytes
+static int readSettings(uint16_t start, int replySize)
+{
+    uint8_t request[] = { (uint8_t)(start & 0xFF), (uint8_t)(start >> 8) };
+    sbuf_t src = { request, request + sizeof(request) };
+    sbuf_t dst = { replyBuf, replyBuf + replySize };
+
+    EXPECT_TRUE(mspSettingsSerialize(&dst, &src));
+    return dst.ptr - replyBuf;
+}
+
+static bool writeSettings(const uint8_t *entries, int length)
+{
+    requestBuf[0] = MSP_SETTINGS_CURRENT_PROFILE;
+    requestBuf[1] = MSP_SETTINGS_CURRENT_PROFILE;
+    memcpy(requestBuf + 2, entries, length);
+    sbuf_t src = { requestBuf, requestBuf + 2 + length };
+
+    return mspSettingsDeserialize(&src);
+}
+
+TEST(MspSettingsUnittest, TestSerialize)
+{
+    setTestConfig();
+
+    const int replyLength = readSettings(0, sizeof(replyBuf));
+
+    const uint8_t expected[] = {
+        TEST_SETTING_COUNT, 0, TEST_SETTING_COUNT, 0,
+        0, 0, VAR_UINT8 | MODE_DIRECT, 1, 100,
+        1, 0, VAR_INT16 | MODE_DIRECT, 2, 0x0C, 0xFE,
+        2, 0, VAR_UINT32 | MODE_DIRECT, 4, 0x70, 0x11, 0x01, 0x00,
+        3, 0, VAR_UINT8 | MODE_LOOKUP, 1, 2,
+        4, 0, VAR_UINT16 | MODE_BITSET, 1, 1,
+        5, 0, VAR_UINT16 | MODE_BITSET, 1, 0,
+        6, 0, VAR_INT8 | MODE_ARRAY, 3, 0xFF, 2, 0xFD,
+        7, 0, VAR_UINT8 | MODE_STRING, 4, 'Q', 'U', 'A', 'D',
+    };
+    EXPECT_EQ((int)sizeof(expected), replyLength);
+    EXPECT_EQ(0, memcmp(expected, replyBuf, sizeof(expected)));
+}
+
+TEST(MspSettingsUnittest, TestSerializeChunks)
+{
+    setTestConfig();
+
+    // replies hold as many whole settings as fit, reading continues at the next setting
+    uint16_t start = 0;
+    int chunks = 0;
+    int settings = 0;
+    while (start < TEST_SETTING_COUNT) {
+        const int replyLength = readSettings(start, 16);
+        EXPECT_GE(16, replyLength);
+        EXPECT_EQ(TEST_SETTING_COUNT, replyBuf[0] | replyBuf[1] << 8);
+
+        const uint16_t next = replyBuf[2] | replyBuf[3] << 8;
+        EXPECT_LT(start, next);
+
+        for (int offset = 4; offset < replyLength; offset += 4 + replyBuf[offset + 3]) {
+            EXPECT_EQ(start + settings, replyBuf[offset] | replyBuf[offset + 1] << 8);
+            settings++;
+        }
+        start += settings;
+        settings = 0;
+        EXPECT_EQ(next, start);
+        chunks++;
+    }
+    EXPECT_EQ(TEST_SETTING_COUNT, start);
+    EXPECT_LT(1, chunks);
+}
+
+TEST(MspSettingsUnittest, TestRoundTrip)
+{
+    setTestConfig();
+    const int replyLength = readSettings(0, sizeof(replyBuf));
+    uint8_t entries[256];
+    memcpy(entries, replyBuf + 4, replyLength - 4);
+
+    testConfig_t saved = *testConfig();
+    memset(testConfigMutable(), 0, sizeof(testConfig_t));
+    testConfigMutable()->str[0] = 'X';
+    testConfigMutable()->str[5] = 'Y';
+
+    EXPECT_TRUE(writeSettings(entries, replyLength - 4));
+    EXPECT_EQ(0, memcmp(&saved, testConfig(), sizeof(testConfig_t)));
+}
+
+TEST(MspSettingsUnittest, TestDeserializeBitset)
+{
+    setTestConfig();
+    testConfigMutable()->bits |= 1 << 4;
+
+    const uint8_t entries[] = {
+        4, 0, VAR_UINT16 | MODE_BITSET, 1, 0,
+        5, 0, VAR_UINT16 | MODE_BITSET, 1, 1,
+    };
+    EXPECT_TRUE(writeSettings(entries, sizeof(entries)));
+
+    // other bits are kept
+    EXPECT_EQ((1 << 4) | (1 << 9), testConfig()->bits);
+}
+
+TEST(MspSettingsUnittest, TestDeserializeInvalid)
+{
+    setTestConfig();
+    const testConfig_t saved = *testConfig();
+
+    // a valid setting followed by an out of range one, nothing is applied
+    const uint8_t outOfRange[] = {
+        0, 0, VAR_UINT8 | MODE_DIRECT, 1, 150,
+        1, 0, VAR_INT16 | MODE_DIRECT, 2, 0xD0, 0x07,
+    };
+    EXPECT_FALSE(writeSettings(outOfRange, sizeof(outOfRange)));
+    EXPECT_EQ(0, memcmp(&saved, testConfig(), sizeof(testConfig_t)));
+
+    const uint8_t lookupOutOfRange[] = { 3, 0, VAR_UINT8 | MODE_LOOKUP, 1, 3 };
+    EXPECT_FALSE(writeSettings(lookupOutOfRange, sizeof(lookupOutOfRange)));
+
+    const uint8_t wrongType[] = { 0, 0, VAR_INT8 | MODE_DIRECT, 1, 50 };
+    EXPECT_FALSE(writeSettings(wrongType, sizeof(wrongType)));
+
+    const uint8_t wrongLength[] = { 6, 0, VAR_INT8 | MODE_ARRAY, 2, 1, 2 };
+    EXPECT_FALSE(writeSettings(wrongLength, sizeof(wrongLength)));
+
+    const uint8_t stringTooLong[] = { 7, 0, VAR_UINT8 | MODE_STRING, 9, 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I' };
+    EXPECT_FALSE(writeSettings(stringTooLong, sizeof(stringTooLong)));
+
+    const uint8_t unknownIndex[] = { TEST_SETTING_COUNT, 0, VAR_UINT8 | MODE_DIRECT, 1, 50 };
+    EXPECT_FALSE(writeSettings(unknownIndex, sizeof(unknownIndex)));
+
+    const uint8_t truncated[] = { 2, 0, VAR_UINT32 | MODE_DIRECT, 4, 0x10 };
+    EXPECT_FALSE(writeSettings(truncated, sizeof(truncated)));
+
+    EXPECT_EQ(0, memcmp(&saved, testConfig(), sizeof(testConfig_t)));
+}
+
+// STUBS
+extern "C" {
+uint8_t getCurrentPidProfileIndex(void) { return 0; }
+uint8_t getCurrentControlRateProfileIndex(void) { return 0; }
+}
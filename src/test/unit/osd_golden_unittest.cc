@@ -0,0 +1,532 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * OSD rendering harness.
+ *
+ * Runs osdRefresh() at the OSD render rate through scripted flights against a RAM displayport. For each
+ * flight it records the host time per frame and the bytes written to the displayport, and compares the
+ * screen at chosen points with golden frames.
+ *
+ * The golden frames and byte counts guard the output and the amount of drawing, the times are only
+ * reported as they depend on the host. When a change is intended, run the test and copy the printed
+ * frames and counts into the flight.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "blackbox/blackbox.h"
+    #include "blackbox/blackbox_io.h"
+
+    #include "config/feature.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/rx.h"
+
+    #include "common/time.h"
+
+    #include "drivers/osd_symbols.h"
+    #include "drivers/persistent.h"
+    #include "drivers/serial.h"
+
+    #include "config/config.h"
+    #include "fc/core.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/gps_rescue.h"
+    #include "flight/pid.h"
+    #include "flight/imu.h"
+
+    #include "io/beeper.h"
+    #include "io/gps.h"
+
+    #include "osd/osd.h"
+    #include "osd/osd_elements.h"
+
+    #include "sensors/acceleration.h"
+    #include "sensors/battery.h"
+
+    #include "rx/rx.h"
+    #include "flight/mixer.h"
+
+    #include "scheduler/scheduler.h"
+
+    void osdRefresh(timeUs_t currentTimeUs);
+
+    uint16_t rssi;
+    attitudeEulerAngles_t attitude;
+    pidProfile_t *currentPidProfile;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+    uint8_t GPS_numSat;
+    uint16_t GPS_distanceToHome;
+    int16_t GPS_directionToHome;
+    uint32_t GPS_distanceFlownInCm;
+    int32_t GPS_coord[2];
+    gpsSolutionData_t gpsSol;
+    float motor[8];
+    float motorOutputHigh = 2047;
+    float motorOutputLow = 1000;
+
+    linkQualitySource_e linkQualitySource;
+
+    acc_t acc;
+    float accAverage[XYZ_AXIS_COUNT];
+
+    PG_REGISTER(batteryConfig_t, batteryConfig, PG_BATTERY_CONFIG, 0);
+    PG_REGISTER(blackboxConfig_t, blackboxConfig, PG_BLACKBOX_CONFIG, 0);
+    PG_REGISTER(systemConfig_t, systemConfig, PG_SYSTEM_CONFIG, 0);
+    PG_REGISTER(pilotConfig_t, pilotConfig, PG_PILOT_CONFIG, 0);
+    PG_REGISTER(gpsRescueConfig_t, gpsRescueConfig, PG_GPS_RESCUE, 0);
+    PG_REGISTER(imuConfig_t, imuConfig, PG_IMU_CONFIG, 0);
+    PG_REGISTER(gpsConfig_t, gpsConfig, PG_GPS_CONFIG, 0);
+}
+
+#include "unittest_macros.h"
+#include "unittest_displayport.h"
+#include "gtest/gtest.h"
+
+// osdUpdate() renders every DRAW_FREQ_DENOM task runs of the 60Hz OSD task
+#define OSD_RENDER_PERIOD_US (5 * TASK_PERIOD_HZ(OSD_TASK_FREQUENCY_HZ))
+
+// The state the OSD reads, held from atUs until the next step of a flight
+typedef struct flightStep_s {
+    timeUs_t atUs;
+    bool armed;
+    uint16_t rssi;
+    uint16_t batteryVoltage;    // 0.01V
+    int32_t amperage;           // 0.01A
+    int32_t mAhDrawn;
+    int32_t altitudeCm;
+    int32_t varioCmS;
+    uint16_t groundSpeedCmS;
+    uint16_t distanceToHomeM;
+    uint8_t numSat;
+    int16_t pitchDecidegrees;
+    int16_t rollDecidegrees;
+} flightStep_t;
+
+// A screen as rows of text, symbols are shown as {xx} with their hex value
+typedef struct goldenFrame_s {
+    timeUs_t atUs;
+    const char *rows[UNITTEST_DISPLAYPORT_ROWS];
+} goldenFrame_t;
+
+typedef struct flightStats_s {
+    unsigned frames;
+    uint64_t totalNs;
+    uint64_t maxNs;
+    uint32_t bytesWritten;
+    uint32_t maxFrameBytes;
+} flightStats_t;
+
+static timeUs_t simulationTime;
+static const flightStep_t *currentStep;
+
+static uint32_t displayBytesWritten;
+
+static int goldenDisplayPortWriteString(displayPort_t *displayPort, uint8_t x, uint8_t y, uint8_t attr, const char *s)
+{
+    displayBytesWritten += strlen(s);
+    return displayPortTestWriteString(displayPort, x, y, attr, s);
+}
+
+static int goldenDisplayPortWriteChar(displayPort_t *displayPort, uint8_t x, uint8_t y, uint8_t attr, uint8_t c)
+{
+    displayBytesWritten++;
+    return displayPortTestWriteChar(displayPort, x, y, attr, c);
+}
+
+static displayPortVTable_t goldenDisplayPortVTable;
+
+static uint64_t nanos(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static std::string renderRow(int row)
+{
+    std::string text;
+    for (int col = 0; col < UNITTEST_DISPLAYPORT_COLS; col++) {
+        const uint8_t c = testDisplayPortBuffer[row * UNITTEST_DISPLAYPORT_COLS + col];
+        if (c >= 0x20 && c < 0x7f && c != '{') {
+            text += (char)c;
+        } else {
+            char symbol[5];
+            snprintf(symbol, sizeof(symbol), "{%02x}", c);
+            text += symbol;
+        }
+    }
+    return text;
+}
+
+static void printFrame(timeUs_t atUs)
+{
+    printf("    { %u, {\n", (unsigned)atUs);
+    for (int row = 0; row < UNITTEST_DISPLAYPORT_ROWS; row++) {
+        printf("        \"%s\",\n", renderRow(row).c_str());
+    }
+    printf("    } },\n");
+}
+
+static bool frameMatches(const goldenFrame_t *golden)
+{
+    bool matches = true;
+    for (int row = 0; row < UNITTEST_DISPLAYPORT_ROWS; row++) {
+        const std::string rendered = renderRow(row);
+        EXPECT_EQ(std::string(golden->rows[row]), rendered) << "row " << row << " at " << golden->atUs << "us";
+        matches &= rendered == golden->rows[row];
+    }
+    return matches;
+}
+
+static void applyStep(const flightStep_t *step)
+{
+    currentStep = step;
+
+    if (step->armed) {
+        ENABLE_ARMING_FLAG(ARMED);
+    } else {
+        DISABLE_ARMING_FLAG(ARMED);
+    }
+    rssi = step->rssi;
+    gpsSol.groundSpeed = step->groundSpeedCmS;
+    gpsSol.numSat = step->numSat;
+    GPS_distanceToHome = step->distanceToHomeM;
+    attitude.values.pitch = step->pitchDecidegrees;
+    attitude.values.roll = step->rollDecidegrees;
+}
+
+/*
+ * Renders frames at the OSD render rate from the first step to endUs, compares the screen with each golden
+ * frame when its time is reached and returns the statistics of the flight.
+ */
+static flightStats_t runFlight(const flightStep_t *steps, unsigned stepCount, timeUs_t endUs, const goldenFrame_t *golden, unsigned goldenCount)
+{
+    flightStats_t stats;
+    memset(&stats, 0, sizeof(stats));
+
+    unsigned nextStep = 0;
+    unsigned nextGolden = 0;
+
+    for (simulationTime = steps[0].atUs; simulationTime <= endUs; simulationTime += OSD_RENDER_PERIOD_US) {
+        while (nextStep < stepCount && steps[nextStep].atUs <= simulationTime) {
+            applyStep(&steps[nextStep++]);
+        }
+
+        displayBytesWritten = 0;
+        const uint64_t startNs = nanos();
+        osdRefresh(simulationTime);
+        const uint64_t frameNs = nanos() - startNs;
+
+        stats.frames++;
+        stats.totalNs += frameNs;
+        stats.maxNs = MAX(stats.maxNs, frameNs);
+        stats.bytesWritten += displayBytesWritten;
+        stats.maxFrameBytes = MAX(stats.maxFrameBytes, displayBytesWritten);
+
+        while (nextGolden < goldenCount && golden[nextGolden].atUs <= simulationTime) {
+            if (!frameMatches(&golden[nextGolden])) {
+                printf("Screen rendered for the golden frame:\n");
+                printFrame(golden[nextGolden].atUs);
+            }
+            nextGolden++;
+        }
+    }
+    EXPECT_EQ(goldenCount, nextGolden);
+
+    return stats;
+}
+
+static void printStats(const char *name, const flightStats_t *stats)
+{
+    printf("%s: %u frames, %.2f us/frame average, %.2f us max, %u bytes written, %u bytes max per frame\n",
+        name, stats->frames, stats->totalNs / 1000.0 / stats->frames, stats->maxNs / 1000.0,
+        stats->bytesWritten, stats->maxFrameBytes);
+}
+
+class OsdGoldenTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestCase() {
+        displayPortTestInit();
+        goldenDisplayPortVTable = *testDisplayPort.vTable;
+        goldenDisplayPortVTable.writeString = goldenDisplayPortWriteString;
+        goldenDisplayPortVTable.writeChar = goldenDisplayPortWriteChar;
+        testDisplayPort.vTable = &goldenDisplayPortVTable;
+
+        batteryConfigMutable()->vbatmincellvoltage = 330;
+        batteryConfigMutable()->vbatmaxcellvoltage = 430;
+        batteryConfigMutable()->vbatwarningcellvoltage = 350;
+
+        memset(osdElementConfigMutable(), 0, sizeof(osdElementConfig_t));
+        osdConfigMutable()->enabled_stats = 0;
+        osdConfigMutable()->units = OSD_UNIT_METRIC;
+        osdConfigMutable()->rssi_alarm = 20;
+        osdConfigMutable()->cap_alarm  = 1300;
+        osdConfigMutable()->alt_alarm  = 100; // meters
+
+        // a typical freestyle layout
+        osdElementConfigMutable()->item_pos[OSD_RSSI_VALUE]         = OSD_POS(1, 1)   | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_ITEM_TIMER_2]       = OSD_POS(23, 1)  | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_GPS_SATS]           = OSD_POS(1, 2)   | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_GPS_SPEED]          = OSD_POS(23, 2)  | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_HOME_DIST]          = OSD_POS(1, 3)   | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_ALTITUDE]           = OSD_POS(23, 3)  | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_NUMERICAL_VARIO]    = OSD_POS(23, 4)  | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_CROSSHAIRS]         = OSD_POS(13, 6)  | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_PITCH_ANGLE]        = OSD_POS(1, 7)   | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_ROLL_ANGLE]         = OSD_POS(1, 8)   | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_WARNINGS]           = OSD_POS(9, 10)  | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_MAIN_BATT_VOLTAGE]  = OSD_POS(1, 12)  | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_AVG_CELL_VOLTAGE]   = OSD_POS(1, 13)  | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_CURRENT_DRAW]       = OSD_POS(22, 12) | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_MAH_DRAWN]          = OSD_POS(23, 13) | OSD_PROFILE_1_FLAG;
+        osdElementConfigMutable()->item_pos[OSD_FLYMODE]            = OSD_POS(13, 14) | OSD_PROFILE_1_FLAG;
+
+        osdConfigMutable()->timers[OSD_TIMER_2] = OSD_TIMER(OSD_TIMER_SRC_TOTAL_ARMED, OSD_TIMER_PREC_SECOND, 0);
+
+        sensorsSet(SENSOR_GPS | SENSOR_BARO);
+        stateFlags |= GPS_FIX | GPS_FIX_HOME;
+
+        osdInit(&testDisplayPort, OSD_DISPLAYPORT_DEVICE_AUTO);
+    }
+};
+
+/*
+ * Power on, past the splash screen, arm, punch out and back, then a low battery on the way down.
+ */
+static const flightStep_t punchOutFlight[] = {
+    // atUs      armed  rssi  vbat  amps   mAh  alt   vario speed dist sats pitch roll
+    {        0, false, 1023, 1680,    0,    0,    0,    0,    0,   0,   8,    0,    0 },
+    {  5000000, true,  1023, 1670,  150,    0,    0,    0,    0,   0,  10,    0,    0 },
+    {  6000000, true,  1000, 1540, 4500,   12,  250,  850, 1200,  10,  10, -150,   20 },
+    {  7000000, true,   900, 1510, 3800,   45, 1800,  420, 2500,  55,  11, -220,  -35 },
+    {  8000000, true,   700, 1490, 1200,   70, 2500,    0, 1800, 120,  11,   45,  300 },
+    {  9500000, true,   650, 1450,  900,   95, 1500, -650, 1500,  60,  12,   80, -120 },
+    { 11000000, true,   600, 1380, 2200,  160,  400, -300,  600,  15,  12,    0,    0 },
+};
+
+static const goldenFrame_t punchOutGolden[] = {
+    { 4500000, {
+        "                              ",
+        " {01}99                   {9c}00:00 ",
+        " {1e}{1f} 8                  p  0{9e}  ",
+        " {11}0{0c}                   {7f}0.0{0c}  ",
+        "                       u0.0{9f}  ",
+        "                              ",
+        "             rst              ",
+        " {15} 00.0                       ",
+        " {14} 00.0                       ",
+        "                              ",
+        "                              ",
+        "                              ",
+        " {90}16.8{06}                 0.00{9a} ",
+        " {90}4.20{06}                   0{07}  ",
+        "             ACRO             ",
+        "                              ",
+    } },
+    { 5200000, {
+        "                              ",
+        "                              ",
+        "                              ",
+        "                              ",
+        "                              ",
+        "                              ",
+        "                              ",
+        "            ARMED             ",
+        "                              ",
+        "                              ",
+        "                              ",
+        "                              ",
+        "                              ",
+        "                              ",
+        "                              ",
+        "                              ",
+    } },
+    { 6500000, {
+        "                              ",
+        " {01}97                   {9c}00:01 ",
+        " {1e}{1f}10                  p 43{9e}  ",
+        " {11}10{0c}                  {7f}2.5{0c}  ",
+        "                       u8.5{9f}  ",
+        "                              ",
+        "             rst              ",
+        " {15}-15.0                       ",
+        " {14} 02.0                       ",
+        "                              ",
+        "                              ",
+        "                              ",
+        " {92}15.4{06}                45.00{9a} ",
+        " {92}3.85{06}                  12{07}  ",
+        "             ACRO             ",
+        "                              ",
+    } },
+    { 8500000, {
+        "                              ",
+        " {01}68                   {9c}00:03 ",
+        " {1e}{1f}11                  p 64{9e}  ",
+        " {11}120{0c}                 {7f}25.0{0c} ",
+        "                       u0.0{9f}  ",
+        "                              ",
+        "             rst              ",
+        " {15} 04.5                       ",
+        " {14} 30.0                       ",
+        "                              ",
+        "                              ",
+        "                              ",
+        " {93}14.9{06}                12.00{9a} ",
+        " {93}3.72{06}                  70{07}  ",
+        "             ACRO             ",
+        "                              ",
+    } },
+    { 10000000, {
+        "                              ",
+        " {01}63                   {9c}00:05 ",
+        " {1e}{1f}12                  p 54{9e}  ",
+        " {11}60{0c}                  {7f}15.0{0c} ",
+        "                       v6.5{9f}  ",
+        "                              ",
+        "             rst              ",
+        " {15} 08.0                       ",
+        " {14}-12.0                       ",
+        "                              ",
+        "                              ",
+        "                              ",
+        " {94}14.5{06}                 9.00{9a} ",
+        " {94}3.62{06}                  95{07}  ",
+        "             ACRO             ",
+        "                              ",
+    } },
+    { 11900000, {
+        "                              ",
+        " {01}58                   {9c}00:06 ",
+        " {1e}{1f}12                  p 21{9e}  ",
+        " {11}15{0c}                  {7f}4.0{0c}  ",
+        "                       v3.0{9f}  ",
+        "                              ",
+        "             rst              ",
+        " {15} 00.0                       ",
+        " {14} 00.0                       ",
+        "                              ",
+        "                              ",
+        "                              ",
+        "                       22.00{9a} ",
+        "                        160{07}  ",
+        "             ACRO             ",
+        "                              ",
+    } },
+};
+
+TEST_F(OsdGoldenTest, PunchOut)
+{
+    const flightStats_t stats = runFlight(punchOutFlight, ARRAYLEN(punchOutFlight), 12000000, punchOutGolden, ARRAYLEN(punchOutGolden));
+
+    printStats("PunchOut", &stats);
+
+    // drawing more than this is a regression, update the counts when less is drawn
+    EXPECT_GE(6633U, stats.bytesWritten);
+    EXPECT_GE(77U, stats.maxFrameBytes);
+}
+
+// STUBS
+extern "C" {
+    bool featureIsEnabled(uint32_t f) { return FEATURE_GPS & f; }
+
+    void beeperConfirmationBeeps(uint8_t) {}
+
+    bool isModeActivationConditionPresent(boxId_e) { return false; }
+
+    bool IS_RC_MODE_ACTIVE(boxId_e) { return false; }
+
+    uint32_t micros() { return simulationTime; }
+
+    uint32_t millis() { return micros() / 1000; }
+
+    bool isBeeperOn() { return false; }
+
+    bool airmodeIsEnabled() { return false; }
+
+    uint8_t getCurrentPidProfileIndex() { return 0; }
+
+    uint8_t getCurrentControlRateProfileIndex() { return 0; }
+
+    batteryState_e getBatteryState() { return currentStep->batteryVoltage < 1400 ? BATTERY_WARNING : BATTERY_OK; }
+
+    uint8_t getBatteryCellCount() { return 4; }
+
+    uint16_t getBatteryVoltage() { return currentStep->batteryVoltage; }
+
+    uint16_t getBatteryAverageCellVoltage() { return currentStep->batteryVoltage / 4; }
+
+    int32_t getAmperage() { return currentStep->amperage; }
+
+    int32_t getMAhDrawn() { return currentStep->mAhDrawn; }
+
+    int32_t getEstimatedAltitudeCm() { return currentStep->altitudeCm; }
+
+    int32_t getEstimatedVario() { return currentStep->varioCmS; }
+
+    int32_t blackboxGetLogNumber() { return 0; }
+
+    bool isBlackboxDeviceWorking() { return true; }
+
+    bool isBlackboxDeviceFull() { return false; }
+
+    bool isSerialTransmitBufferEmpty(const serialPort_t *) { return false; }
+
+    void serialWrite(serialPort_t *, uint8_t) {}
+
+    bool cmsDisplayPortRegister(displayPort_t *) { return false; }
+
+    uint16_t getRssi(void) { return rssi; }
+
+    uint8_t getRssiPercent(void) { return scaleRange(rssi, 0, RSSI_MAX_VALUE, 0, 100); }
+
+    uint16_t rxGetLinkQuality(void) { return LINK_QUALITY_MAX_VALUE; }
+
+    uint16_t getCoreTemperatureCelsius(void) { return 0; }
+
+    bool isFlipOverAfterCrashActive(void) { return false; }
+
+    float pidItermAccelerator(void) { return 1.0; }
+    uint8_t getMotorCount(void){ return 4; }
+    bool areMotorsRunning(void){ return true; }
+    bool pidOsdAntiGravityActive(void) { return false; }
+    bool failsafeIsActive(void) { return false; }
+    bool gpsRescueIsConfigured(void) { return false; }
+    int8_t calculateThrottlePercent(void) { return 0; }
+    uint32_t persistentObjectRead(persistentObjectId_e) { return 0; }
+    void persistentObjectWrite(persistentObjectId_e, uint32_t) {}
+    bool isUpright(void) { return true; }
+}
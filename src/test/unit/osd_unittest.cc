@@ -113,6 +113,11 @@ uint32_t simulationFeatureFlags = FEATURE_GPS;
 #include "unittest_displayport.h"
 #include "gtest/gtest.h"
 
+// matches osdElementRefreshIntervalMs[OSD_WARNINGS]
+#define OSD_WARNINGS_REFRESH_INTERVAL_US 100000
+// longer than the warnings refresh interval and a whole number of blink cycles, so blinking warnings stay visible
+#define OSD_WARNINGS_REFRESH_STEP_US 400000
+
 void setDefaultSimulationState()
 {
     memset(osdElementConfigMutable(), 0, sizeof(osdElementConfig_t));
@@ -1020,6 +1025,7 @@ TEST_F(OsdTest, TestElementWarningsBattery)
     simulationBatteryState = BATTERY_OK;
 
     // when
+    simulationTime += OSD_WARNINGS_REFRESH_STEP_US;
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -1032,6 +1038,7 @@ TEST_F(OsdTest, TestElementWarningsBattery)
     simulationBatteryState = BATTERY_WARNING;
 
     // when
+    simulationTime += OSD_WARNINGS_REFRESH_STEP_US;
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -1044,6 +1051,7 @@ TEST_F(OsdTest, TestElementWarningsBattery)
     simulationBatteryState = BATTERY_CRITICAL;
 
     // when
+    simulationTime += OSD_WARNINGS_REFRESH_STEP_US;
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -1056,6 +1064,7 @@ TEST_F(OsdTest, TestElementWarningsBattery)
     simulationBatteryState = BATTERY_OK;
 
     // when
+    simulationTime += OSD_WARNINGS_REFRESH_STEP_US;
     displayClearScreen(&testDisplayPort);
     osdRefresh(simulationTime);
 
@@ -1065,6 +1074,57 @@ TEST_F(OsdTest, TestElementWarningsBattery)
     // TODO
 }
 
+/*
+ * Tests that an element with a refresh interval redraws its last output until the interval has passed.
+ */
+TEST_F(OsdTest, TestElementRefreshInterval)
+{
+    // given
+    osdElementConfigMutable()->item_pos[OSD_WARNINGS] = OSD_POS(9, 10) | OSD_PROFILE_1_FLAG;
+    osdConfigMutable()->enabledWarnings = 0;  // disable all warnings
+    osdWarnSetState(OSD_WARNING_BATTERY_WARNING, true);
+
+    osdAnalyzeActiveElements();
+
+    // and
+    simulationBatteryState = BATTERY_WARNING;
+
+    // and
+    // the device blinks the warning so that it is drawn on every refresh
+    testDisplayPort.useDeviceBlink = true;
+
+    // when
+    simulationTime += OSD_WARNINGS_REFRESH_STEP_US;
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    displayPortTestBufferSubstring(9, 10, "LOW BATTERY ");
+
+    // given
+    simulationBatteryState = BATTERY_OK;
+
+    // when
+    // refreshed again before the interval has passed
+    simulationTime += OSD_WARNINGS_REFRESH_INTERVAL_US / 2;
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    // the cached output is redrawn after the screen was cleared
+    displayPortTestBufferSubstring(9, 10, "LOW BATTERY ");
+
+    // when
+    simulationTime += OSD_WARNINGS_REFRESH_INTERVAL_US / 2;
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    displayPortTestBufferSubstring(9, 10, "            ");
+
+    testDisplayPort.useDeviceBlink = false;
+}
+
 /*
  * Tests the time string formatting function with a series of precision settings and time values.
  */
@@ -0,0 +1,229 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/filter.h"
+    #include "common/maths.h"
+
+    #include "fc/rc_prediction.h"
+
+    #include "rx/rx.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define RX_FRAME_US     4000    // 250Hz rx
+#define PID_LOOP_US     125     // 8kHz pid loop
+
+static void initPrediction(rcPrediction_t *prediction, float rxData)
+{
+    memset(prediction, 0, sizeof(*prediction));
+    rcPredictionUpdate(prediction, rxData, RX_FRAME_US);
+}
+
+static float applyPrediction(const rcPrediction_t *prediction, timeDelta_t elapsedUs)
+{
+    return rcPredictionApply(prediction, elapsedUs, -500.0f, 500.0f);
+}
+
+TEST(RcPredictionUnittest, TestRampExtrapolated)
+{
+    rcPrediction_t prediction;
+    initPrediction(&prediction, 0);
+
+    // a single step is not a trend yet
+    rcPredictionUpdate(&prediction, 10, RX_FRAME_US);
+    EXPECT_FLOAT_EQ(10, applyPrediction(&prediction, RX_FRAME_US / 2));
+
+    // a second step in the same direction is extrapolated over the frame interval
+    rcPredictionUpdate(&prediction, 20, RX_FRAME_US);
+    EXPECT_FLOAT_EQ(20, applyPrediction(&prediction, 0));
+    EXPECT_FLOAT_EQ(25, applyPrediction(&prediction, RX_FRAME_US / 2));
+    EXPECT_FLOAT_EQ(30, applyPrediction(&prediction, RX_FRAME_US));
+
+    // and the same downwards
+    initPrediction(&prediction, 0);
+    rcPredictionUpdate(&prediction, -10, RX_FRAME_US);
+    rcPredictionUpdate(&prediction, -20, RX_FRAME_US);
+    EXPECT_FLOAT_EQ(-25, applyPrediction(&prediction, RX_FRAME_US / 2));
+
+    // the slope follows the rx frame rate
+    initPrediction(&prediction, 0);
+    rcPredictionUpdate(&prediction, 10, 2 * RX_FRAME_US);
+    rcPredictionUpdate(&prediction, 20, 2 * RX_FRAME_US);
+    EXPECT_FLOAT_EQ(22.5f, applyPrediction(&prediction, RX_FRAME_US / 2));
+}
+
+TEST(RcPredictionUnittest, TestReversalHeld)
+{
+    rcPrediction_t prediction;
+    initPrediction(&prediction, 0);
+    rcPredictionUpdate(&prediction, 10, RX_FRAME_US);
+    rcPredictionUpdate(&prediction, 20, RX_FRAME_US);
+
+    rcPredictionUpdate(&prediction, 15, RX_FRAME_US);
+    EXPECT_FLOAT_EQ(15, applyPrediction(&prediction, RX_FRAME_US / 2));
+    EXPECT_FLOAT_EQ(15, applyPrediction(&prediction, RX_FRAME_US));
+
+    // a second step in the new direction starts a trend with the smaller of the two steps
+    rcPredictionUpdate(&prediction, 5, RX_FRAME_US);
+    EXPECT_FLOAT_EQ(0, applyPrediction(&prediction, RX_FRAME_US));
+}
+
+TEST(RcPredictionUnittest, TestDeadbandHeld)
+{
+    rcPrediction_t prediction;
+    initPrediction(&prediction, 100);
+
+    // rx noise creeping in one direction is not extrapolated
+    for (int i = 1; i <= 5; i++) {
+        rcPredictionUpdate(&prediction, 100 + i * RC_PREDICTION_DEADBAND, RX_FRAME_US);
+        EXPECT_FLOAT_EQ(100 + i * RC_PREDICTION_DEADBAND, applyPrediction(&prediction, RX_FRAME_US));
+    }
+
+    // nor is a step within the deadband after a trend
+    rcPredictionUpdate(&prediction, 120, RX_FRAME_US);
+    rcPredictionUpdate(&prediction, 140, RX_FRAME_US);
+    rcPredictionUpdate(&prediction, 140 + RC_PREDICTION_DEADBAND, RX_FRAME_US);
+    EXPECT_FLOAT_EQ(140 + RC_PREDICTION_DEADBAND, applyPrediction(&prediction, RX_FRAME_US));
+}
+
+TEST(RcPredictionUnittest, TestOvershootBounded)
+{
+    rcPrediction_t prediction;
+    initPrediction(&prediction, 0);
+    rcPredictionUpdate(&prediction, 20, RX_FRAME_US);
+    rcPredictionUpdate(&prediction, 40, RX_FRAME_US);
+
+    // the prediction runs at most one frame interval ahead, also when frames are late
+    EXPECT_FLOAT_EQ(60, applyPrediction(&prediction, RX_FRAME_US));
+    EXPECT_FLOAT_EQ(60, applyPrediction(&prediction, 3 * RX_FRAME_US));
+    EXPECT_FLOAT_EQ(40, applyPrediction(&prediction, -PID_LOOP_US));
+
+    // a decelerating stick extrapolates the smaller step
+    rcPredictionUpdate(&prediction, 50, RX_FRAME_US);
+    EXPECT_FLOAT_EQ(60, applyPrediction(&prediction, RX_FRAME_US));
+
+    // and the stick stopping holds the value
+    rcPredictionUpdate(&prediction, 50, RX_FRAME_US);
+    EXPECT_FLOAT_EQ(50, applyPrediction(&prediction, RX_FRAME_US));
+
+    // overshoot within one step of the end of a ramp stops at the range of the channel
+    initPrediction(&prediction, 470);
+    rcPredictionUpdate(&prediction, 485, RX_FRAME_US);
+    rcPredictionUpdate(&prediction, 500, RX_FRAME_US);
+    EXPECT_FLOAT_EQ(500, applyPrediction(&prediction, RX_FRAME_US));
+
+    initPrediction(&prediction, -470);
+    rcPredictionUpdate(&prediction, -485, RX_FRAME_US);
+    rcPredictionUpdate(&prediction, -500, RX_FRAME_US);
+    EXPECT_FLOAT_EQ(-500, applyPrediction(&prediction, RX_FRAME_US));
+
+    // throttle
+    initPrediction(&prediction, PWM_RANGE_MAX - 30);
+    rcPredictionUpdate(&prediction, PWM_RANGE_MAX - 15, RX_FRAME_US);
+    rcPredictionUpdate(&prediction, PWM_RANGE_MAX, RX_FRAME_US);
+    EXPECT_FLOAT_EQ(PWM_RANGE_MAX, rcPredictionApply(&prediction, RX_FRAME_US, PWM_RANGE_MIN, PWM_RANGE_MAX));
+
+    initPrediction(&prediction, PWM_RANGE_MIN + 30);
+    rcPredictionUpdate(&prediction, PWM_RANGE_MIN + 15, RX_FRAME_US);
+    rcPredictionUpdate(&prediction, PWM_RANGE_MIN, RX_FRAME_US);
+    EXPECT_FLOAT_EQ(PWM_RANGE_MIN, rcPredictionApply(&prediction, RX_FRAME_US, PWM_RANGE_MIN, PWM_RANGE_MAX));
+}
+
+// stick position of the trace: held, a ramp of rampSlope units per frame to end, then held again
+static float stickTrace(timeUs_t timeUs, float rampSlope, float end)
+{
+    const timeUs_t rampStartUs = 10 * RX_FRAME_US;
+    if (timeUs < rampStartUs) {
+        return 0;
+    }
+    return MIN((timeUs - rampStartUs) * rampSlope / RX_FRAME_US, end);
+}
+
+typedef struct traceResult_s {
+    float rampErrorAvg;     // average distance to the stick during the ramp
+    float overshootMax;     // largest value past the end of the ramp
+} traceResult_t;
+
+// Runs the stick trace sampled by the rx through the prediction or the biquad smoothing filter at the
+// cutoff rc_smoothing_auto_factor = 10 gives at this frame rate, as calcRcSmoothingCutoff()
+static traceResult_t runStickTrace(bool predict, float rampSlope, float end)
+{
+    rcPrediction_t prediction;
+    initPrediction(&prediction, 0);
+
+    biquadFilter_t filter;
+    const int cutoff = lrintf((1 / (RX_FRAME_US * 1e-6f)) / 2 * (100 - 10) / 100.0f);
+    biquadFilterInitLPF(&filter, cutoff, PID_LOOP_US);
+
+    float rxData = 0;
+    timeUs_t frameTimeUs = 0;
+    float rampErrorSum = 0;
+    int rampLoops = 0;
+    traceResult_t result = { 0, 0 };
+    const timeUs_t rampEndUs = 10 * RX_FRAME_US + lrintf(end / rampSlope) * RX_FRAME_US;
+
+    for (timeUs_t timeUs = 0; timeUs < rampEndUs + 50 * RX_FRAME_US; timeUs += PID_LOOP_US) {
+        if (timeUs % RX_FRAME_US == 0) {
+            rxData = stickTrace(timeUs, rampSlope, end);
+            frameTimeUs = timeUs;
+            rcPredictionUpdate(&prediction, rxData, RX_FRAME_US);
+        }
+
+        float rcCommand;
+        if (predict) {
+            rcCommand = applyPrediction(&prediction, cmpTimeUs(timeUs, frameTimeUs));
+        } else {
+            rcCommand = biquadFilterApplyDF1(&filter, rxData);
+        }
+
+        const float stick = stickTrace(timeUs, rampSlope, end);
+        if (stick > 0 && stick < end) {
+            rampErrorSum += fabsf(rcCommand - stick);
+            rampLoops++;
+        }
+        result.overshootMax = MAX(result.overshootMax, rcCommand - end);
+    }
+    result.rampErrorAvg = rampErrorSum / rampLoops;
+
+    return result;
+}
+
+TEST(RcPredictionUnittest, TestComparedToSmoothingFilter)
+{
+    const float rampSlope = 16;     // 0 to 400 in 25 frames, 100ms
+    const traceResult_t predicted = runStickTrace(true, rampSlope, 400);
+    const traceResult_t filtered = runStickTrace(false, rampSlope, 400);
+
+    // the filter lags behind a ramp by about a frame, the prediction follows it
+    EXPECT_NEAR(rampSlope, filtered.rampErrorAvg, rampSlope / 4);
+    EXPECT_LT(predicted.rampErrorAvg, rampSlope / 10);
+
+    // at the cost of overshooting the end of the ramp by up to one step, where the filter barely overshoots
+    EXPECT_GT(predicted.overshootMax, 0);
+    EXPECT_LE(predicted.overshootMax, rampSlope);
+    EXPECT_LT(filtered.overshootMax, predicted.overshootMax);
+}
@@ -44,6 +44,7 @@ extern "C" {
     rssiSource_e rssiSource;
 
     void crsfDataReceive(uint16_t c);
+    void crsfDataReceiveFrame(const uint8_t *frame, uint16_t length, void *data);
     uint8_t crsfFrameCRC(void);
     uint8_t crsfFrameStatus(void);
     uint16_t crsfReadRawRC(const rxRuntimeState_t *rxRuntimeState, uint8_t chan);
@@ -283,6 +284,81 @@ TEST(CrossFireTest, TestCrsfDataReceive)
     EXPECT_EQ(crc, crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE]);
 }
 
+// copies a captured frame, addressed to the flight controller and with a valid CRC
+static void makeFlightControllerFrame(uint8_t *frame, int capturedFrame)
+{
+    memcpy(frame, capturedData + capturedFrame * sizeof(crsfRcChannelsFrame_t), sizeof(crsfRcChannelsFrame_t));
+    frame[0] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    frame[sizeof(crsfRcChannelsFrame_t) - 1] = crc8_dvb_s2_buf(frame + 2, sizeof(crsfRcChannelsFrame_t) - 3);
+}
+
+TEST(CrossFireTest, TestCrsfDataReceiveFrame)
+{
+    const unsigned frameSize = sizeof(crsfRcChannelsFrame_t);
+    uint8_t frames[2 * frameSize];
+    makeFlightControllerFrame(frames, 0);
+    makeFlightControllerFrame(frames + frameSize, 1);
+
+    // a single frame
+    crsfFrameDone = false;
+    crsfDataReceiveFrame(frames, frameSize, NULL);
+    EXPECT_TRUE(crsfFrameDone);
+    EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus());
+    EXPECT_EQ(983, crsfChannelData[3]);
+
+    // back to back frames received before the line went idle, the last one is used
+    crsfDataReceiveFrame(frames, sizeof(frames), NULL);
+    EXPECT_TRUE(crsfFrameDone);
+    EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus());
+    EXPECT_EQ(981, crsfChannelData[3]);
+
+    // a frame with a bad CRC is ignored, the good one before it is not
+    frames[sizeof(frames) - 1] ^= 0xFF;
+    crsfDataReceiveFrame(frames, sizeof(frames), NULL);
+    EXPECT_TRUE(crsfFrameDone);
+    EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus());
+    EXPECT_EQ(983, crsfChannelData[3]);
+
+    // a truncated frame is dropped
+    crsfDataReceiveFrame(frames, frameSize - 1, NULL);
+    EXPECT_FALSE(crsfFrameDone);
+}
+
+TEST(CrossFireTest, TestSerialRxFrameMode)
+{
+    const unsigned frameSize = sizeof(crsfRcChannelsFrame_t);
+    uint8_t frame[frameSize];
+    makeFlightControllerFrame(frame, 1);
+
+    uint8_t frameBuffer[frameSize];
+    serialPort_t port;
+    memset(&port, 0, sizeof(port));
+    port.rxFrameCallback = crsfDataReceiveFrame;
+    port.rxFrameBuffer = frameBuffer;
+    port.rxFrameBufferSize = sizeof(frameBuffer);
+
+    // the bytes are handed on when the line goes idle
+    crsfFrameDone = false;
+    for (unsigned ii = 0; ii < frameSize; ++ii) {
+        serialRxFrameByte(&port, frame[ii]);
+    }
+    EXPECT_FALSE(crsfFrameDone);
+    serialRxFrameIdle(&port);
+    EXPECT_TRUE(crsfFrameDone);
+    EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus());
+    EXPECT_EQ(981, crsfChannelData[3]);
+    EXPECT_EQ(0, port.rxFrameLength);
+
+    // more bytes than fit in the buffer are dropped as a whole
+    for (unsigned ii = 0; ii < frameSize; ++ii) {
+        serialRxFrameByte(&port, frame[ii]);
+    }
+    serialRxFrameByte(&port, 0);
+    serialRxFrameIdle(&port);
+    EXPECT_FALSE(crsfFrameDone);
+    EXPECT_EQ(0, port.rxFrameLength);
+}
+
 // STUBS
 
 extern "C" {
@@ -0,0 +1,973 @@
+/*
+ * This file is part of Betaflight.
+ *
+ * Betaflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Betaflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Betaflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Common harness for the serial RX protocol parsers.
+ *
+ * Each parser is opened on a simulated serial port and fed synthetic frame streams
+ * through its receive callback, with its frame status function polled the way the
+ * RX task does. The simulated clock advances by one character time per byte, and a
+ * quiet gap after each frame raises the port idle callback, so the timing based frame
+ * sync of every parser is exercised.
+ *
+ * The streams are used to check decoding, to fuzz the parsers with noise and corrupted
+ * frames, and to report the parser throughput in bytes/s and CPU time per frame.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/crc.h"
+    #include "common/maths.h"
+    #include "common/utils.h"
+
+    #include "drivers/serial.h"
+    #include "drivers/time.h"
+
+    #include "io/serial.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/rx.h"
+
+    #include "rx/rx.h"
+    #include "rx/crsf.h"
+    #include "rx/fport.h"
+    #include "rx/ibus.h"
+    #include "rx/jetiexbus.h"
+    #include "rx/sbus.h"
+    #include "rx/spektrum.h"
+    #include "rx/srxl2.h"
+    #include "rx/sumd.h"
+    #include "rx/sumh.h"
+    #include "rx/xbus.h"
+
+    #include "telemetry/smartport.h"
+
+    rssiSource_e rssiSource;
+
+    PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define RX_PARSER_MAX_FRAME_SIZE    96
+#define RX_PARSER_MAX_CHANNELS      16
+#define RX_PARSER_BENCHMARK_FRAMES  10000
+#define RX_PARSER_POLLS_PER_GAP     3
+
+#define JETIEXBUS_CHANNEL_FRAME_SIZE (EXBUS_HEADER_LEN + 16 * 2 + EXBUS_CRC_LEN)
+
+/*
+ * Simulated serial port
+ */
+
+static uint32_t simTimeUs;
+static uint32_t rxByteTimeUs;
+
+static serialPort_t rxPort;
+static serialPortConfig_t rxPortConfig;
+
+// idle-line frame mode, only offered to parsers when enabled
+static bool rxFrameModeEnabled;
+
+static void rxPortWrite(serialPort_t *, uint8_t) {}
+static uint32_t rxPortTotalRxWaiting(const serialPort_t *) { return 0; }
+static uint32_t rxPortTotalTxFree(const serialPort_t *) { return 256; }
+static uint8_t rxPortRead(serialPort_t *) { return 0; }
+static bool rxPortIsTransmitBufferEmpty(const serialPort_t *) { return true; }
+static void rxPortSetMode(serialPort_t *, portMode_e) {}
+static void rxPortWriteBuf(serialPort_t *, const void *, int) {}
+
+static void rxPortSetBaudRate(serialPort_t *instance, uint32_t baudRate)
+{
+    instance->baudRate = baudRate;
+    rxByteTimeUs = MAX(10 * 1000000 / baudRate, 1U);
+}
+
+// as uartSetRxFrameCb()
+static void rxPortSetRxFrameCb(serialPort_t *instance, serialReceiveFrameCallbackPtr cb, uint8_t *frameBuffer, uint16_t frameBufferSize)
+{
+    instance->rxFrameBuffer = frameBuffer;
+    instance->rxFrameBufferSize = frameBufferSize;
+    instance->rxFrameLength = 0;
+    instance->rxFrameCallback = cb;
+}
+
+static const struct serialPortVTable rxPortVTable[] = {
+    {
+        .serialWrite = rxPortWrite,
+        .serialTotalRxWaiting = rxPortTotalRxWaiting,
+        .serialTotalTxFree = rxPortTotalTxFree,
+        .serialRead = rxPortRead,
+        .serialSetBaudRate = rxPortSetBaudRate,
+        .isSerialTransmitBufferEmpty = rxPortIsTransmitBufferEmpty,
+        .setMode = rxPortSetMode,
+        .setCtrlLineStateCb = NULL,
+        .setBaudRateCb = NULL,
+        .setRxFrameCb = NULL,
+        .writeBuf = rxPortWriteBuf,
+        .beginWrite = NULL,
+        .endWrite = NULL,
+    },
+    // a UART that raises an idle line interrupt
+    {
+        .serialWrite = rxPortWrite,
+        .serialTotalRxWaiting = rxPortTotalRxWaiting,
+        .serialTotalTxFree = rxPortTotalTxFree,
+        .serialRead = rxPortRead,
+        .serialSetBaudRate = rxPortSetBaudRate,
+        .isSerialTransmitBufferEmpty = rxPortIsTransmitBufferEmpty,
+        .setMode = rxPortSetMode,
+        .setCtrlLineStateCb = NULL,
+        .setBaudRateCb = NULL,
+        .setRxFrameCb = rxPortSetRxFrameCb,
+        .writeBuf = rxPortWriteBuf,
+        .beginWrite = NULL,
+        .endWrite = NULL,
+    },
+};
+
+static void rxPortReset(void)
+{
+    memset(&rxPort, 0, sizeof(rxPort));
+    rxPortConfig.functionMask = FUNCTION_RX_SERIAL;
+    rxPortConfig.identifier = SERIAL_PORT_USART1;
+    rxFrameModeEnabled = false;
+}
+
+// the UART receive interrupt, frame mode uses the same helper as the UART driver
+static void rxPortReceive(uint8_t c)
+{
+    simTimeUs += rxByteTimeUs;
+    if (rxPort.rxFrameCallback) {
+        serialRxFrameByte(&rxPort, c);
+    } else {
+        rxPort.rxCallback(c, rxPort.rxCallbackData);
+    }
+}
+
+// line quiet for gapUs, the UART raises its idle interrupt
+static void rxPortIdle(uint32_t gapUs)
+{
+    simTimeUs += gapUs;
+    if (rxPort.rxFrameCallback) {
+        serialRxFrameIdle(&rxPort);
+    }
+    if (rxPort.idleCallback) {
+        rxPort.idleCallback();
+    }
+}
+
+/*
+ * Frame builders, each returns the frame length
+ */
+
+typedef struct rxParser_s {
+    const char *name;
+    SerialRXType provider;
+    bool (*init)(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState);
+    int (*buildFrame)(uint8_t *frame, const uint16_t *channelsUs);
+    int (*stuffFrame)(uint8_t *wire, const uint8_t *frame, int length); // NULL if sent as is
+    uint8_t channelCount;   // channels carried by each frame
+    uint8_t payloadStart;   // channel data bytes, any bit flip in these must be caught by the frame check
+    uint8_t payloadLength;
+    bool checked;           // frame has a checksum or CRC
+    uint16_t frameGapUs;    // quiet time after each frame, enough for the parser to resync
+} rxParser_t;
+
+// 11 bit channels packed LSB first, as used by CRSF and SBUS
+static void packChannels11(uint8_t *out, const uint16_t *values, int count)
+{
+    uint32_t bits = 0;
+    int bitCount = 0;
+    for (int ii = 0; ii < count; ++ii) {
+        bits |= (uint32_t)values[ii] << bitCount;
+        bitCount += 11;
+        while (bitCount >= 8) {
+            *out++ = bits;
+            bits >>= 8;
+            bitCount -= 8;
+        }
+    }
+    if (bitCount) {
+        *out = bits;
+    }
+}
+
+static void putBigEndian16(uint8_t *out, uint16_t value)
+{
+    out[0] = value >> 8;
+    out[1] = value;
+}
+
+static void putLittleEndian16(uint8_t *out, uint16_t value)
+{
+    out[0] = value;
+    out[1] = value >> 8;
+}
+
+static int buildCrsfFrame(uint8_t *frame, const uint16_t *channelsUs)
+{
+    uint16_t values[RX_PARSER_MAX_CHANNELS];
+    for (int ii = 0; ii < 16; ++ii) {
+        // inverse of crsfReadRawRC()
+        values[ii] = ceil((channelsUs[ii] - 881) / 0.62477120195241);
+    }
+    frame[0] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    frame[1] = CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC;
+    frame[2] = CRSF_FRAMETYPE_RC_CHANNELS_PACKED;
+    packChannels11(&frame[3], values, 16);
+    frame[25] = crc8_dvb_s2_update(0, &frame[2], CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + 1);
+    return 26;
+}
+
+static void packSbusChannels(uint8_t *out, const uint16_t *channelsUs)
+{
+    uint16_t values[RX_PARSER_MAX_CHANNELS];
+    for (int ii = 0; ii < 16; ++ii) {
+        // inverse of sbusChannelsReadRawRC()
+        values[ii] = ((channelsUs[ii] - 880) * 8 + 4) / 5;
+    }
+    packChannels11(out, values, 16);
+    out[22] = 0; // flags
+}
+
+static int buildSbusFrame(uint8_t *frame, const uint16_t *channelsUs)
+{
+    frame[0] = 0x0F;
+    packSbusChannels(&frame[1], channelsUs);
+    frame[24] = 0x00;
+    return 25;
+}
+
+// FPort frame without the markers: length, type, payload, checksum
+static int buildFportFrame(uint8_t *frame, const uint16_t *channelsUs)
+{
+    frame[0] = 25;
+    frame[1] = 0x00; // control frame
+    packSbusChannels(&frame[2], channelsUs);
+    frame[25] = 100; // rssi
+    for (int checksum = 0; checksum < 256; ++checksum) {
+        frame[26] = checksum;
+        uint16_t sum = 0;
+        for (int ii = 0; ii < 27; ++ii) {
+            sum += frame[ii];
+        }
+        if ((sum & 0xFF) + (sum >> 8) == 0xFF) {
+            break;
+        }
+    }
+    return 27;
+}
+
+static int stuffFportFrame(uint8_t *wire, const uint8_t *frame, int length)
+{
+    int wireLength = 0;
+    wire[wireLength++] = 0x7E;
+    for (int ii = 0; ii < length; ++ii) {
+        if (frame[ii] == 0x7E || frame[ii] == 0x7D) {
+            wire[wireLength++] = 0x7D;
+            wire[wireLength++] = frame[ii] ^ 0x20;
+        } else {
+            wire[wireLength++] = frame[ii];
+        }
+    }
+    wire[wireLength++] = 0x7E;
+    return wireLength;
+}
+
+static int buildIbusFrame(uint8_t *frame, const uint16_t *channelsUs)
+{
+    frame[0] = 0x20;
+    frame[1] = 0x40;
+    for (int ii = 0; ii < 14; ++ii) {
+        putLittleEndian16(&frame[2 + 2 * ii], channelsUs[ii]);
+    }
+    uint16_t checksum = 0xFFFF;
+    for (int ii = 0; ii < 30; ++ii) {
+        checksum -= frame[ii];
+    }
+    putLittleEndian16(&frame[30], checksum);
+    return 32;
+}
+
+static int buildSumdFrame(uint8_t *frame, const uint16_t *channelsUs)
+{
+    frame[0] = 0xA8;
+    frame[1] = 0x01;
+    frame[2] = 16;
+    for (int ii = 0; ii < 16; ++ii) {
+        putBigEndian16(&frame[3 + 2 * ii], channelsUs[ii] * 8);
+    }
+    putBigEndian16(&frame[35], crc16_ccitt_update(0, frame, 35));
+    return 37;
+}
+
+// 2048 mode, 7 channels per frame
+static int buildSpektrumFrame(uint8_t *frame, const uint16_t *channelsUs)
+{
+    frame[0] = 0; // fades
+    frame[1] = SPEKTRUM_DSMX_11;
+    for (int ii = 0; ii < 7; ++ii) {
+        const uint16_t value = (channelsUs[ii] - 988) * 2;
+        frame[2 + 2 * ii] = (ii << 3) | ((value >> 8) & 0x07);
+        frame[3 + 2 * ii] = value;
+    }
+    return 16;
+}
+
+static int buildSrxl2Frame(uint8_t *frame, const uint16_t *channelsUs)
+{
+    const int length = 3 + 2 + 7 + 2 * 16 + 2;
+    frame[0] = 0xA6;
+    frame[1] = 0xCD; // control data
+    frame[2] = length;
+    frame[3] = 0x00; // channel data
+    frame[4] = 0x00; // no telemetry reply
+    frame[5] = 100;  // rssi
+    putLittleEndian16(&frame[6], 0); // frame losses
+    putLittleEndian16(&frame[8], 0xFFFF); // channel mask
+    putLittleEndian16(&frame[10], 0);
+    for (int ii = 0; ii < 16; ++ii) {
+        putLittleEndian16(&frame[12 + 2 * ii], ((channelsUs[ii] - 988) * 2) << 5);
+    }
+    putBigEndian16(&frame[length - 2], crc16_ccitt_update(0, frame, length - 2));
+    return length;
+}
+
+static int buildJetiExBusFrame(uint8_t *frame, const uint16_t *channelsUs)
+{
+    frame[0] = 0x3E;
+    frame[1] = 0x03; // channel data, no telemetry request
+    frame[2] = JETIEXBUS_CHANNEL_FRAME_SIZE;
+    frame[3] = 0x00; // packet id
+    frame[4] = 0x31; // channel data identifier
+    frame[5] = 32;
+    for (int ii = 0; ii < 16; ++ii) {
+        putLittleEndian16(&frame[EXBUS_HEADER_LEN + 2 * ii], channelsUs[ii] * 8);
+    }
+    const int crcOffset = JETIEXBUS_CHANNEL_FRAME_SIZE - EXBUS_CRC_LEN;
+    putLittleEndian16(&frame[crcOffset], jetiExBusCalcCRC16(frame, crcOffset));
+    return JETIEXBUS_CHANNEL_FRAME_SIZE;
+}
+
+// 8 channels, the frame has no check
+static int buildSumhFrame(uint8_t *frame, const uint16_t *channelsUs)
+{
+    frame[0] = 0xA8;
+    frame[1] = 0x01;
+    frame[2] = 8;
+    for (int ii = 0; ii < 8; ++ii) {
+        // inverse of the conversion in sumhFrameStatus()
+        putBigEndian16(&frame[3 + 2 * ii], ((channelsUs[ii] + 375) * 32 + 4) / 5);
+    }
+    frame[19] = 0;
+    frame[20] = 0;
+    return 21;
+}
+
+// mode B, 12 channels
+static int buildXbusFrame(uint8_t *frame, const uint16_t *channelsUs)
+{
+    frame[0] = 0xA1;
+    for (int ii = 0; ii < 12; ++ii) {
+        // inverse of XBUS_CONVERT_TO_USEC()
+        putBigEndian16(&frame[1 + 2 * ii], ((channelsUs[ii] - 800) * 4096 + 1399) / 1400);
+    }
+    putBigEndian16(&frame[25], crc16_ccitt_update(0, frame, 25));
+    return 27;
+}
+
+// CRSF with whole frames delivered at line idle
+static bool crsfFrameModeInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
+{
+    rxFrameModeEnabled = true;
+    return crsfRxInit(rxConfig, rxRuntimeState);
+}
+
+static const rxParser_t rxParsers[] = {
+    { "crsf",      SERIALRX_CRSF,         crsfRxInit,        buildCrsfFrame,      NULL,            16, 3,  22, true,  2000 },
+    { "crsf-idle", SERIALRX_CRSF,         crsfFrameModeInit, buildCrsfFrame,      NULL,            16, 3,  22, true,  2000 },
+    { "sbus",      SERIALRX_SBUS,         sbusInit,          buildSbusFrame,      NULL,            16, 1,  22, false, 4000 },
+    { "fport",     SERIALRX_FPORT,        fportRxInit,       buildFportFrame,     stuffFportFrame, 16, 2,  22, true,  4000 },
+    { "ibus",      SERIALRX_IBUS,         ibusInit,          buildIbusFrame,      NULL,            14, 2,  28, true,  1000 },
+    { "sumd",      SERIALRX_SUMD,         sumdInit,          buildSumdFrame,      NULL,            16, 3,  32, true,  5000 },
+    { "spektrum",  SERIALRX_SPEKTRUM2048, spektrumInit,      buildSpektrumFrame,  NULL,            7,  2,  14, false, 6000 },
+    { "srxl2",     SERIALRX_SRXL2,        srxl2RxInit,       buildSrxl2Frame,     NULL,            16, 12, 32, true,  1000 },
+    { "jetiexbus", SERIALRX_JETIEXBUS,    jetiExBusInit,     buildJetiExBusFrame, NULL,            16, 6,  32, true,  1500 },
+    { "sumh",      SERIALRX_SUMH,         sumhInit,          buildSumhFrame,      NULL,            8,  3,  16, false, 6000 },
+    { "xbus",      SERIALRX_XBUS_MODE_B,  xBusInit,          buildXbusFrame,      NULL,            12, 1,  24, true,  9000 },
+};
+
+static const rxParser_t *findRxParser(const char *name)
+{
+    for (const rxParser_t &parser : rxParsers) {
+        if (strcmp(parser.name, name) == 0) {
+            return &parser;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Harness
+ */
+
+// deterministic pseudo random numbers, so failures are reproducible
+static uint32_t randomSeed;
+
+static uint32_t randomNext(void)
+{
+    randomSeed = randomSeed * 1103515245 + 12345;
+    return randomSeed >> 8;
+}
+
+static uint16_t frameChannelUs(unsigned frameIndex, unsigned channel)
+{
+    return 1000 + (frameIndex * 7 + channel * 61) % 1000;
+}
+
+class RxParserHarness
+{
+public:
+    const rxParser_t *parser;
+    rxRuntimeState_t rxRuntimeState;
+    uint16_t channelsUs[RX_PARSER_MAX_CHANNELS];
+    unsigned completeFrames;
+
+    RxParserHarness(const rxParser_t *p) : parser(p), completeFrames(0)
+    {
+        rxPortReset();
+        memset(&rxRuntimeState, 0, sizeof(rxRuntimeState));
+        rxRuntimeState.serialrxProvider = parser->provider;
+        rxConfig_t config;
+        memset(&config, 0, sizeof(config));
+        config.midrc = 1500;
+        EXPECT_TRUE(parser->init(&config, &rxRuntimeState));
+        EXPECT_TRUE(rxPort.rxCallback != NULL);
+        // start from a quiet line
+        rxPortIdle(10000);
+        pollFrameStatus();
+        // the parser state is static, drop a frame time left over from an earlier test
+        if (rxRuntimeState.rcFrameTimeUsFn) {
+            rxRuntimeState.rcFrameTimeUsFn();
+        }
+    }
+
+    // builds the wire form of frame frameIndex, returns its length
+    int buildWireFrame(uint8_t *wire, uint8_t *frame, unsigned frameIndex)
+    {
+        for (int ii = 0; ii < RX_PARSER_MAX_CHANNELS; ++ii) {
+            channelsUs[ii] = frameChannelUs(frameIndex, ii);
+        }
+        const int length = parser->buildFrame(frame, channelsUs);
+        return stuff(wire, frame, length);
+    }
+
+    int stuff(uint8_t *wire, const uint8_t *frame, int length)
+    {
+        if (parser->stuffFrame) {
+            return parser->stuffFrame(wire, frame, length);
+        }
+        memcpy(wire, frame, length);
+        return length;
+    }
+
+    // polls the parser like the RX task, returns true if a frame with new channel data was complete
+    bool pollFrameStatus(void)
+    {
+        const uint8_t frameStatus = rxRuntimeState.rcFrameStatusFn(&rxRuntimeState);
+        if ((frameStatus & RX_FRAME_PROCESSING_REQUIRED) && rxRuntimeState.rcProcessFrameFn) {
+            rxRuntimeState.rcProcessFrameFn(&rxRuntimeState);
+        }
+        if (frameStatus & RX_FRAME_COMPLETE) {
+            ++completeFrames;
+            return true;
+        }
+        return false;
+    }
+
+    bool sendWire(const uint8_t *wire, int length)
+    {
+        for (int ii = 0; ii < length; ++ii) {
+            rxPortReceive(wire[ii]);
+        }
+        return endFrame();
+    }
+
+    // quiet gap after a frame, the RX task polls several times meanwhile and
+    // parsers that queue frames (FPort) hand over one per poll
+    bool endFrame(void)
+    {
+        rxPortIdle(parser->frameGapUs);
+        bool complete = false;
+        for (int ii = 0; ii < RX_PARSER_POLLS_PER_GAP; ++ii) {
+            complete |= pollFrameStatus();
+        }
+        return complete;
+    }
+
+    void expectChannels(const uint16_t *expectedUs)
+    {
+        for (int ii = 0; ii < parser->channelCount; ++ii) {
+            // the CRSF scaling is not exactly invertible
+            EXPECT_NEAR(expectedUs[ii], rxRuntimeState.rcReadRawFn(&rxRuntimeState, ii), 1) << parser->name << " channel " << ii;
+        }
+    }
+
+    void readChannels(uint16_t *channelsUs)
+    {
+        for (int ii = 0; ii < parser->channelCount; ++ii) {
+            channelsUs[ii] = rxRuntimeState.rcReadRawFn(&rxRuntimeState, ii);
+        }
+    }
+
+    // reads every channel the parser reports, as the RX task would after noise
+    void readAllChannels(void)
+    {
+        for (int ii = 0; ii < rxRuntimeState.channelCount; ++ii) {
+            rxRuntimeState.rcReadRawFn(&rxRuntimeState, ii);
+        }
+    }
+
+    // valid frames must be decoded again after a quiet gap, whatever came before
+    void expectRecovery(unsigned frameIndex)
+    {
+        uint8_t frame[RX_PARSER_MAX_FRAME_SIZE];
+        uint8_t wire[2 * RX_PARSER_MAX_FRAME_SIZE];
+        rxPortIdle(parser->frameGapUs * 2);
+        pollFrameStatus();
+        for (int ii = 0; ii < 3; ++ii) {
+            const int length = buildWireFrame(wire, frame, frameIndex + ii);
+            EXPECT_TRUE(sendWire(wire, length)) << parser->name << " did not recover";
+            expectChannels(channelsUs);
+        }
+    }
+};
+
+TEST(RxParsersUnittest, TestValidFrames)
+{
+    for (const rxParser_t &parser : rxParsers) {
+        RxParserHarness harness(&parser);
+        uint8_t frame[RX_PARSER_MAX_FRAME_SIZE];
+        uint8_t wire[2 * RX_PARSER_MAX_FRAME_SIZE];
+
+        for (unsigned frameIndex = 0; frameIndex < 200; ++frameIndex) {
+            const int length = harness.buildWireFrame(wire, frame, frameIndex);
+            // nothing is reported before the frame is complete
+            for (int ii = 0; ii < length - 1; ++ii) {
+                rxPortReceive(wire[ii]);
+                EXPECT_FALSE(harness.pollFrameStatus()) << parser.name << " frame " << frameIndex << " byte " << ii;
+            }
+            EXPECT_TRUE(harness.sendWire(&wire[length - 1], 1)) << parser.name << " frame " << frameIndex;
+            harness.expectChannels(harness.channelsUs);
+        }
+        EXPECT_EQ(200U, harness.completeFrames) << parser.name;
+    }
+}
+
+TEST(RxParsersUnittest, TestFuzzNoise)
+{
+    for (const rxParser_t &parser : rxParsers) {
+        RxParserHarness harness(&parser);
+        randomSeed = 1234;
+
+        for (int ii = 0; ii < 50000; ++ii) {
+            const uint32_t random = randomNext();
+            rxPortReceive(random);
+            if ((random & 0x3F00) == 0) {
+                rxPortIdle((random >> 16) % (2 * parser.frameGapUs));
+            }
+            harness.pollFrameStatus();
+            harness.readAllChannels();
+        }
+
+        harness.expectRecovery(0);
+    }
+}
+
+TEST(RxParsersUnittest, TestFuzzCorruptFrames)
+{
+    enum { CORRUPT_PAYLOAD_BIT, CORRUPT_ANY_BIT, CORRUPT_DROP_BYTE, CORRUPT_INSERT_BYTE, CORRUPT_TRUNCATE, CORRUPT_COUNT };
+
+    for (const rxParser_t &parser : rxParsers) {
+        RxParserHarness harness(&parser);
+        uint8_t frame[RX_PARSER_MAX_FRAME_SIZE];
+        uint8_t wire[2 * RX_PARSER_MAX_FRAME_SIZE];
+        uint16_t receivedUs[RX_PARSER_MAX_CHANNELS];
+        randomSeed = 5678;
+
+        int length = harness.buildWireFrame(wire, frame, 0);
+        EXPECT_TRUE(harness.sendWire(wire, length));
+        harness.readChannels(receivedUs);
+
+        unsigned rejectedFrames = 0;
+        for (unsigned frameIndex = 1; frameIndex < 2000; ++frameIndex) {
+            length = harness.buildWireFrame(wire, frame, frameIndex);
+            const uint32_t random = randomNext();
+            if (random & 1) {
+                // intact frames are always received, whatever the previous frame was
+                EXPECT_TRUE(harness.sendWire(wire, length)) << parser.name << " frame " << frameIndex;
+                harness.expectChannels(harness.channelsUs);
+                harness.readChannels(receivedUs);
+                continue;
+            }
+
+            const int frameLength = parser.buildFrame(frame, harness.channelsUs);
+            const int position = (random >> 8) % length;
+            switch ((random >> 1) % CORRUPT_COUNT) {
+            case CORRUPT_PAYLOAD_BIT: {
+                // a single bit error in the channel data is always caught by the frame check
+                frame[parser.payloadStart + (random >> 8) % parser.payloadLength] ^= 1 << ((random >> 4) & 7);
+                length = harness.stuff(wire, frame, frameLength);
+                const bool complete = harness.sendWire(wire, length);
+                if (parser.checked) {
+                    EXPECT_FALSE(complete) << parser.name << " accepted a corrupt frame " << frameIndex;
+                    harness.expectChannels(receivedUs);
+                    rejectedFrames += !complete;
+                }
+                continue;
+            }
+            case CORRUPT_ANY_BIT:
+                wire[position] ^= 1 << ((random >> 4) & 7);
+                break;
+            case CORRUPT_DROP_BYTE:
+                memmove(&wire[position], &wire[position + 1], length - position - 1);
+                --length;
+                break;
+            case CORRUPT_INSERT_BYTE:
+                memmove(&wire[position + 1], &wire[position], length - position);
+                wire[position] = random >> 16;
+                ++length;
+                break;
+            case CORRUPT_TRUNCATE:
+                length = position;
+                break;
+            }
+            // framing errors are not always caught, an 8 bit check passes 1 in 256 misaligned
+            // frames, and bytes outside the frame may be skipped, so only robustness is checked
+            harness.sendWire(wire, length);
+            harness.readAllChannels();
+            harness.readChannels(receivedUs);
+        }
+
+        if (parser.checked) {
+            EXPECT_LT(0U, rejectedFrames) << parser.name;
+        }
+        harness.expectRecovery(3000);
+    }
+}
+
+TEST(RxParsersUnittest, TestSumdOversizedChannelCount)
+{
+    RxParserHarness harness(findRxParser("sumd"));
+    uint8_t frame[RX_PARSER_MAX_FRAME_SIZE];
+    uint8_t wire[2 * RX_PARSER_MAX_FRAME_SIZE];
+
+    // more channels than the frame buffer holds, the header is dropped at once
+    const uint8_t header[] = { 0xA8, 0x01, 40 };
+    for (unsigned ii = 0; ii < sizeof(header); ++ii) {
+        rxPortReceive(header[ii]);
+    }
+    const int length = harness.buildWireFrame(wire, frame, 1);
+    EXPECT_TRUE(harness.sendWire(wire, length));
+    harness.expectChannels(harness.channelsUs);
+}
+
+TEST(RxParsersUnittest, TestJetiExBusShortLength)
+{
+    RxParserHarness harness(findRxParser("jetiexbus"));
+    uint8_t frame[RX_PARSER_MAX_FRAME_SIZE];
+    uint8_t wire[2 * RX_PARSER_MAX_FRAME_SIZE];
+
+    // a length shorter than the header is dropped at once, rather than running past the frame buffer
+    const uint8_t header[] = { 0x3E, 0x03, 0x02, 0x00, 0x31, 0x00 };
+    for (unsigned ii = 0; ii < sizeof(header); ++ii) {
+        rxPortReceive(header[ii]);
+    }
+    const int length = harness.buildWireFrame(wire, frame, 1);
+    EXPECT_TRUE(harness.sendWire(wire, length));
+    harness.expectChannels(harness.channelsUs);
+}
+
+TEST(RxParsersUnittest, TestFrameModeOverflow)
+{
+    RxParserHarness harness(findRxParser("crsf-idle"));
+    uint8_t frame[RX_PARSER_MAX_FRAME_SIZE];
+    uint8_t wire[2 * RX_PARSER_MAX_FRAME_SIZE];
+
+    // back to back frames that overflow the frame buffer before the line goes idle are dropped as a whole
+    const int length = harness.buildWireFrame(wire, frame, 1);
+    ASSERT_LT(0, rxPort.rxFrameBufferSize);
+    for (int sent = 0; sent <= rxPort.rxFrameBufferSize; sent += length) {
+        for (int ii = 0; ii < length; ++ii) {
+            rxPortReceive(wire[ii]);
+        }
+    }
+    EXPECT_FALSE(harness.endFrame());
+    EXPECT_EQ(0, rxPort.rxFrameLength);
+
+    harness.expectRecovery(2);
+}
+
+TEST(RxParsersUnittest, TestFrameTimeOfLastByte)
+{
+    for (const char *name : { "fport", "jetiexbus", "sumh", "xbus" }) {
+        RxParserHarness harness(findRxParser(name));
+        uint8_t frame[RX_PARSER_MAX_FRAME_SIZE];
+        uint8_t wire[2 * RX_PARSER_MAX_FRAME_SIZE];
+        ASSERT_TRUE(harness.rxRuntimeState.rcFrameTimeUsFn != NULL) << name;
+
+        for (unsigned frameIndex = 0; frameIndex < 20; ++frameIndex) {
+            const int length = harness.buildWireFrame(wire, frame, frameIndex);
+            for (int ii = 0; ii < length - 1; ++ii) {
+                rxPortReceive(wire[ii]);
+            }
+            // no time before the frame is complete
+            EXPECT_FALSE(harness.pollFrameStatus()) << name << " frame " << frameIndex;
+            EXPECT_EQ(0U, harness.rxRuntimeState.rcFrameTimeUsFn()) << name << " frame " << frameIndex;
+
+            // the receive interrupt of the last byte, not the later RX task polls
+            rxPortReceive(wire[length - 1]);
+            const timeUs_t lastByteUs = simTimeUs;
+            EXPECT_TRUE(harness.endFrame()) << name << " frame " << frameIndex;
+            EXPECT_EQ(lastByteUs, harness.rxRuntimeState.rcFrameTimeUsFn()) << name << " frame " << frameIndex;
+            // and only once
+            EXPECT_EQ(0U, harness.rxRuntimeState.rcFrameTimeUsFn()) << name << " frame " << frameIndex;
+        }
+    }
+}
+
+TEST(RxParsersUnittest, TestFrameTimeOfBadFrame)
+{
+    for (const char *name : { "fport", "jetiexbus", "sumh", "xbus" }) {
+        const rxParser_t *parser = findRxParser(name);
+        RxParserHarness harness(parser);
+        uint8_t frame[RX_PARSER_MAX_FRAME_SIZE];
+        uint8_t wire[2 * RX_PARSER_MAX_FRAME_SIZE];
+
+        int length = harness.buildWireFrame(wire, frame, 1);
+        EXPECT_TRUE(harness.sendWire(wire, length)) << name;
+        EXPECT_NE(0U, harness.rxRuntimeState.rcFrameTimeUsFn()) << name;
+
+        // a frame that fails its check, or for SUMH its header, has no time
+        harness.buildWireFrame(wire, frame, 2);
+        const int frameLength = parser->buildFrame(frame, harness.channelsUs);
+        if (parser->checked) {
+            frame[parser->payloadStart] ^= 0x01;
+        } else {
+            frame[0] ^= 0x01;
+        }
+        length = harness.stuff(wire, frame, frameLength);
+        EXPECT_FALSE(harness.sendWire(wire, length)) << name;
+        EXPECT_EQ(0U, harness.rxRuntimeState.rcFrameTimeUsFn()) << name;
+    }
+}
+
+TEST(RxParsersUnittest, TestFportFrameTimeQueued)
+{
+    RxParserHarness harness(findRxParser("fport"));
+    uint8_t frame[RX_PARSER_MAX_FRAME_SIZE];
+    uint8_t wire[2 * RX_PARSER_MAX_FRAME_SIZE];
+
+    // frames queued before the RX task runs are handed over one per poll, each with the time of its closing marker
+    timeUs_t frameEndUs[2];
+    for (int ii = 0; ii < 2; ++ii) {
+        const int length = harness.buildWireFrame(wire, frame, ii);
+        for (int jj = 0; jj < length; ++jj) {
+            rxPortReceive(wire[jj]);
+        }
+        frameEndUs[ii] = simTimeUs;
+    }
+    for (int ii = 0; ii < 2; ++ii) {
+        EXPECT_TRUE(harness.pollFrameStatus());
+        EXPECT_EQ(frameEndUs[ii], harness.rxRuntimeState.rcFrameTimeUsFn());
+    }
+    EXPECT_FALSE(harness.pollFrameStatus());
+    EXPECT_EQ(0U, harness.rxRuntimeState.rcFrameTimeUsFn());
+
+    // a corrupt frame queued behind a valid one has no time of its own
+    int length = harness.buildWireFrame(wire, frame, 2);
+    for (int jj = 0; jj < length; ++jj) {
+        rxPortReceive(wire[jj]);
+    }
+    const timeUs_t validFrameEndUs = simTimeUs;
+    harness.buildWireFrame(wire, frame, 3);
+    const int frameLength = buildFportFrame(frame, harness.channelsUs);
+    frame[2] ^= 0x01;
+    length = harness.stuff(wire, frame, frameLength);
+    for (int jj = 0; jj < length; ++jj) {
+        rxPortReceive(wire[jj]);
+    }
+    EXPECT_TRUE(harness.pollFrameStatus());
+    EXPECT_EQ(validFrameEndUs, harness.rxRuntimeState.rcFrameTimeUsFn());
+    EXPECT_FALSE(harness.pollFrameStatus());
+    EXPECT_EQ(0U, harness.rxRuntimeState.rcFrameTimeUsFn());
+}
+
+// EX telemetry request, received into its own buffer
+static int buildJetiExBusRequestFrame(uint8_t *frame)
+{
+    frame[0] = 0x3D;
+    frame[1] = 0x01;
+    frame[2] = 8;
+    frame[3] = 0x00; // packet id
+    frame[4] = 0x3A;
+    frame[5] = 0x00;
+    putLittleEndian16(&frame[6], jetiExBusCalcCRC16(frame, 6));
+    return 8;
+}
+
+TEST(RxParsersUnittest, TestJetiExBusFrameTimeOfChannelFrame)
+{
+    const rxParser_t *parser = findRxParser("jetiexbus");
+    RxParserHarness harness(parser);
+    uint8_t frame[RX_PARSER_MAX_FRAME_SIZE];
+    uint8_t wire[2 * RX_PARSER_MAX_FRAME_SIZE];
+    uint8_t request[EXBUS_MAX_REQUEST_FRAME_SIZE];
+    const int requestLength = buildJetiExBusRequestFrame(request);
+
+    // a request closely following the channel frame, before the RX task runs, does not move the frame time
+    const int length = harness.buildWireFrame(wire, frame, 1);
+    for (int ii = 0; ii < length; ++ii) {
+        rxPortReceive(wire[ii]);
+    }
+    const timeUs_t channelFrameEndUs = simTimeUs;
+    rxPortIdle(parser->frameGapUs / 3);
+    for (int ii = 0; ii < requestLength; ++ii) {
+        rxPortReceive(request[ii]);
+    }
+    EXPECT_TRUE(harness.endFrame());
+    EXPECT_EQ(channelFrameEndUs, harness.rxRuntimeState.rcFrameTimeUsFn());
+    harness.expectChannels(harness.channelsUs);
+
+    // and a request on its own has no frame time
+    EXPECT_FALSE(harness.sendWire(request, requestLength));
+    EXPECT_EQ(0U, harness.rxRuntimeState.rcFrameTimeUsFn());
+}
+
+static uint64_t cpuTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+TEST(RxParsersUnittest, TestThroughput)
+{
+    for (const rxParser_t &parser : rxParsers) {
+        RxParserHarness harness(&parser);
+
+        // build the stream up front so only the parser is timed
+        std::vector<uint8_t> stream;
+        std::vector<uint8_t> frameLengths;
+        uint8_t frame[RX_PARSER_MAX_FRAME_SIZE];
+        uint8_t wire[2 * RX_PARSER_MAX_FRAME_SIZE];
+        for (unsigned frameIndex = 0; frameIndex < RX_PARSER_BENCHMARK_FRAMES; ++frameIndex) {
+            const int length = harness.buildWireFrame(wire, frame, frameIndex);
+            stream.insert(stream.end(), wire, wire + length);
+            frameLengths.push_back(length);
+        }
+
+        const uint64_t startNs = cpuTimeNs();
+        const uint8_t *byte = stream.data();
+        for (const uint8_t length : frameLengths) {
+            for (int ii = 0; ii < length; ++ii) {
+                rxPortReceive(*byte++);
+            }
+            harness.endFrame();
+        }
+        const uint64_t elapsedNs = MAX(cpuTimeNs() - startNs, 1ULL);
+
+        EXPECT_EQ((unsigned)RX_PARSER_BENCHMARK_FRAMES, harness.completeFrames) << parser.name;
+        harness.expectChannels(harness.channelsUs);
+
+        printf("rx_parsers %-9s %2u byte frames %8.2f Mbytes/s %7.1f ns per frame\n",
+            parser.name, frameLengths[0], stream.size() * 1000.0 / elapsedNs, (double)elapsedNs / RX_PARSER_BENCHMARK_FRAMES);
+    }
+}
+
+// STUBS
+
+extern "C" {
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint8_t debugMode;
+
+    serialPort_t *telemetrySharedPort = NULL;
+
+    uint32_t micros(void) { return simTimeUs; }
+    uint32_t microsISR(void) { return simTimeUs; }
+    uint32_t millis(void) { return simTimeUs / 1000; }
+
+    const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function)
+    {
+        EXPECT_EQ(FUNCTION_RX_SERIAL, function);
+        return &rxPortConfig;
+    }
+
+    serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr callback,
+        void *callbackData, uint32_t baudRate, portMode_e mode, portOptions_e options)
+    {
+        rxPort.vTable = &rxPortVTable[rxFrameModeEnabled ? 1 : 0];
+        rxPort.mode = mode;
+        rxPort.options = options;
+        rxPort.rxCallback = callback;
+        rxPort.rxCallbackData = callbackData;
+        rxPortSetBaudRate(&rxPort, baudRate);
+        return &rxPort;
+    }
+
+    bool telemetryCheckRxPortShared(const serialPortConfig_t *, const SerialRXType) { return false; }
+    bool isSerialPortShared(const serialPortConfig_t *, uint16_t, serialPortFunction_e) { return false; }
+
+    // telemetry/ibus_shared.c
+    bool isChecksumOkIa6b(const uint8_t *ibusPacket, const uint8_t length)
+    {
+        uint16_t checksum = 0xFFFF;
+        for (unsigned ii = 0; ii < (unsigned)length - 2; ++ii) {
+            checksum -= ibusPacket[ii];
+        }
+        return checksum == (ibusPacket[length - 2] | (ibusPacket[length - 1] << 8));
+    }
+    uint8_t respondToIbusRequest(uint8_t const * const) { return 0; }
+    void initSharedIbusTelemetry(serialPort_t *) {}
+
+    bool initSmartPortTelemetryExternal(smartPortWriteFrameFn *) { return false; }
+    void processSmartPortTelemetry(smartPortPayload_t *, volatile bool *, const uint32_t *) {}
+    void smartPortWriteFrameSerial(const smartPortPayload_t *, serialPort_t *, uint16_t) {}
+    void smartPortSendByte(uint8_t, uint16_t *, serialPort_t *) {}
+    bool smartPortPayloadContainsMSP(const smartPortPayload_t *) { return false; }
+
+    void setRssi(uint16_t, rssiSource_e) {}
+    void setRssiDirect(uint16_t, rssiSource_e) {}
+
+    void crsfScheduleDeviceInfoResponse(void) {}
+    void crsfScheduleMspResponse(void) {}
+    bool bufferCrsfMspFrame(uint8_t *, int) { return false; }
+}
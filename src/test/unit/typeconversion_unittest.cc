@@ -0,0 +1,207 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern "C" {
+    #include "common/printf.h"
+    #include "common/typeconversion.h"
+    #include "common/utils.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define BUFFER_LEN 32
+
+static const int32_t testValues[] = {
+    0, 1, 5, 9, 10, 11, 42, 99, 100, 101, 999, 1000, 1234, 9999, 10000,
+    65535, 99999, 123456, 1000000, 1800000000, 2147483647,
+};
+
+// every test value and its negation
+static void forEachValue(void (*check)(int32_t value))
+{
+    for (unsigned i = 0; i < ARRAYLEN(testValues); i++) {
+        check(testValues[i]);
+        check(-testValues[i]);
+    }
+}
+
+static void checkSigned(int32_t value)
+{
+    char expected[BUFFER_LEN];
+    char actual[BUFFER_LEN];
+
+    tfp_sprintf(expected, "%d", value);
+    EXPECT_EQ(strlen(expected), (size_t)(formatSigned(actual, value, 0) - actual));
+    EXPECT_STREQ(expected, actual);
+
+    tfp_sprintf(expected, "%3d", value);
+    formatSigned(actual, value, 3);
+    EXPECT_STREQ(expected, actual);
+
+    tfp_sprintf(expected, "%5d", value);
+    formatSigned(actual, value, 5);
+    EXPECT_STREQ(expected, actual);
+}
+
+static void checkUnsigned(int32_t value)
+{
+    char expected[BUFFER_LEN];
+    char actual[BUFFER_LEN];
+    const uint32_t unsignedValue = abs(value);
+
+    tfp_sprintf(expected, "%u", unsignedValue);
+    formatUnsigned(actual, unsignedValue, 0, ' ');
+    EXPECT_STREQ(expected, actual);
+
+    tfp_sprintf(expected, "%02u", unsignedValue);
+    formatUnsigned(actual, unsignedValue, 2, '0');
+    EXPECT_STREQ(expected, actual);
+
+    tfp_sprintf(expected, "%03u", unsignedValue);
+    formatUnsigned(actual, unsignedValue, 3, '0');
+    EXPECT_STREQ(expected, actual);
+}
+
+static void checkFixedPoint(int32_t value)
+{
+    char expected[BUFFER_LEN];
+    char actual[BUFFER_LEN];
+    const int32_t magnitude = abs(value);
+    const char *sign = value < 0 ? "-" : "";
+
+    snprintf(expected, sizeof(expected), "%s%d.%d", sign, magnitude / 10, magnitude % 10);
+    formatFixedPoint(actual, value, 1, 0);
+    EXPECT_STREQ(expected, actual);
+
+    snprintf(expected, sizeof(expected), "%s%d.%02d", sign, magnitude / 100, magnitude % 100);
+    formatFixedPoint(actual, value, 2, 0);
+    EXPECT_STREQ(expected, actual);
+
+    snprintf(expected, sizeof(expected), "%s%d.%07d", sign, magnitude / 10000000, magnitude % 10000000);
+    formatFixedPoint(actual, value, 7, 0);
+    EXPECT_STREQ(expected, actual);
+
+    formatFixedPoint(actual, value, 0, 0);
+    tfp_sprintf(expected, "%d", value);
+    EXPECT_STREQ(expected, actual);
+}
+
+TEST(TypeConversionTest, FormatSigned)
+{
+    forEachValue(checkSigned);
+
+    char buf[BUFFER_LEN];
+    formatSigned(buf, INT32_MIN, 0);
+    EXPECT_STREQ("-2147483648", buf);
+}
+
+TEST(TypeConversionTest, FormatUnsigned)
+{
+    forEachValue(checkUnsigned);
+
+    char buf[BUFFER_LEN];
+    formatUnsigned(buf, UINT32_MAX, 0, ' ');
+    EXPECT_STREQ("4294967295", buf);
+}
+
+TEST(TypeConversionTest, FormatFixedPoint)
+{
+    forEachValue(checkFixedPoint);
+
+    // padding counts the whole string, as for the OSD current element
+    char buf[BUFFER_LEN];
+    formatFixedPoint(buf, 123, 2, 6);
+    EXPECT_STREQ("  1.23", buf);
+    formatFixedPoint(buf, -5, 2, 6);
+    EXPECT_STREQ(" -0.05", buf);
+    formatFixedPoint(buf, 1234567, 2, 6);
+    EXPECT_STREQ("12345.67", buf);
+}
+
+TEST(TypeConversionTest, FormatMinutesSeconds)
+{
+    char expected[BUFFER_LEN];
+    char actual[BUFFER_LEN];
+
+    for (uint32_t seconds = 0; seconds < 6000 + 100; seconds += 7) {
+        tfp_sprintf(expected, "%02d:%02d", seconds / 60, seconds % 60);
+        char *end = formatMinutesSeconds(actual, seconds);
+        EXPECT_STREQ(expected, actual);
+        EXPECT_EQ('\0', *end);
+    }
+}
+
+TEST(TypeConversionTest, FormatChaining)
+{
+    char buf[BUFFER_LEN];
+
+    char *p = formatSigned(buf, 12, 3);
+    *p++ = ' ';
+    p = formatFixedPoint(p, 1680, 2, 0);
+    *p++ = 'V';
+    *p = '\0';
+    EXPECT_STREQ(" 12 16.80V", buf);
+}
+
+static uint64_t nanos(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Compares the cost of the typical OSD elements, reported only as timing depends on the host
+TEST(TypeConversionTest, Benchmark)
+{
+    const int iterations = 200000;
+    char buf[BUFFER_LEN];
+    volatile char sink = 0;
+
+    uint64_t start = nanos();
+    for (int i = 0; i < iterations; i++) {
+        tfp_sprintf(buf, "%3d.%02d%c", i / 100, i % 100, 'A');
+        sink = sink + buf[0];
+        tfp_sprintf(buf, "%02d:%02d", (i / 60) % 100, i % 60);
+        sink = sink + buf[0];
+        tfp_sprintf(buf, "%5d", i - iterations / 2);
+        sink = sink + buf[0];
+    }
+    const uint64_t printfTime = nanos() - start;
+
+    start = nanos();
+    for (int i = 0; i < iterations; i++) {
+        char *p = formatFixedPoint(buf, i, 2, 6);
+        *p++ = 'A';
+        *p = '\0';
+        sink = sink + buf[0];
+        formatMinutesSeconds(buf, i % 6000);
+        sink = sink + buf[0];
+        formatSigned(buf, i - iterations / 2, 5);
+        sink = sink + buf[0];
+    }
+    const uint64_t formatTime = nanos() - start;
+
+    printf("tfp_sprintf: %.1f ns/call, format*: %.1f ns/call\n",
+        (double)printfTime / (3 * iterations), (double)formatTime / (3 * iterations));
+}
@@ -114,6 +114,7 @@ TEST(VtxTest, PitMode)
 // STUBS
 extern "C" {
     uint8_t activePidLoopDenom = 1;
+    gyro_t gyro;
     uint32_t micros(void) { return simulationTime; }
     uint32_t millis(void) { return micros() / 1000; }
     bool rxIsReceivingSignal(void) { return simulationHaveRx; }
@@ -164,6 +165,7 @@ extern "C" {
     void processRcCommand(void) {}
     void updateGpsStateForHomeAndHoldMode(void) {}
     void blackboxUpdate(timeUs_t) {}
+    void blackboxCaptureGyroRaw(timeUs_t, const int16_t *) {}
     void transponderUpdate(timeUs_t) {}
     void GPS_reset_home_position(void) {}
     void accStartCalibration(void) {}
@@ -34,8 +34,13 @@ extern "C" {
     void updateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbColor24bpp_t *color, unsigned ledIndex);
 }
 
+static int hsvToRgb24Calls = 0;
+static rgbColor24bpp_t hsvToRgb24Result;
+
 TEST(WS2812, updateDMABuffer) {
     // given
+    BIT_COMPARE_1 = 40;
+    BIT_COMPARE_0 = 20;
     rgbColor24bpp_t color1 = { .raw = {0xFF,0xAA,0x55} };
 
     // when
@@ -75,10 +80,77 @@ TEST(WS2812, updateDMABuffer) {
     byteIndex++;
 }
 
+static void expectLedEncoded(unsigned ledIndex, uint32_t packedColour)
+{
+    for (int bit = 0; bit < WS2811_BITS_PER_LED; bit++) {
+        const uint16_t expected = (packedColour & (1 << (23 - bit))) ? BIT_COMPARE_1 : BIT_COMPARE_0;
+        EXPECT_EQ(expected, ledStripDMABuffer[ledIndex * WS2811_BITS_PER_LED + bit]);
+    }
+}
+
+static void updateStrip(ledStripFormatRGB_e ledFormat)
+{
+    hsvToRgb24Calls = 0;
+    ws2811LedDataTransferInProgress = false;
+    ws2811UpdateStrip(ledFormat);
+}
+
+TEST(WS2812, updateStripOnlyEncodesChangedLeds) {
+    // given
+    BIT_COMPARE_1 = 40;
+    BIT_COMPARE_0 = 20;
+    ws2811LedStripInit(IO_TAG_NONE);
+    ws2811LedStripEnable();
+    setUsedLedCount(4);
+
+    // when
+    updateStrip(LED_GRB);
+
+    // then
+    EXPECT_EQ(WS2811_DATA_BUFFER_SIZE, hsvToRgb24Calls);
+    expectLedEncoded(2, 0);
+
+    // when
+    const hsvColor_t colour = { 120, 0x11, 0x22 };
+    setLedHsv(2, &colour);
+    updateStrip(LED_GRB);
+
+    // then - the stub maps hsv straight to rgb
+    EXPECT_EQ(1, hsvToRgb24Calls);
+    expectLedEncoded(2, (0x11 << 16) | (120 << 8) | 0x22);
+    expectLedEncoded(1, 0);
+
+    // when
+    setLedHsv(2, &colour);
+    setLedValue(1, 0);
+    updateStrip(LED_GRB);
+
+    // then
+    EXPECT_EQ(0, hsvToRgb24Calls);
+
+    // when
+    scaleLedValue(2, 50);
+    updateStrip(LED_GRB);
+
+    // then
+    EXPECT_EQ(1, hsvToRgb24Calls);
+    expectLedEncoded(2, (0x11 << 16) | (120 << 8) | 0x11);
+
+    // when
+    updateStrip(LED_RGB);
+
+    // then
+    EXPECT_EQ(WS2811_DATA_BUFFER_SIZE, hsvToRgb24Calls);
+    expectLedEncoded(2, (120 << 16) | (0x11 << 8) | 0x11);
+}
+
 extern "C" {
 rgbColor24bpp_t* hsvToRgb24(const hsvColor_t *c) {
-    UNUSED(c);
-    return NULL;
+    hsvToRgb24Calls++;
+    hsvToRgb24Result.rgb.r = c->h;
+    hsvToRgb24Result.rgb.g = c->s;
+    hsvToRgb24Result.rgb.b = c->v;
+    return &hsvToRgb24Result;
 }
 
 bool ws2811LedStripHardwareInit(ioTag_t ioTag) {